@@ -0,0 +1,1305 @@
+﻿#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <functional>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "ClosestPair.h"
+#include "ConvexHull.h"
+#include "ConvexHull3D.h"
+#include "ConvexPolygon.h"
+#include "Earcut.h"
+#include "EnclosingCircle.h"
+#include "Generators.h"
+#include "Hilbert.h"
+#include "Instrumentation.h"
+#include "MonotoneTriangulation.h"
+#include "Overlay.h"
+#include "PointLocation.h"
+#include "RotatingCalipers.h"
+#include "Rotation.h"
+#include "Simplify.h"
+#include "TrapezoidalMap.h"
+#include "Voronoi.h"
+
+#if defined(__APPLE__)
+#include <malloc/malloc.h>
+#elif defined(__FreeBSD__)
+#include <malloc_np.h>
+#elif defined(__linux__) || defined(_MSC_VER)
+#include <malloc.h>
+#endif
+
+using geometry::Point;
+using geometry::PointDistribution;
+
+#ifdef GEOMETRY_INSTRUMENTATION
+
+// The instrumentation counts the allocations already
+using geometry::instrumentation::Counter;
+
+int64_t GetAllocationCount()
+{
+    return geometry::instrumentation::counters[int(Counter::Allocations)];
+}
+
+int64_t GetAllocatedBytes()
+{
+    return geometry::instrumentation::counters[int(Counter::AllocatedBytes)];
+}
+
+// The instrumentation does not know what is freed, peak bytes stay 0
+void ResetPeakBytes()
+{
+}
+
+int64_t GetLiveBytes()
+{
+    return 0;
+}
+
+int64_t GetPeakBytes()
+{
+    return 0;
+}
+
+#else
+
+// Every allocation of the process goes through here, from the workers of the /threads
+// benchmarks too, so the counters are atomic. Relaxed: they are only read between runs.
+static std::atomic<int64_t> allocationCount{ 0 };
+static std::atomic<int64_t> allocatedBytes{ 0 };
+// What the allocator handed out and has not got back, and the most of it since the last reset
+static std::atomic<int64_t> liveBytes{ 0 };
+static std::atomic<int64_t> peakBytes{ 0 };
+
+// Where the allocator cannot tell the size of a block, live and peak bytes stay 0
+size_t GetAllocationSize(void* p)
+{
+#if defined(_MSC_VER)
+    return _msize(p);
+#elif defined(__APPLE__)
+    return malloc_size(p);
+#elif defined(__linux__) || defined(__FreeBSD__)
+    return malloc_usable_size(p);
+#else
+    (void)p;
+    return 0;
+#endif
+}
+
+int64_t GetAllocationCount()
+{
+    return allocationCount.load(std::memory_order_relaxed);
+}
+
+int64_t GetAllocatedBytes()
+{
+    return allocatedBytes.load(std::memory_order_relaxed);
+}
+
+void ResetPeakBytes()
+{
+    peakBytes.store(liveBytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+int64_t GetLiveBytes()
+{
+    return liveBytes.load(std::memory_order_relaxed);
+}
+
+int64_t GetPeakBytes()
+{
+    return peakBytes.load(std::memory_order_relaxed);
+}
+
+void* operator new(size_t size)
+{
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    allocatedBytes.fetch_add(int64_t(size), std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1))
+    {
+        int64_t bytes = int64_t(GetAllocationSize(p));
+        int64_t live = liveBytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+        int64_t peak = peakBytes.load(std::memory_order_relaxed);
+        while (live > peak && !peakBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed))
+        {
+        }
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void* p) noexcept
+{
+    if (p)
+    {
+        liveBytes.fetch_sub(int64_t(GetAllocationSize(p)), std::memory_order_relaxed);
+    }
+    std::free(p);
+}
+
+void operator delete[](void* p) noexcept
+{
+    operator delete(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+    operator delete(p);
+}
+
+void operator delete[](void* p, size_t) noexcept
+{
+    operator delete(p);
+}
+
+#endif
+
+// Keeps the optimizer from dropping results nobody reads
+static volatile double sink;
+
+void Consume(double value)
+{
+    sink = value;
+}
+
+// Runs the measured work the given number of times
+typedef std::function<void(int64_t)> Body;
+
+struct Benchmark
+{
+    std::string name;
+    // Largest n the algorithm finishes in reasonable time, the quadratic ones stop early
+    int64_t maxN;
+    // Points processed per iteration, 0 for n
+    int64_t itemsPerIteration;
+    // Builds the input for n outside of the measurement
+    std::function<Body(int64_t)> setup;
+};
+
+struct Result
+{
+    std::string name;
+    int64_t n;
+    int64_t iterations;
+    double seconds;
+    double nsPerPoint;
+    double pointsPerSecond;
+    double allocationsPerIteration;
+    double bytesPerIteration;
+    // Most bytes allocated at once above what was live before the run
+    int64_t peakBytes;
+};
+
+const int QueryCount = 1024;
+const uint64_t Seed = 42;
+
+std::vector<Point> GetQueries()
+{
+    return geometry::GetRandomPoints(PointDistribution::Uniform, QueryCount, Seed + 1);
+}
+
+void AddHullBenchmarks(std::vector<Benchmark>& benchmarks)
+{
+    typedef std::vector<Point> (*Hull)(const std::vector<Point>&);
+    struct
+    {
+        const char* name;
+        Hull hull;
+    } hulls[] = {
+        { "Jarvis", geometry::GiftWrap_Jarvis },
+        { "Graham", geometry::GrahamScan_Graham },
+        { "Andrew", geometry::MonotoneChain_Andrews },
+    };
+    PointDistribution distributions[] = {
+        PointDistribution::Uniform, PointDistribution::Disk, PointDistribution::Circle, PointDistribution::Gaussian, PointDistribution::Clustered,
+    };
+
+    for (auto& hull : hulls)
+    {
+        for (PointDistribution distribution : distributions)
+        {
+            // Gift wrapping is O(nh), every point is on the hull of the circle
+            int64_t maxN = hull.hull != geometry::GiftWrap_Jarvis ? int64_t(1e8) : distribution == PointDistribution::Circle ? int64_t(1e4) : int64_t(1e7);
+            Hull run = hull.hull;
+            benchmarks.push_back({ std::string(hull.name) + "/" + geometry::ToString(distribution), maxN, 0, [=](int64_t n)
+            {
+                std::vector<Point> points = geometry::GetRandomPoints(distribution, int(n), Seed);
+                return Body([=](int64_t iterations)
+                {
+                    for (int64_t i = 0; i < iterations; i++)
+                    {
+                        Consume(double(run(points).size()));
+                    }
+                });
+            } });
+        }
+    }
+}
+
+void AddEarcutBenchmarks(std::vector<Benchmark>& benchmarks)
+{
+    typedef std::vector<Point> (*Polygon)(int, uint64_t);
+    struct
+    {
+        const char* name;
+        Polygon polygon;
+    } polygons[] = {
+        { "convex", geometry::GetConvexPolygon },
+        { "star", geometry::GetStarPolygon },
+        { "comb", geometry::GetCombPolygon },
+    };
+
+    for (auto& polygon : polygons)
+    {
+        Polygon make = polygon.polygon;
+        // Every ear test scans the polygon
+        benchmarks.push_back({ std::string("Earcut/") + polygon.name, int64_t(1e4), 0, [=](int64_t n)
+        {
+            std::vector<Point> vertices = make(int(n), Seed);
+            return Body([=](int64_t iterations)
+            {
+                for (int64_t i = 0; i < iterations; i++)
+                {
+                    Consume(double(geometry::Earcut(vertices).size()));
+                }
+            });
+        } });
+    }
+
+    // The same polygons cut into monotone pieces first, O(n log n)
+    for (auto& polygon : polygons)
+    {
+        Polygon make = polygon.polygon;
+        benchmarks.push_back({ std::string("MonotoneTriangulation/") + polygon.name, int64_t(1e6), 0, [=](int64_t n)
+        {
+            std::vector<Point> vertices = make(int(n), Seed);
+            return Body([=](int64_t iterations)
+            {
+                for (int64_t i = 0; i < iterations; i++)
+                {
+                    Consume(double(geometry::MonotoneTriangulation(vertices).size()));
+                }
+            });
+        } });
+    }
+}
+
+// Outlines with 90% near-collinear vertices, n in total: Earcut alone against simplified first.
+// The base is convex, the random radii of a star leave less room between its spikes than
+// the noise takes once n is large.
+void AddSimplifyBenchmarks(std::vector<Benchmark>& benchmarks)
+{
+    const int Factor = 10;
+    const double Noise = 1e-3;
+    auto getPolygon = [=](int64_t n, double& tolerance)
+    {
+        std::vector<Point> outline = geometry::GetConvexPolygon(int(std::max<int64_t>(3, n / Factor)), Seed);
+        double longest = 0.0;
+        for (int i = 0; i < outline.size(); i++)
+        {
+            Point edge = outline[(i + 1) % outline.size()] - outline[i];
+            longest = std::max(longest, std::sqrt(edge * edge));
+        }
+        // Above the noise, below the corners of the outline
+        tolerance = 2.0 * Noise * longest;
+        return geometry::GetOversampledPolygon(outline, Factor, Noise, Seed + 2);
+    };
+
+    benchmarks.push_back({ "Simplify/oversampled", int64_t(1e7), 0, [=](int64_t n)
+    {
+        double tolerance;
+        std::vector<Point> polygon = getPolygon(n, tolerance);
+        return Body([=](int64_t iterations)
+        {
+            for (int64_t i = 0; i < iterations; i++)
+            {
+                Consume(double(geometry::Simplify_Visvalingam(polygon, tolerance).size()));
+            }
+        });
+    } });
+    benchmarks.push_back({ "Earcut/oversampled", int64_t(1e4), 0, [=](int64_t n)
+    {
+        double tolerance;
+        std::vector<Point> polygon = getPolygon(n, tolerance);
+        return Body([=](int64_t iterations)
+        {
+            for (int64_t i = 0; i < iterations; i++)
+            {
+                Consume(double(geometry::Earcut(polygon).size()));
+            }
+        });
+    } });
+    benchmarks.push_back({ "SimplifyEarcut/oversampled", int64_t(1e5), 0, [=](int64_t n)
+    {
+        double tolerance;
+        std::vector<Point> polygon = getPolygon(n, tolerance);
+        return Body([=](int64_t iterations)
+        {
+            for (int64_t i = 0; i < iterations; i++)
+            {
+                Consume(double(geometry::Earcut(geometry::Simplify_Visvalingam(polygon, tolerance)).size()));
+            }
+        });
+    } });
+}
+
+// n is the vertex count of each polygon. Whole operations are per vertex, the logarithmic
+// ones per query.
+void AddConvexBenchmarks(std::vector<Benchmark>& benchmarks)
+{
+    auto getPolygons = [](int64_t n, std::vector<Point>& a, std::vector<Point>& b)
+    {
+        a = geometry::GetConvexPolygon(int(n), Seed);
+        b = geometry::GetConvexPolygon(int(n), Seed + 3);
+        for (Point& p : b)
+        {
+            p += Point(0.5, 0.25);
+        }
+    };
+
+    benchmarks.push_back({ "Convex/intersect", int64_t(1e7), 0, [=](int64_t n)
+    {
+        std::vector<Point> a;
+        std::vector<Point> b;
+        getPolygons(n, a, b);
+        return Body([=](int64_t iterations)
+        {
+            for (int64_t i = 0; i < iterations; i++)
+            {
+                Consume(double(geometry::IntersectConvex(a, b).size()));
+            }
+        });
+    } });
+    benchmarks.push_back({ "Convex/minkowski", int64_t(1e7), 0, [=](int64_t n)
+    {
+        std::vector<Point> a;
+        std::vector<Point> b;
+        getPolygons(n, a, b);
+        return Body([=](int64_t iterations)
+        {
+            for (int64_t i = 0; i < iterations; i++)
+            {
+                Consume(double(geometry::GetMinkowskiSum(a, b).size()));
+            }
+        });
+    } });
+    benchmarks.push_back({ "Convex/extreme", int64_t(1e8), QueryCount, [=](int64_t n)
+    {
+        std::vector<Point> polygon = geometry::GetConvexPolygon(int(n), Seed);
+        std::vector<Point> directions = GetQueries();
+        return Body([=](int64_t iterations)
+        {
+            for (int64_t i = 0; i < iterations; i++)
+            {
+                int64_t total = 0;
+                for (Point direction : directions)
+                {
+                    total += geometry::GetExtremeVertex(polygon, direction);
+                }
+                Consume(double(total));
+            }
+        });
+    } });
+    benchmarks.push_back({ "Convex/tangents", int64_t(1e8), QueryCount, [=](int64_t n)
+    {
+        std::vector<Point> polygon = geometry::GetConvexPolygon(int(n), Seed);
+        // Mostly outside the unit circle
+        std::vector<Point> queries = GetQueries();
+        for (Point& P : queries)
+        {
+            P *= 3.0;
+        }
+        return Body([=](int64_t iterations)
+        {
+            for (int64_t i = 0; i < iterations; i++)
+            {
+                int64_t total = 0;
+                for (Point P : queries)
+                {
+                    int first;
+                    int second;
+                    if (geometry::GetTangents(polygon, P, first, second))
+                    {
+                        total += first + second;
+                    }
+                }
+                Consume(double(total));
+            }
+        });
+    } });
+}
+
+// n is the hull vertex count, against the quadratic scan over all edges and pairs. The batch
+// splits the n vertices into clusters of ClusterSize.
+void AddCalipersBenchmarks(std::vector<Benchmark>& benchmarks)
+{
+    benchmarks.push_back({ "Calipers/measures", int64_t(1e7), 0, [](int64_t n)
+    {
+        std::vector<Point> hull = geometry::GetConvexPolygon(int(n), Seed);
+        return Body([=](int64_t iterations)
+        {
+            for (int64_t i = 0; i < iterations; i++)
+            {
+                geometry::HullMeasures measures = geometry::GetHullMeasures(hull);
+                Consume(measures.diameter + measures.width + measures.minAreaBox.area + measures.minPerimeterBox.perimeter);
+            }
+        });
+    } });
+    benchmarks.push_back({ "Calipers/quadratic", int64_t(1e4), 0, [](int64_t n)
+    {
+        std::vector<Point> hull = geometry::GetConvexPolygon(int(n), Seed);
+        return Body([=](int64_t iterations)
+        {
+            for (int64_t i = 0; i < iterations; i++)
+            {
+                double diameter2 = 0.0;
+                double area = HUGE_VAL;
+                for (int e = 0; e < hull.size(); e++)
+                {
+                    Point u = hull[(e + 1) % hull.size()] - hull[e];
+                    u = u / vecta::len(u);
+                    double left = HUGE_VAL;
+                    double right = -HUGE_VAL;
+                    double height = 0.0;
+                    for (Point p : hull)
+                    {
+                        Point d = p - hull[e];
+                        left = std::min(left, u * d);
+                        right = std::max(right, u * d);
+                        height = std::max(height, u ^ d);
+                        diameter2 = std::max(diameter2, d * d);
+                    }
+                    area = std::min(area, (right - left) * height);
+                }
+                Consume(diameter2 + area);
+            }
+        });
+    } });
+
+    const int ClusterSize = 32;
+    benchmarks.push_back({ "Calipers/batch", int64_t(1e7), 0, [=](int64_t n)
+    {
+        std::vector<Point> hulls;
+        std::vector<int> offsets = { 0 };
+        for (int64_t cluster = 0; cluster * ClusterSize < n; cluster++)
+        {
+            std::vector<Point> hull = geometry::GetConvexPolygon(ClusterSize, Seed + cluster);
+            hulls.insert(hulls.end(), hull.begin(), hull.end());
+            offsets.push_back(int(hulls.size()));
+        }
+        return Body([=](int64_t iterations)
+        {
+            std::vector<geometry::HullMeasures> measures;
+            for (int64_t i = 0; i < iterations; i++)
+            {
+                geometry::GetHullMeasures(hulls, offsets, measures);
+                Consume(measures.back().diameter);
+            }
+        });
+    } });
+}
+
+// n is the edge count of both inputs together
+void AddOverlayBenchmarks(std::vector<Benchmark>& benchmarks)
+{
+    // Two stars around the same centre cross about once per spike
+    benchmarks.push_back({ "Overlay/stars", int64_t(1e6), 0, [](int64_t n)
+    {
+        std::vector<std::vector<Point>> subject = { geometry::GetStarPolygon(int(std::max<int64_t>(3, n / 2)), Seed) };
+        std::vector<std::vector<Point>> clipping = { geometry::GetStarPolygon(int(std::max<int64_t>(3, n / 2)), Seed + 1) };
+        return Body([=](int64_t iterations)
+        {
+            for (int64_t i = 0; i < iterations; i++)
+            {
+                Consume(double(geometry::Overlay(subject, clipping, geometry::BooleanOperation::Union).size()));
+            }
+        });
+    } });
+    // A comb against itself moved half a tooth: long shared runs of parallel edges
+    benchmarks.push_back({ "Overlay/combs", int64_t(1e6), 0, [](int64_t n)
+    {
+        std::vector<Point> comb = geometry::GetCombPolygon(int(std::max<int64_t>(4, n / 2)), Seed);
+        std::vector<Point> shifted = comb;
+        for (Point& p : shifted)
+        {
+            // The vertices are about 2 / n apart in x
+            p += Point(2.0 / double(comb.size()), 0.0);
+        }
+        std::vector<std::vector<Point>> subject = { comb };
+        std::vector<std::vector<Point>> clipping = { shifted };
+        return Body([=](int64_t iterations)
+        {
+            for (int64_t i = 0; i < iterations; i++)
+            {
+                Consume(double(geometry::Overlay(subject, clipping, geometry::BooleanOperation::Intersection).size()));
+            }
+        });
+    } });
+}
+
+// n is the vertex count, the time is per query point
+void AddPointLocationBenchmarks(std::vector<Benchmark>& benchmarks)
+{
+    typedef geometry::PointLocation (*Locate)(const std::vector<Point>&, Point);
+    auto add = [&](const std::string& name, int64_t maxN, std::vector<Point> (*polygon)(int, uint64_t), Locate locate)
+    {
+        benchmarks.push_back({ name, maxN, QueryCount, [=](int64_t n)
+        {
+            std::vector<Point> vertices = polygon(int(n), Seed);
+            std::vector<Point> queries = GetQueries();
+            return Body([=](int64_t iterations)
+            {
+                for (int64_t i = 0; i < iterations; i++)
+                {
+                    int inside = 0;
+                    for (Point P : queries)
+                    {
+                        inside += locate(vertices, P) == geometry::PointLocation::Inside;
+                    }
+                    Consume(inside);
+                }
+            });
+        } });
+    };
+
+    Locate rayCast = geometry::GetPointLocation;
+    add("Linear/convex", int64_t(1e6), geometry::GetConvexPolygon, geometry::GetPointLocationLinear);
+    add("Binary/convex", int64_t(1e8), geometry::GetConvexPolygon, geometry::GetPointLocationBinary);
+    add("RayCast/convex", int64_t(1e6), geometry::GetConvexPolygon, rayCast);
+    add("RayCast/star", int64_t(1e6), geometry::GetStarPolygon, rayCast);
+    add("RayCast/comb", int64_t(1e6), geometry::GetCombPolygon, rayCast);
+
+    // The same polygons by winding number, and n vertices over four rings of a multipolygon
+    auto winding = [](const std::vector<Point>& polygon, Point P) { return geometry::GetPointLocation(polygon, P, geometry::FillRule::NonZero); };
+    add("Winding/convex", int64_t(1e6), geometry::GetConvexPolygon, winding);
+    add("Winding/star", int64_t(1e6), geometry::GetStarPolygon, winding);
+    add("Winding/comb", int64_t(1e6), geometry::GetCombPolygon, winding);
+
+    benchmarks.push_back({ "Winding/rings", int64_t(1e6), QueryCount, [=](int64_t n)
+    {
+        std::vector<Point> rings;
+        std::vector<int> offsets(1, 0);
+        for (int i = 0; i < 4; i++)
+        {
+            std::vector<Point> ring = geometry::GetStarPolygon(int(n / 4), Seed + i);
+            rings.insert(rings.end(), ring.begin(), ring.end());
+            offsets.push_back(int(rings.size()));
+        }
+        std::vector<Point> queries = GetQueries();
+        return Body([=](int64_t iterations)
+        {
+            for (int64_t i = 0; i < iterations; i++)
+            {
+                int inside = 0;
+                for (Point P : queries)
+                {
+                    inside += geometry::GetPointLocation(rings, offsets, P, geometry::FillRule::EvenOdd) == geometry::PointLocation::Inside;
+                }
+                Consume(inside);
+            }
+        });
+    } });
+
+    benchmarks.push_back({ "Monotone/comb", int64_t(1e6), QueryCount, [=](int64_t n)
+    {
+        std::vector<Point> upperChain;
+        std::vector<Point> lowerChain;
+        geometry::GetCombChains(geometry::GetCombPolygon(int(n), Seed), upperChain, lowerChain);
+        std::vector<Point> queries = GetQueries();
+        return Body([=](int64_t iterations)
+        {
+            for (int64_t i = 0; i < iterations; i++)
+            {
+                int inside = 0;
+                for (Point P : queries)
+                {
+                    inside += geometry::GetPointLocationMonotone(upperChain, lowerChain, P) == geometry::PointLocation::Inside;
+                }
+                Consume(inside);
+            }
+        });
+    } });
+
+    // A subdivision of n parcels, about 2n distinct edges: building the map per parcel, then
+    // queries one at a time and in batches on all threads
+    benchmarks.push_back({ "TrapezoidalMap/build", int64_t(5e5), 0, [=](int64_t n)
+    {
+        std::vector<std::vector<Point>> parcels = geometry::GetParcels(int(n), 0.2, Seed);
+        return Body([=](int64_t iterations)
+        {
+            for (int64_t i = 0; i < iterations; i++)
+            {
+                Consume(double(geometry::TrapezoidalMap(parcels).GetNodeCount()));
+            }
+        });
+    } });
+    benchmarks.push_back({ "TrapezoidalMap/parcels", int64_t(5e5), QueryCount, [=](int64_t n)
+    {
+        geometry::TrapezoidalMap map(geometry::GetParcels(int(n), 0.2, Seed));
+        std::vector<Point> queries = GetQueries();
+        return Body([=](int64_t iterations)
+        {
+            for (int64_t i = 0; i < iterations; i++)
+            {
+                int face = 0;
+                for (Point P : queries)
+                {
+                    face += map.GetLocation(P).face;
+                }
+                Consume(face);
+            }
+        });
+    } });
+    const int BatchSize = 1 << 16;
+    for (int threadCount : { 1, 0 })
+    {
+        benchmarks.push_back({ threadCount == 1 ? "TrapezoidalMap/batch" : "TrapezoidalMap/threads", int64_t(5e5), BatchSize, [=](int64_t n)
+        {
+            geometry::TrapezoidalMap map(geometry::GetParcels(int(n), 0.2, Seed));
+            std::vector<Point> queries = geometry::GetRandomPoints(PointDistribution::Uniform, BatchSize, Seed + 1);
+            return Body([=](int64_t iterations)
+            {
+                std::vector<geometry::FaceLocation> locations;
+                for (int64_t i = 0; i < iterations; i++)
+                {
+                    map.GetLocations(queries, locations, threadCount);
+                    Consume(locations.back().face);
+                }
+            });
+        } });
+    }
+
+    // The same batch one query at a time, in random order and already along each curve: what
+    // locality alone gains, GetLocations() pays for the ordering on top
+    for (const char* order : { "random", "hilbert", "morton" })
+    {
+        benchmarks.push_back({ std::string("TrapezoidalMap/") + order, int64_t(5e5), BatchSize, [=](int64_t n)
+        {
+            geometry::TrapezoidalMap map(geometry::GetParcels(int(n), 0.2, Seed));
+            std::vector<Point> queries = geometry::GetRandomPoints(PointDistribution::Uniform, BatchSize, Seed + 1);
+            if (order[0] != 'r')
+            {
+                std::vector<Point> ordered;
+                for (int i : geometry::GetSpatialOrder(queries, order[0] == 'h' ? geometry::SpatialCurve::Hilbert : geometry::SpatialCurve::Morton))
+                {
+                    ordered.push_back(queries[i]);
+                }
+                queries = ordered;
+            }
+            return Body([=](int64_t iterations)
+            {
+                for (int64_t i = 0; i < iterations; i++)
+                {
+                    int face = 0;
+                    for (Point P : queries)
+                    {
+                        face += map.GetLocation(P).face;
+                    }
+                    Consume(face);
+                }
+            });
+        } });
+    }
+}
+
+// Keys and radix sort along both curves, against the Hilbert keys under std::sort
+void AddSpatialOrderBenchmarks(std::vector<Benchmark>& benchmarks)
+{
+    for (geometry::SpatialCurve curve : { geometry::SpatialCurve::Hilbert, geometry::SpatialCurve::Morton })
+    {
+        benchmarks.push_back({ std::string("SpatialOrder/") + geometry::ToString(curve), int64_t(1e7), 0, [=](int64_t n)
+        {
+            std::vector<Point> points = geometry::GetRandomPoints(PointDistribution::Uniform, int(n), Seed);
+            return Body([=](int64_t iterations)
+            {
+                for (int64_t i = 0; i < iterations; i++)
+                {
+                    Consume(geometry::GetSpatialOrder(points, curve).back());
+                }
+            });
+        } });
+    }
+    benchmarks.push_back({ "SpatialOrder/std::sort", int64_t(1e7), 0, [=](int64_t n)
+    {
+        std::vector<Point> points = geometry::GetRandomPoints(PointDistribution::Uniform, int(n), Seed);
+        return Body([=](int64_t iterations)
+        {
+            for (int64_t i = 0; i < iterations; i++)
+            {
+                std::vector<std::pair<uint32_t, int>> keys(points.size());
+                for (int j = 0; j < points.size(); j++)
+                {
+                    keys[j] = { geometry::GetHilbertKey(points[j], Point(-1.0, -1.0), Point(1.0, 1.0)), j };
+                }
+                std::sort(keys.begin(), keys.end());
+                Consume(keys.back().second);
+            }
+        });
+    } });
+}
+
+// One call per point, over consecutive points of a uniform cloud
+void AddKernelBenchmarks(std::vector<Benchmark>& benchmarks)
+{
+    auto add = [&](const std::string& name, std::function<double(const std::vector<Point>&)> kernel)
+    {
+        benchmarks.push_back({ "vecta/" + name, int64_t(1e8), 0, [=](int64_t n)
+        {
+            std::vector<Point> points = geometry::GetRandomPoints(PointDistribution::Uniform, int(n), Seed);
+            return Body([=](int64_t iterations)
+            {
+                for (int64_t i = 0; i < iterations; i++)
+                {
+                    Consume(kernel(points));
+                }
+            });
+        } });
+    };
+
+    add("Cross", [](const std::vector<Point>& points)
+    {
+        double sum = 0.0;
+        for (int i = 1; i < points.size(); i++)
+        {
+            sum += points[i - 1] ^ points[i];
+        }
+        return sum;
+    });
+    add("Dot", [](const std::vector<Point>& points)
+    {
+        double sum = 0.0;
+        for (int i = 1; i < points.size(); i++)
+        {
+            sum += points[i - 1] * points[i];
+        }
+        return sum;
+    });
+    add("Length", [](const std::vector<Point>& points)
+    {
+        double sum = 0.0;
+        for (Point p : points)
+        {
+            sum += vecta::len(p);
+        }
+        return sum;
+    });
+    add("Rotate", [](const std::vector<Point>& points)
+    {
+        Point sum;
+        for (Point p : points)
+        {
+            sum += p & 0.5;
+        }
+        return sum.x + sum.y;
+    });
+    add("Orient2D", [](const std::vector<Point>& points)
+    {
+        double sum = 0.0;
+        for (int i = 2; i < points.size(); i++)
+        {
+            sum += geometry::Orient2D(points[i - 2], points[i - 1], points[i]);
+        }
+        return sum;
+    });
+    add("InCircle", [](const std::vector<Point>& points)
+    {
+        double sum = 0.0;
+        for (int i = 3; i < points.size(); i++)
+        {
+            sum += geometry::InCircle(points[i - 3], points[i - 2], points[i - 1], points[i]);
+        }
+        return sum;
+    });
+    add("QuaternionRotate", [](const std::vector<Point>& points)
+    {
+        vecta::quatrn q(0.5, vecta::vec3d<>(1.0, 2.0, 3.0));
+        vecta::vec3d<> sum;
+        for (Point p : points)
+        {
+            vecta::vec3d<> v(p.x, p.y, p.x - p.y);
+            v &= q;
+            sum += v;
+        }
+        return sum.x + sum.y + sum.z;
+    });
+}
+
+// One cloud turned by the same quaternion: the scalar operator per point against the
+// Sequential and on every thread; the sphere has every point on the hull
+void AddHull3DBenchmarks(std::vector<Benchmark>& benchmarks)
+{
+    for (PointDistribution distribution : { PointDistribution::Uniform, PointDistribution::Gaussian, PointDistribution::Circle })
+    {
+        for (int threadCount : { 1, 0 })
+        {
+            std::string name = std::string(threadCount == 1 ? "Quickhull3D/" : "Quickhull3D/threads/") + geometry::ToString(distribution);
+            benchmarks.push_back({ name, int64_t(1e7), 0, [=](int64_t n)
+            {
+                std::vector<geometry::Point3D> points = geometry::GetRandomPoints3D(distribution, int(n), Seed);
+                return Body([=](int64_t iterations)
+                {
+                    for (int64_t i = 0; i < iterations; i++)
+                    {
+                        Consume(double(geometry::Quickhull3D_Barber(points, threadCount).triangles.size()));
+                    }
+                });
+            } });
+        }
+    }
+}
+
+// Welzl on every point, then culled by the octagon first on one thread and on all of them,
+// and clusters of 32 points split over the threads
+void AddCircleBenchmarks(std::vector<Benchmark>& benchmarks)
+{
+    for (PointDistribution distribution : { PointDistribution::Uniform, PointDistribution::Gaussian, PointDistribution::Circle })
+    {
+        benchmarks.push_back({ std::string("Welzl/") + geometry::ToString(distribution), int64_t(1e7), 0, [=](int64_t n)
+        {
+            std::vector<Point> points = geometry::GetRandomPoints(distribution, int(n), Seed);
+            return Body([=](int64_t iterations)
+            {
+                for (int64_t i = 0; i < iterations; i++)
+                {
+                    Consume(geometry::Welzl(points).radius);
+                }
+            });
+        } });
+        for (int threadCount : { 1, 0 })
+        {
+            std::string name = std::string(threadCount == 1 ? "EnclosingCircle/" : "EnclosingCircle/threads/") + geometry::ToString(distribution);
+            benchmarks.push_back({ name, int64_t(1e7), 0, [=](int64_t n)
+            {
+                std::vector<Point> points = geometry::GetRandomPoints(distribution, int(n), Seed);
+                return Body([=](int64_t iterations)
+                {
+                    for (int64_t i = 0; i < iterations; i++)
+                    {
+                        Consume(geometry::GetMinimumEnclosingCircle(points, threadCount).radius);
+                    }
+                });
+            } });
+        }
+    }
+
+    const int ClusterSize = 32;
+    benchmarks.push_back({ "EnclosingCircle/batch", int64_t(1e7), 0, [=](int64_t n)
+    {
+        std::vector<Point> points;
+        std::vector<int> offsets = { 0 };
+        for (int64_t cluster = 0; cluster * ClusterSize < n; cluster++)
+        {
+            std::vector<Point> clusterPoints = geometry::GetRandomPoints(PointDistribution::Gaussian, ClusterSize, Seed + cluster);
+            points.insert(points.end(), clusterPoints.begin(), clusterPoints.end());
+            offsets.push_back(int(points.size()));
+        }
+        return Body([=](int64_t iterations)
+        {
+            std::vector<geometry::Circle> circles;
+            for (int64_t i = 0; i < iterations; i++)
+            {
+                geometry::GetMinimumEnclosingCircles(points, offsets, circles);
+                Consume(circles.back().radius);
+            }
+        });
+    } });
+}
+
+// Sites per second and the peak bytes of one diagram; on the grid every four neighbours are
+// cocircular
+void AddVoronoiBenchmarks(std::vector<Benchmark>& benchmarks)
+{
+    for (PointDistribution distribution : { PointDistribution::Uniform, PointDistribution::Gaussian, PointDistribution::Clustered })
+    {
+        benchmarks.push_back({ std::string("Voronoi/") + geometry::ToString(distribution), int64_t(1e7), 0, [=](int64_t n)
+        {
+            std::vector<Point> sites = geometry::GetRandomPoints(distribution, int(n), Seed);
+            return Body([=](int64_t iterations)
+            {
+                for (int64_t i = 0; i < iterations; i++)
+                {
+                    Consume(double(geometry::FortuneVoronoi(sites).origins.size()));
+                }
+            });
+        } });
+    }
+
+    benchmarks.push_back({ "Voronoi/grid", int64_t(1e7), 0, [=](int64_t n)
+    {
+        int side = std::max(1, int(std::sqrt(double(n))));
+        std::vector<Point> sites;
+        for (int64_t i = 0; i < n; i++)
+        {
+            sites.push_back(Point(double(i % side), double(i / side)));
+        }
+        return Body([=](int64_t iterations)
+        {
+            for (int64_t i = 0; i < iterations; i++)
+            {
+                Consume(double(geometry::FortuneVoronoi(sites).origins.size()));
+            }
+        });
+    } });
+}
+
+// The stages after SortByXThenByY() on points sorted once, then the whole pipeline of one
+// sort, the hull, the near duplicates and the closest pair
+void AddClosestPairBenchmarks(std::vector<Benchmark>& benchmarks)
+{
+    for (PointDistribution distribution : { PointDistribution::Uniform, PointDistribution::Clustered })
+    {
+        std::string suffix = std::string("/") + geometry::ToString(distribution);
+        benchmarks.push_back({ "ClosestPair/sweep" + suffix, int64_t(1e8), 0, [=](int64_t n)
+        {
+            geometry::SortedPoints sorted = geometry::SortByXThenByY(geometry::GetRandomPoints(distribution, int(n), Seed));
+            return Body([=](int64_t iterations)
+            {
+                for (int64_t i = 0; i < iterations; i++)
+                {
+                    Consume(geometry::ClosestPair_Sweep(sorted).distance);
+                }
+            });
+        } });
+        for (int threadCount : { 1, 0 })
+        {
+            std::string name = std::string(threadCount == 1 ? "ClosestPair/divide" : "ClosestPair/divide/threads") + suffix;
+            benchmarks.push_back({ name, int64_t(1e8), 0, [=](int64_t n)
+            {
+                geometry::SortedPoints sorted = geometry::SortByXThenByY(geometry::GetRandomPoints(distribution, int(n), Seed));
+                return Body([=](int64_t iterations)
+                {
+                    for (int64_t i = 0; i < iterations; i++)
+                    {
+                        Consume(geometry::ClosestPair_DivideAndConquer(sorted, threadCount).distance);
+                    }
+                });
+            } });
+        }
+        benchmarks.push_back({ "NearDuplicates" + suffix, int64_t(1e8), 0, [=](int64_t n)
+        {
+            geometry::SortedPoints sorted = geometry::SortByXThenByY(geometry::GetRandomPoints(distribution, int(n), Seed));
+            double epsilon = 1.0 / double(n);
+            return Body([=](int64_t iterations)
+            {
+                for (int64_t i = 0; i < iterations; i++)
+                {
+                    Consume(geometry::GetNearDuplicates(sorted, epsilon).back());
+                }
+            });
+        } });
+        benchmarks.push_back({ "NearestNeighbours" + suffix, int64_t(1e7), 0, [=](int64_t n)
+        {
+            geometry::SortedPoints sorted = geometry::SortByXThenByY(geometry::GetRandomPoints(distribution, int(n), Seed));
+            return Body([=](int64_t iterations)
+            {
+                for (int64_t i = 0; i < iterations; i++)
+                {
+                    Consume(geometry::GetAllNearestNeighbours(sorted).back());
+                }
+            });
+        } });
+        benchmarks.push_back({ "Pipeline" + suffix, int64_t(1e8), 0, [=](int64_t n)
+        {
+            std::vector<Point> points = geometry::GetRandomPoints(distribution, int(n), Seed);
+            double epsilon = 1.0 / double(n);
+            return Body([=](int64_t iterations)
+            {
+                for (int64_t i = 0; i < iterations; i++)
+                {
+                    geometry::SortedPoints sorted = geometry::SortByXThenByY(points);
+                    Consume(double(geometry::MonotoneChain_Andrews(sorted).size()));
+                    Consume(geometry::GetNearDuplicates(sorted, epsilon).back());
+                    Consume(geometry::ClosestPair_DivideAndConquer(sorted).distance);
+                }
+            });
+        } });
+    }
+}
+
+// matrix built once over coordinate arrays, on one thread and on all of them
+void AddRotationBenchmarks(std::vector<Benchmark>& benchmarks)
+{
+    auto getCloud = [](int64_t n)
+    {
+        vecta::vec3d_array<> cloud;
+        for (Point p : geometry::GetRandomPoints(PointDistribution::Uniform, int(n), Seed))
+        {
+            cloud.push_back(vecta::vec3d<>(p.x, p.y, p.x - p.y));
+        }
+        return cloud;
+    };
+    const vecta::quatrn q(0.5, vecta::vec3d<>(1.0, 2.0, 3.0));
+
+    benchmarks.push_back({ "Rotation/scalar", int64_t(1e8), 0, [=](int64_t n)
+    {
+        vecta::vec3d_array<> cloud = getCloud(n);
+        std::vector<vecta::vec3d<>> points;
+        for (int64_t i = 0; i < n; i++)
+        {
+            points.push_back(cloud[i]);
+        }
+        return Body([=](int64_t iterations) mutable
+        {
+            for (int64_t i = 0; i < iterations; i++)
+            {
+                for (vecta::vec3d<>& p : points)
+                {
+                    p &= q;
+                }
+                Consume(points.back().z);
+            }
+        });
+    } });
+    for (int threadCount : { 1, 0 })
+    {
+        benchmarks.push_back({ threadCount == 1 ? "Rotation/batch" : "Rotation/threads", int64_t(1e8), 0, [=](int64_t n)
+        {
+            vecta::vec3d_array<> cloud = getCloud(n);
+            return Body([=](int64_t iterations) mutable
+            {
+                for (int64_t i = 0; i < iterations; i++)
+                {
+                    geometry::RotatePoints(cloud, q, threadCount);
+                    Consume(cloud.z.back());
+                }
+            });
+        } });
+    }
+}
+
+double GetSeconds(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Doubles the iterations until a run takes minTime, like Google Benchmark
+Result Run(const Benchmark& benchmark, const Body& body, int64_t n, double minTime)
+{
+    int64_t iterations = 1;
+    while (true)
+    {
+        int64_t allocations = GetAllocationCount();
+        int64_t bytes = GetAllocatedBytes();
+        int64_t live = GetLiveBytes();
+        ResetPeakBytes();
+        auto start = std::chrono::steady_clock::now();
+        body(iterations);
+        double seconds = GetSeconds(start);
+
+        if (seconds >= minTime || iterations >= int64_t(1) << 40)
+        {
+            int64_t items = (benchmark.itemsPerIteration ? benchmark.itemsPerIteration : n) * iterations;
+            Result result;
+            result.name = benchmark.name;
+            result.n = n;
+            result.iterations = iterations;
+            result.seconds = seconds;
+            result.nsPerPoint = seconds * 1e9 / items;
+            result.pointsPerSecond = items / seconds;
+            result.allocationsPerIteration = double(GetAllocationCount() - allocations) / iterations;
+            result.bytesPerIteration = double(GetAllocatedBytes() - bytes) / iterations;
+            result.peakBytes = GetPeakBytes() - live;
+            return result;
+        }
+
+        // Aim a bit past minTime from what this run took
+        double scale = seconds > 0.0 ? 1.4 * minTime / seconds : 10.0;
+        iterations = std::max(iterations + 1, int64_t(iterations * std::min(scale, 10.0)));
+    }
+}
+
+void WriteJson(FILE* file, const std::vector<Result>& results, double minTime)
+{
+    char date[32];
+    std::time_t now = std::time(nullptr);
+    std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+
+    fprintf(file, "{\n");
+    fprintf(file, "  \"context\": {\n");
+    fprintf(file, "    \"date\": \"%s\",\n", date);
+    fprintf(file, "    \"seed\": %llu,\n", (unsigned long long)Seed);
+    fprintf(file, "    \"min_time\": %g\n", minTime);
+    fprintf(file, "  },\n");
+    fprintf(file, "  \"benchmarks\": [\n");
+    for (int i = 0; i < results.size(); i++)
+    {
+        const Result& r = results[i];
+        fprintf(file, "    {\"name\": \"%s/%lld\", \"n\": %lld, \"iterations\": %lld, \"real_time_s\": %.9g, \"ns_per_point\": %.6g, \"points_per_second\": %.6g, \"allocations_per_iteration\": %.6g, \"bytes_per_iteration\": %.6g, \"peak_bytes\": %lld}%s\n",
+            r.name.c_str(), (long long)r.n, (long long)r.n, (long long)r.iterations, r.seconds, r.nsPerPoint, r.pointsPerSecond,
+            r.allocationsPerIteration, r.bytesPerIteration, (long long)r.peakBytes, i + 1 < results.size() ? "," : "");
+    }
+    fprintf(file, "  ]\n");
+    fprintf(file, "}\n");
+}
+
+int main(int argc, char** argv)
+{
+    // Benchmark [--filter=text] [--min=100] [--max=1000000] [--min_time=0.2] [--json=file]
+    //           [--report=file] [--trace=file]
+    // Benchmark --filter=Andrew/uniform --max=1e8 --json=andrew.json
+    // --report and --trace need GEOMCORE_INSTRUMENTATION: one more call per benchmark and n
+    // is made for the counters and stage times, and its stages go to a Chrome trace.
+    std::string filter;
+    std::string jsonPath;
+    std::string reportPath;
+    std::string tracePath;
+    int64_t minN = 100;
+    int64_t maxN = 1000000;
+    double minTime = 0.2;
+    for (int i = 1; i < argc; i++)
+    {
+        const char* arg = argv[i];
+        if (std::strncmp(arg, "--filter=", 9) == 0)
+        {
+            filter = arg + 9;
+        }
+        else if (std::strncmp(arg, "--min=", 6) == 0)
+        {
+            minN = int64_t(std::atof(arg + 6));
+        }
+        else if (std::strncmp(arg, "--max=", 6) == 0)
+        {
+            maxN = int64_t(std::atof(arg + 6));
+        }
+        else if (std::strncmp(arg, "--min_time=", 11) == 0)
+        {
+            minTime = std::atof(arg + 11);
+        }
+        else if (std::strncmp(arg, "--json=", 7) == 0)
+        {
+            jsonPath = arg + 7;
+        }
+        else if (std::strncmp(arg, "--report=", 9) == 0)
+        {
+            reportPath = arg + 9;
+        }
+        else if (std::strncmp(arg, "--trace=", 8) == 0)
+        {
+            tracePath = arg + 8;
+        }
+        else
+        {
+            fprintf(stderr, "Unknown argument %s\n", arg);
+            return 1;
+        }
+    }
+
+#ifndef GEOMETRY_INSTRUMENTATION
+    if (!reportPath.empty() || !tracePath.empty())
+    {
+        fprintf(stderr, "--report and --trace need a build with GEOMCORE_INSTRUMENTATION\n");
+        return 1;
+    }
+#endif
+    FILE* reportFile = reportPath.empty() ? nullptr : std::fopen(reportPath.c_str(), "w");
+    FILE* traceFile = tracePath.empty() ? nullptr : std::fopen(tracePath.c_str(), "w");
+    if ((!reportPath.empty() && !reportFile) || (!tracePath.empty() && !traceFile))
+    {
+        fprintf(stderr, "Cannot write %s\n", reportFile ? tracePath.c_str() : reportPath.c_str());
+        return 1;
+    }
+#ifdef GEOMETRY_INSTRUMENTATION
+    bool isFirstReport = true;
+    bool isFirstTraceEvent = true;
+#endif
+    if (reportFile)
+    {
+        fprintf(reportFile, "[");
+    }
+    if (traceFile)
+    {
+        fprintf(traceFile, "{\"traceEvents\": [");
+    }
+
+    std::vector<Benchmark> benchmarks;
+    AddHullBenchmarks(benchmarks);
+    AddEarcutBenchmarks(benchmarks);
+    AddSimplifyBenchmarks(benchmarks);
+    AddConvexBenchmarks(benchmarks);
+    AddCalipersBenchmarks(benchmarks);
+    AddOverlayBenchmarks(benchmarks);
+    AddPointLocationBenchmarks(benchmarks);
+    AddSpatialOrderBenchmarks(benchmarks);
+    AddKernelBenchmarks(benchmarks);
+    AddRotationBenchmarks(benchmarks);
+    AddHull3DBenchmarks(benchmarks);
+    AddCircleBenchmarks(benchmarks);
+    AddVoronoiBenchmarks(benchmarks);
+    AddClosestPairBenchmarks(benchmarks);
+
+    printf("%-28s %11s %11s %12s %14s %12s %14s %14s\n", "Benchmark", "n", "Iterations", "ns/point", "points/s", "allocs/iter", "bytes/iter", "peak bytes");
+    std::vector<Result> results;
+    for (const Benchmark& benchmark : benchmarks)
+    {
+        if (benchmark.name.find(filter) == std::string::npos)
+        {
+            continue;
+        }
+
+        for (int64_t n = minN; n <= std::min(maxN, benchmark.maxN); n *= 10)
+        {
+            Body body = benchmark.setup(n);
+            Result r = Run(benchmark, body, n, minTime);
+            printf("%-28s %11lld %11lld %12.2f %14.4g %12.1f %14.0f %14lld\n", r.name.c_str(), (long long)r.n, (long long)r.iterations,
+                r.nsPerPoint, r.pointsPerSecond, r.allocationsPerIteration, r.bytesPerIteration, (long long)r.peakBytes);
+            fflush(stdout);
+            results.push_back(r);
+
+#ifdef GEOMETRY_INSTRUMENTATION
+            if (reportFile || traceFile)
+            {
+                geometry::instrumentation::Reset();
+                body(1);
+                std::string call = r.name + "/" + std::to_string(n);
+                if (reportFile)
+                {
+                    fprintf(reportFile, "%s\n", isFirstReport ? "" : ",");
+                    geometry::instrumentation::WriteReport(reportFile, call.c_str());
+                    isFirstReport = false;
+                }
+                if (traceFile)
+                {
+                    isFirstTraceEvent = geometry::instrumentation::WriteTraceEvents(traceFile, isFirstTraceEvent);
+                }
+            }
+#endif
+        }
+    }
+
+    if (reportFile)
+    {
+        fprintf(reportFile, "\n]\n");
+        std::fclose(reportFile);
+    }
+    if (traceFile)
+    {
+        fprintf(traceFile, "\n]}\n");
+        std::fclose(traceFile);
+    }
+
+    if (!jsonPath.empty())
+    {
+        FILE* file = std::fopen(jsonPath.c_str(), "w");
+        if (!file)
+        {
+            fprintf(stderr, "Cannot write %s\n", jsonPath.c_str());
+            return 1;
+        }
+        WriteJson(file, results, minTime);
+        std::fclose(file);
+    }
+}
@@ -0,0 +1,133 @@
+﻿#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "ConstrainedDelaunay.h"
+#include "Earcut.h"
+#include "SegmentIntersection.h"
+
+using geometry::Point;
+using geometry::Triangle;
+
+const double Pi = std::acos(-1.0);
+
+// Star-shaped polygon with a random radius at every sorted angle, lots of slivers for Earcut
+std::vector<Point> GetRandomStarPolygon(int n)
+{
+    std::mt19937_64 random(42);
+    std::uniform_real_distribution<double> angle(0.0, 2.0 * Pi);
+    std::uniform_real_distribution<double> radius(10.0, 100.0);
+
+    std::vector<double> angles(n);
+    for (double& a : angles)
+    {
+        a = angle(random);
+    }
+    std::sort(angles.begin(), angles.end());
+
+    std::vector<Point> polygon(n);
+    for (int i = 0; i < n; i++)
+    {
+        double r = radius(random);
+        polygon[i] = Point(r * std::cos(angles[i]), r * std::sin(angles[i]));
+    }
+    return polygon;
+}
+
+double GetMinimumAngle(const Triangle& triangle)
+{
+    Point points[3] = { triangle.A, triangle.B, triangle.C };
+    double result = Pi;
+    for (int i = 0; i < 3; i++)
+    {
+        Point u = points[(i + 1) % 3] - points[i];
+        Point v = points[(i + 2) % 3] - points[i];
+        result = std::min(result, std::abs(std::atan2(u ^ v, u * v)));
+    }
+    return result * 180.0 / Pi;
+}
+
+void PrintQuality(const char* name, const std::vector<Triangle>& triangles, double seconds)
+{
+    // 5 degree buckets, the minimum angle of a triangle is at most 60
+    int histogram[12] = {};
+    double smallest = 60.0;
+    for (const Triangle& triangle : triangles)
+    {
+        double angle = GetMinimumAngle(triangle);
+        smallest = std::min(smallest, angle);
+        histogram[std::min(int(angle / 5.0), 11)]++;
+    }
+
+    printf("%-16s %8zu triangles %10.3f ms, min angle %6.3f\n", name, triangles.size(), seconds * 1000.0, smallest);
+    for (int i = 0; i < 12; i++)
+    {
+        printf("  [%2d, %2d) %6.2f%%\n", 5 * i, 5 * i + 5, 100.0 * histogram[i] / std::max<size_t>(triangles.size(), 1));
+    }
+}
+
+int main(int argc, char** argv)
+{
+    // Test Case 1: 4 0 0 10 0 10 10 0 10
+    // Test Case 2: 6 0 0 10 0 10 10 5 1 0 10 -5 5
+    // Benchmark:   ConstrainedDelaunay 5000
+    if (argc > 1)
+    {
+        std::vector<Point> polygon = GetRandomStarPolygon(std::atoi(argv[1]));
+
+        auto start = std::chrono::steady_clock::now();
+        std::vector<Triangle> earcut = geometry::Earcut(polygon);
+        std::chrono::duration<double> earcutTime = std::chrono::steady_clock::now() - start;
+
+        start = std::chrono::steady_clock::now();
+        geometry::Triangulation refined = geometry::ConstrainedDelaunay(polygon, earcut);
+        std::chrono::duration<double> refineTime = std::chrono::steady_clock::now() - start;
+
+        start = std::chrono::steady_clock::now();
+        geometry::Triangulation direct = geometry::ConstrainedDelaunay(polygon);
+        std::chrono::duration<double> directTime = std::chrono::steady_clock::now() - start;
+
+        PrintQuality("Earcut", earcut, earcutTime.count());
+        PrintQuality("Earcut + refine", geometry::GetTriangles(polygon, refined), earcutTime.count() + refineTime.count());
+        PrintQuality("CDT", geometry::GetTriangles(polygon, direct), directTime.count());
+        return 0;
+    }
+
+    int n;
+    std::cin >> n;
+
+    std::vector<Point> polygon(n);
+    for (Point& p : polygon)
+    {
+        std::cin >> p;
+    }
+
+    std::vector<geometry::SegmentIntersection> intersections = geometry::GetSelfIntersections(polygon, true);
+    if (!intersections.empty())
+    {
+        const geometry::SegmentIntersection& first = intersections[0];
+        printf("Not a simple polygon: edges %d and %d meet at (%.2f, %.2f)\n", first.first, first.second, first.P.x, first.P.y);
+        return 1;
+    }
+
+    std::vector<Triangle> triangles = geometry::GetTriangles(polygon, geometry::ConstrainedDelaunay(polygon, geometry::Earcut(polygon)));
+    for (int i = 0; i < triangles.size(); i++)
+    {
+        const Triangle& tri = triangles[i];
+        printf("Triangle %d: A(%.2f, %.2f) B(%.2f, %.2f) C(%.2f, %.2f)\n", i, tri.A.x, tri.A.y, tri.B.x, tri.B.y, tri.C.x, tri.C.y);
+    }
+
+    // SP
+    printf("\n");
+    for (const Triangle& tri : triangles)
+    {
+        printf("%.1f %.1f %.1f %.1f\n", tri.A.x, tri.A.y, tri.B.x, tri.B.y);
+        printf("%.1f %.1f %.1f %.1f\n", tri.B.x, tri.B.y, tri.C.x, tri.C.y);
+        printf("%.1f %.1f %.1f %.1f\n", tri.C.x, tri.C.y, tri.A.x, tri.A.y);
+    }
+}
@@ -0,0 +1,81 @@
+﻿#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "Delaunay.h"
+
+using geometry::Point;
+
+std::vector<Point> GetRandomPoints(int n)
+{
+    std::mt19937_64 random(42);
+    std::uniform_real_distribution<double> coordinate(0.0, 100.0);
+
+    std::vector<Point> points(n);
+    for (Point& p : points)
+    {
+        p = Point(coordinate(random), coordinate(random));
+    }
+    return points;
+}
+
+int main(int argc, char** argv)
+{
+    // Test Case 1: 4 0 0 10 0 10 10 0 10
+    // Test Case 2: 7 0 0 10 0 10 10 0 10 5 5 2 8 5 0
+    // Timing:      DelaunayTriangulation 10000000
+    if (argc > 1)
+    {
+        std::vector<Point> points = GetRandomPoints(std::atoi(argv[1]));
+
+        auto start = std::chrono::steady_clock::now();
+        geometry::Triangulation triangulation = geometry::DelaunayTriangulation(points);
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+        printf("%zu points, %zu triangles, %zu hull vertices in %.3f s\n", points.size(), triangulation.triangles.size() / 3, triangulation.hull.size(), elapsed.count());
+        return 0;
+    }
+
+    int n;
+    std::cin >> n;
+
+    std::vector<Point> points(n);
+    for (Point& p : points)
+    {
+        std::cin >> p;
+    }
+
+    geometry::Triangulation triangulation = geometry::DelaunayTriangulation(points);
+    const std::vector<int>& triangles = triangulation.triangles;
+    for (int i = 0; i < triangles.size() / 3; i++)
+    {
+        Point A = points[triangles[3 * i]];
+        Point B = points[triangles[3 * i + 1]];
+        Point C = points[triangles[3 * i + 2]];
+        printf("Triangle %d: A(%.2f, %.2f) B(%.2f, %.2f) C(%.2f, %.2f)\n", i, A.x, A.y, B.x, B.y, C.x, C.y);
+    }
+
+    printf("Hull: ");
+    for (int i : triangulation.hull)
+    {
+        printf("[%.1lf, %.1lf] ", points[i].x, points[i].y);
+    }
+    printf("\n");
+
+    // SP, every edge once
+    printf("\n");
+    for (int e = 0; e < triangles.size(); e++)
+    {
+        if (e < triangulation.halfedges[e])
+        {
+            continue;
+        }
+
+        Point A = points[triangles[e]];
+        Point B = points[triangles[geometry::NextHalfEdge(e)]];
+        printf("%.1f %.1f %.1f %.1f\n", A.x, A.y, B.x, B.y);
+    }
+}
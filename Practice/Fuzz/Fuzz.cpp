@@ -0,0 +1,1969 @@
+﻿#include <algorithm>
+#include <cmath>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "ClosestPair.h"
+#include "ConvexHull.h"
+#include "ConvexHull3D.h"
+#include "ConvexPolygon.h"
+#include "Earcut.h"
+#include "EnclosingCircle.h"
+#include "Generators.h"
+#include "Hilbert.h"
+#include "MonotoneTriangulation.h"
+#include "Overlay.h"
+#include "PointLocation.h"
+#include "RotatingCalipers.h"
+#include "SegmentIntersection.h"
+#include "Simplify.h"
+#include "SvgWriter.h"
+#include "TrapezoidalMap.h"
+#include "Voronoi.h"
+
+using geometry::Point;
+using geometry::Point3D;
+using geometry::PointLocation;
+
+// A generated input: points or polygon vertices, and the points to query against them
+struct Case
+{
+    std::vector<Point> points;
+    std::vector<Point> queries;
+};
+
+struct Property
+{
+    const char* name;
+    std::function<Case(std::mt19937_64&, int)> generate;
+    // Inputs the algorithms under test accept, shrinking must stay within them
+    std::function<bool(const Case&)> isValid;
+    // Empty when the variants agree, otherwise what went wrong
+    std::function<std::string(const Case&)> check;
+};
+
+std::string Format(const char* format, ...)
+{
+    char buffer[512];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+    return buffer;
+}
+
+// Degenerate point sets: collinear, duplicated, on a small integer grid and huge coordinates
+std::vector<Point> GetPoints(std::mt19937_64& random, int n)
+{
+    int kind = std::uniform_int_distribution<int>(0, 6)(random);
+    uint64_t seed = random();
+    std::vector<Point> points;
+    switch (kind)
+    {
+    case 0:
+        points = geometry::GetRandomPoints(geometry::PointDistribution::Uniform, n, seed);
+        break;
+    case 1:
+        points = geometry::GetRandomPoints(geometry::PointDistribution::Circle, n, seed);
+        break;
+    case 2:
+    {
+        // On a line, exactly
+        std::uniform_int_distribution<int> t(-50, 50);
+        Point origin(t(random), t(random));
+        Point direction(t(random) % 4, t(random) % 4);
+        for (int i = 0; i < n; i++)
+        {
+            points.push_back(origin + double(t(random)) * direction);
+        }
+        break;
+    }
+    case 3:
+    {
+        // A few grid points repeated
+        std::uniform_int_distribution<int> coordinate(0, 3);
+        for (int i = 0; i < n; i++)
+        {
+            points.push_back(Point(coordinate(random), coordinate(random)));
+        }
+        break;
+    }
+    case 4:
+    {
+        std::uniform_int_distribution<int> coordinate(-10, 10);
+        for (int i = 0; i < n; i++)
+        {
+            points.push_back(Point(coordinate(random), coordinate(random)));
+        }
+        break;
+    }
+    case 5:
+        points = geometry::GetRandomPoints(geometry::PointDistribution::Uniform, n, seed);
+        for (Point& p : points)
+        {
+            p *= 1e100;
+        }
+        break;
+    default:
+        // Nearly collinear, where the plain orientation rounds wrong
+        std::uniform_real_distribution<double> t(0.0, 1.0);
+        for (int i = 0; i < n; i++)
+        {
+            double s = t(random);
+            points.push_back(Point(0.5 + s * 12.0, 0.5 + s * 12.0 + std::ldexp(t(random) - 0.5, -40)));
+        }
+        break;
+    }
+    return points;
+}
+
+// Queries on the vertices, on the edges and their lines, and around the polygon
+std::vector<Point> GetQueries(std::mt19937_64& random, const std::vector<Point>& polygon, int count)
+{
+    std::vector<Point> queries;
+    Point min = polygon[0];
+    Point max = polygon[0];
+    for (Point p : polygon)
+    {
+        min = Point(std::min(min.x, p.x), std::min(min.y, p.y));
+        max = Point(std::max(max.x, p.x), std::max(max.y, p.y));
+    }
+    Point size = max - min;
+
+    std::uniform_int_distribution<int> kind(0, 4);
+    std::uniform_int_distribution<int> vertex(0, int(polygon.size()) - 1);
+    std::uniform_real_distribution<double> unit(-0.25, 1.25);
+    std::uniform_int_distribution<int> step(-3, 4);
+    for (int i = 0; i < count; i++)
+    {
+        int v = vertex(random);
+        Point A = polygon[v];
+        Point B = polygon[(v + 1) % polygon.size()];
+        switch (kind(random))
+        {
+        case 0:
+            queries.push_back(A);
+            break;
+        case 1:
+            // On the edge or its line, exact for integer vertices
+            queries.push_back(A + double(step(random)) * (B - A) / 2.0);
+            break;
+        case 2:
+            queries.push_back(min + Point(std::round(unit(random) * size.x), std::round(unit(random) * size.y)));
+            break;
+        default:
+            queries.push_back(min + Point(unit(random) * size.x, unit(random) * size.y));
+            break;
+        }
+    }
+    return queries;
+}
+
+double GetArea(const std::vector<Point>& polygon)
+{
+    double area = 0.0;
+    for (int i = 0; i < polygon.size(); i++)
+    {
+        area += polygon[i] ^ polygon[(i + 1) % polygon.size()];
+    }
+    return area / 2.0;
+}
+
+bool IsConvex(const std::vector<Point>& polygon)
+{
+    if (polygon.size() < 3)
+    {
+        return false;
+    }
+    int n = int(polygon.size());
+    double sign = 0.0;
+    for (int i = 0; i < n; i++)
+    {
+        double area = geometry::Orient2D(polygon[i], polygon[(i + 1) % n], polygon[(i + 2) % n]);
+        if (area == 0.0 || area * sign < 0.0)
+        {
+            return false;
+        }
+        sign = area;
+    }
+    // A convex polygon winds around once
+    return std::abs(GetArea(polygon)) > 0.0 && geometry::IsSimplePolygon(polygon);
+}
+
+// Slivers are left out, their rounded area does not even have a reliable sign
+bool IsSimple(const std::vector<Point>& polygon)
+{
+    if (polygon.size() < 3)
+    {
+        return false;
+    }
+    double size = 0.0;
+    for (Point p : polygon)
+    {
+        size = std::max(size, std::max(std::abs(p.x - polygon[0].x), std::abs(p.y - polygon[0].y)));
+    }
+    return std::abs(GetArea(polygon)) > 1e-9 * size * size && geometry::IsSimplePolygon(polygon);
+}
+
+// Sutherland-Hodgman, O(nm): a clipped by every edge of the counter-clockwise b
+std::vector<Point> ClipConvex(std::vector<Point> a, const std::vector<Point>& b)
+{
+    for (int i = 0; i < b.size() && !a.empty(); i++)
+    {
+        Point A = b[i];
+        Point B = b[(i + 1) % b.size()];
+        std::vector<Point> clipped;
+        for (int j = 0; j < a.size(); j++)
+        {
+            Point P = a[j];
+            Point Q = a[(j + 1) % a.size()];
+            double p = geometry::Orient2D(A, B, P);
+            double q = geometry::Orient2D(A, B, Q);
+            if (p >= 0.0)
+            {
+                clipped.push_back(P);
+            }
+            if ((p > 0.0 && q < 0.0) || (p < 0.0 && q > 0.0))
+            {
+                clipped.push_back(P + p / (p - q) * (Q - P));
+            }
+        }
+        a = clipped;
+    }
+    return a;
+}
+
+// Several rings in one list, a point with a NaN x ends each
+const Point RingEnd(std::nan(""), 0.0);
+
+std::vector<std::vector<Point>> GetRings(const std::vector<Point>& points)
+{
+    std::vector<std::vector<Point>> rings(1);
+    for (Point p : points)
+    {
+        if (std::isnan(p.x))
+        {
+            rings.emplace_back();
+        }
+        else
+        {
+            rings.back().push_back(p);
+        }
+    }
+    return rings;
+}
+
+// Winding number of the rings around P, P not on them
+int GetWinding(const std::vector<std::vector<Point>>& rings, Point P)
+{
+    int winding = 0;
+    for (const std::vector<Point>& ring : rings)
+    {
+        for (int i = 0; i < ring.size(); i++)
+        {
+            Point A = ring[i];
+            Point B = ring[(i + 1) % ring.size()];
+            if (A.y <= P.y && B.y > P.y && geometry::Orient2D(A, B, P) > 0.0)
+            {
+                winding++;
+            }
+            else if (B.y <= P.y && A.y > P.y && geometry::Orient2D(A, B, P) < 0.0)
+            {
+                winding--;
+            }
+        }
+    }
+    return winding;
+}
+
+double GetDistance(Point P, Point A, Point B)
+{
+    Point AB = B - A;
+    double t = AB * AB > 0.0 ? std::max(0.0, std::min(1.0, (P - A) * AB / (AB * AB))) : 0.0;
+    return vecta::len(P - (A + t * AB));
+}
+
+// Rotated to start at the lowest of the left most vertices, so equal hulls compare equal
+std::vector<Point> GetNormalized(std::vector<Point> hull)
+{
+    auto first = std::min_element(hull.begin(), hull.end(), [](Point a, Point b) { return a.x < b.x || (a.x == b.x && a.y < b.y); });
+    std::rotate(hull.begin(), first, hull.end());
+    return hull;
+}
+
+// Exactly, from the projections on the coordinate planes
+bool IsCollinear3D(const Point3D& a, const Point3D& b, const Point3D& c)
+{
+    return geometry::Orient2D(Point(a.x, a.y), Point(b.x, b.y), Point(c.x, c.y)) == 0.0
+        && geometry::Orient2D(Point(a.y, a.z), Point(b.y, b.z), Point(c.y, c.z)) == 0.0
+        && geometry::Orient2D(Point(a.z, a.x), Point(b.z, b.x), Point(c.z, c.x)) == 0.0;
+}
+
+// Star, comb or convex, maybe on a grid, with collinear vertices or clockwise
+std::vector<Point> GetTriangulationPolygon(std::mt19937_64& random, int size)
+{
+    uint64_t seed = random();
+    std::vector<Point> polygon;
+    switch (random() % 3)
+    {
+    case 0: polygon = geometry::GetStarPolygon(size + 3, seed); break;
+    case 1: polygon = geometry::GetCombPolygon(size + 3, seed); break;
+    default: polygon = geometry::GetConvexPolygon(size + 3, seed); break;
+    }
+    if (random() % 2)
+    {
+        for (Point& p : polygon)
+        {
+            p = Point(std::round(p.x * 16.0), std::round(p.y * 16.0));
+        }
+    }
+    if (random() % 2)
+    {
+        // Collinear vertices in the middle of edges
+        for (int i = int(polygon.size()) - 1; i >= 0; i -= 3)
+        {
+            polygon.insert(polygon.begin() + i + 1, (polygon[i] + polygon[(i + 1) % polygon.size()]) / 2.0);
+        }
+    }
+    if (random() % 2)
+    {
+        std::reverse(polygon.begin(), polygon.end());
+    }
+    return polygon;
+}
+
+// Triangles in the orientation of the polygon covering its area
+std::string CheckTriangles(const std::vector<Point>& polygon, const std::vector<geometry::Triangle>& triangles)
+{
+    double area = 0.0;
+    for (const geometry::Triangle& t : triangles)
+    {
+        double triangleArea = geometry::GetAreaFromPoints(t.A, t.B, t.C) / 2.0;
+        if (geometry::Orient2D(t.A, t.B, t.C) * GetArea(polygon) < 0.0)
+        {
+            return Format("Triangle (%g, %g) (%g, %g) (%g, %g) is flipped", t.A.x, t.A.y, t.B.x, t.B.y, t.C.x, t.C.y);
+        }
+        area += std::abs(triangleArea);
+    }
+    double expected = std::abs(GetArea(polygon));
+    if (std::abs(area - expected) > 1e-9 * expected)
+    {
+        return Format("%zu triangles of area %.17g, the polygon has %.17g", triangles.size(), area, expected);
+    }
+    return std::string();
+}
+
+// Simple rings that only meet in shared vertices and shared edges, none inside another
+bool IsSubdivision(const std::vector<std::vector<Point>>& rings)
+{
+    std::vector<std::pair<Point, Point>> edges;
+    for (const std::vector<Point>& ring : rings)
+    {
+        if (!IsSimple(ring))
+        {
+            return false;
+        }
+        for (int i = 0; i < ring.size(); i++)
+        {
+            if (ring[i] != ring[(i + 1) % ring.size()])
+            {
+                edges.push_back({ ring[i], ring[(i + 1) % ring.size()] });
+            }
+        }
+    }
+    auto isOn = [](Point A, Point B, Point P)
+    {
+        return P != A && P != B && geometry::Orient2D(A, B, P) == 0.0
+            && std::min(A.x, B.x) <= P.x && P.x <= std::max(A.x, B.x) && std::min(A.y, B.y) <= P.y && P.y <= std::max(A.y, B.y);
+    };
+    for (int i = 0; i < edges.size(); i++)
+    {
+        for (int j = i + 1; j < edges.size(); j++)
+        {
+            Point A = edges[i].first;
+            Point B = edges[i].second;
+            Point C = edges[j].first;
+            Point D = edges[j].second;
+            if ((A == C && B == D) || (A == D && B == C))
+            {
+                continue;
+            }
+            double c = geometry::Orient2D(A, B, C);
+            double d = geometry::Orient2D(A, B, D);
+            double a = geometry::Orient2D(C, D, A);
+            double b = geometry::Orient2D(C, D, B);
+            bool isCrossing = ((c > 0.0 && d < 0.0) || (c < 0.0 && d > 0.0)) && ((a > 0.0 && b < 0.0) || (a < 0.0 && b > 0.0));
+            if (isCrossing || isOn(A, B, C) || isOn(A, B, D) || isOn(C, D, A) || isOn(C, D, B))
+            {
+                return false;
+            }
+        }
+    }
+    for (int i = 0; i < rings.size(); i++)
+    {
+        for (int j = 0; j < rings.size(); j++)
+        {
+            for (int k = 0; k < rings[j].size() && i != j; k++)
+            {
+                Point middle = (rings[j][k] + rings[j][(k + 1) % rings[j].size()]) / 2.0;
+                if (geometry::GetPointLocation(rings[i], rings[j][k]) == PointLocation::Inside || geometry::GetPointLocation(rings[i], middle) == PointLocation::Inside)
+                {
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+// Brute force for GetIntersections(): AB and CD cross or one has an end on the other
+bool IsMeeting(Point A, Point B, Point C, Point D)
+{
+    auto isOn = [](Point A, Point B, Point P)
+    {
+        return geometry::Orient2D(A, B, P) == 0.0
+            && std::min(A.x, B.x) <= P.x && P.x <= std::max(A.x, B.x) && std::min(A.y, B.y) <= P.y && P.y <= std::max(A.y, B.y);
+    };
+    double c = geometry::Orient2D(A, B, C);
+    double d = geometry::Orient2D(A, B, D);
+    double a = geometry::Orient2D(C, D, A);
+    double b = geometry::Orient2D(C, D, B);
+    bool isCrossing = ((c > 0.0 && d < 0.0) || (c < 0.0 && d > 0.0)) && ((a > 0.0 && b < 0.0) || (a < 0.0 && b > 0.0));
+    return isCrossing || isOn(A, B, C) || isOn(A, B, D) || isOn(C, D, A) || isOn(C, D, B);
+}
+
+// What one style group of an SvgWriter page draws, each sorted and without repeats. The
+// ends of a segment are in x then y order.
+struct SvgGroup
+{
+    std::vector<std::pair<Point, Point>> segments;
+    std::vector<Point> points;
+};
+
+bool IsBefore(Point a, Point b)
+{
+    return a.x < b.x || (a.x == b.x && a.y < b.y);
+}
+
+std::vector<SvgGroup> ReadSvgGroups(const std::string& svg)
+{
+    std::vector<SvgGroup> groups;
+    for (size_t at = svg.find("<g "); at != std::string::npos; at = svg.find("<g ", at + 1))
+    {
+        size_t end = std::min(svg.find("<g ", at + 1), svg.size());
+        SvgGroup group;
+        for (size_t d = svg.find(" d=\"", at); d < end; d = svg.find(" d=\"", d + 1))
+        {
+            const char* p = svg.c_str() + d + 4;
+            Point current(0.0, 0.0);
+            while (*p != '"' && *p != '\0')
+            {
+                char command = *p++;
+                if (command == 'h')
+                {
+                    // A dot, "h0"
+                    p++;
+                    group.points.push_back(current);
+                    continue;
+                }
+                char* next;
+                Point P;
+                P.x = std::strtod(p, &next);
+                P.y = std::strtod(next, &next);
+                p = next;
+                if (command == 'L')
+                {
+                    group.segments.push_back(IsBefore(current, P) ? std::make_pair(current, P) : std::make_pair(P, current));
+                }
+                current = P;
+            }
+        }
+        std::sort(group.segments.begin(), group.segments.end(), [](const std::pair<Point, Point>& a, const std::pair<Point, Point>& b)
+        {
+            return IsBefore(a.first, b.first) || (a.first == b.first && IsBefore(a.second, b.second));
+        });
+        group.segments.erase(std::unique(group.segments.begin(), group.segments.end()), group.segments.end());
+        std::sort(group.points.begin(), group.points.end(), IsBefore);
+        group.points.erase(std::unique(group.points.begin(), group.points.end()), group.points.end());
+        groups.push_back(group);
+    }
+    return groups;
+}
+
+std::string ToString(const std::vector<Point>& points)
+{
+    std::string text;
+    for (Point p : points)
+    {
+        text += Format("(%.17g, %.17g) ", p.x, p.y);
+    }
+    return text;
+}
+
+std::vector<Property> GetProperties()
+{
+    std::vector<Property> properties;
+
+    properties.push_back({ "Hulls", [](std::mt19937_64& random, int size)
+    {
+        return Case{ GetPoints(random, size), {} };
+    }, [](const Case& c)
+    {
+        return !c.points.empty();
+    }, [](const Case& c)
+    {
+        std::vector<Point> jarvis = GetNormalized(geometry::GiftWrap_Jarvis(c.points));
+        std::vector<Point> graham = GetNormalized(geometry::GrahamScan_Graham(c.points));
+        std::vector<Point> andrew = GetNormalized(geometry::MonotoneChain_Andrews(c.points));
+        if (jarvis != andrew || graham != andrew)
+        {
+            return "Jarvis " + ToString(jarvis) + "\nGraham " + ToString(graham) + "\nAndrew " + ToString(andrew);
+        }
+        if (andrew.size() >= 3 && !IsConvex(andrew))
+        {
+            return "Not convex " + ToString(andrew);
+        }
+        for (Point p : c.points)
+        {
+            if (andrew.size() >= 3 && geometry::GetPointLocationLinear(andrew, p) == PointLocation::Outside)
+            {
+                return Format("(%.17g, %.17g) is outside the hull ", p.x, p.y) + ToString(andrew);
+            }
+        }
+        return std::string();
+    } });
+
+    // Against every pair: both closest pairs, the near duplicates within an eighth of the
+    // distance from the first to the last point, and the nearest neighbours up to 1e60
+    properties.push_back({ "ClosestPair", [](std::mt19937_64& random, int size)
+    {
+        return Case{ GetPoints(random, size), {} };
+    }, [](const Case& c)
+    {
+        return !c.points.empty();
+    }, [](const Case& c)
+    {
+        const std::vector<Point>& points = c.points;
+        int n = int(points.size());
+        auto getDistance2 = [&](int a, int b)
+        {
+            double dx = points[a].x - points[b].x;
+            double dy = points[a].y - points[b].y;
+            return dx * dx + dy * dy;
+        };
+        double epsilon = std::sqrt(getDistance2(0, n - 1)) / 8.0;
+        double epsilon2 = epsilon * epsilon;
+        std::vector<int> groups(n);
+        std::vector<int> nearest(n, -1);
+        double closest2 = std::numeric_limits<double>::infinity();
+        for (int a = 0; a < n; a++)
+        {
+            groups[a] = a;
+        }
+        for (int a = 0; a < n; a++)
+        {
+            for (int b = 0; b < n; b++)
+            {
+                if (b == a)
+                {
+                    continue;
+                }
+                double distance2 = getDistance2(a, b);
+                closest2 = std::min(closest2, distance2);
+                if (nearest[a] == -1 || distance2 < getDistance2(a, nearest[a]))
+                {
+                    nearest[a] = b;
+                }
+                if (distance2 <= epsilon2 && groups[a] != groups[b])
+                {
+                    int from = std::max(groups[a], groups[b]);
+                    int to = std::min(groups[a], groups[b]);
+                    for (int& group : groups)
+                    {
+                        group = group == from ? to : group;
+                    }
+                }
+            }
+        }
+
+        geometry::SortedPoints sorted = geometry::SortByXThenByY(points);
+        geometry::PointPair sweep = geometry::ClosestPair_Sweep(sorted);
+        for (int threadCount : { 1, 4 })
+        {
+            geometry::PointPair divided = geometry::ClosestPair_DivideAndConquer(sorted, threadCount);
+            if (divided.a != sweep.a || divided.b != sweep.b || divided.distance != sweep.distance)
+            {
+                return Format("Sweep (%d, %d) at %.17g, on %d threads divide and conquer (%d, %d) at %.17g",
+                    sweep.a, sweep.b, sweep.distance, threadCount, divided.a, divided.b, divided.distance);
+            }
+        }
+        if (n < 2 ? sweep.a != -1 : sweep.a < 0 || sweep.a >= sweep.b || sweep.b >= n || getDistance2(sweep.a, sweep.b) != closest2 || sweep.distance != std::sqrt(closest2))
+        {
+            return Format("Closest pair (%d, %d) at %.17g, the closest is at %.17g", sweep.a, sweep.b, sweep.distance, std::sqrt(closest2));
+        }
+
+        std::vector<int> duplicates = geometry::GetNearDuplicates(sorted, epsilon);
+        if (duplicates != groups)
+        {
+            for (int a = 0; a < n; a++)
+            {
+                if (duplicates[a] != groups[a])
+                {
+                    return Format("Point %d is in the group of %d, not %d, epsilon %.17g", a, duplicates[a], groups[a], epsilon);
+                }
+            }
+        }
+
+        // Delaunay neighbours hold the nearest point exactly, the squares may round apart.
+        // InCircle is of degree four, beyond about 1e75 it overflows.
+        for (Point p : points)
+        {
+            if (std::abs(p.x) > 1e60 || std::abs(p.y) > 1e60)
+            {
+                return std::string();
+            }
+        }
+        std::vector<int> neighbours = geometry::GetAllNearestNeighbours(sorted);
+        for (int a = 0; a < n; a++)
+        {
+            int b = neighbours[a];
+            if (nearest[a] == -1 ? b != -1 : b < 0 || b >= n || b == a || (b != nearest[a] && !(getDistance2(a, b) <= getDistance2(a, nearest[a]) * (1.0 + 1e-12))))
+            {
+                return Format("The nearest to %d is %d, not %d", a, nearest[a], b);
+            }
+        }
+        return std::string();
+    } });
+
+    properties.push_back({ "ConvexLocation", [](std::mt19937_64& random, int size)
+    {
+        std::vector<Point> polygon = geometry::MonotoneChain_Andrews(GetPoints(random, size + 3));
+        if (random() % 2)
+        {
+            std::reverse(polygon.begin(), polygon.end());
+        }
+        // Any vertex may come first
+        if (!polygon.empty())
+        {
+            std::rotate(polygon.begin(), polygon.begin() + random() % polygon.size(), polygon.end());
+        }
+        std::vector<Point> queries = polygon.empty() ? std::vector<Point>() : GetQueries(random, polygon, 32);
+        return Case{ polygon, queries };
+    }, [](const Case& c)
+    {
+        return IsConvex(c.points);
+    }, [](const Case& c)
+    {
+        for (Point P : c.queries)
+        {
+            PointLocation linear = geometry::GetPointLocationLinear(c.points, P);
+            PointLocation binary = geometry::GetPointLocationBinary(c.points, P);
+            PointLocation rayCast = geometry::GetPointLocation(c.points, P);
+            if (linear != binary || linear != rayCast)
+            {
+                return Format("(%.17g, %.17g): Linear %s, Binary %s, RayCast %s", P.x, P.y,
+                    geometry::ToString(linear), geometry::ToString(binary), geometry::ToString(rayCast));
+            }
+        }
+        return std::string();
+    } });
+
+    properties.push_back({ "MonotoneLocation", [](std::mt19937_64& random, int size)
+    {
+        std::vector<Point> comb = geometry::GetCombPolygon(size + 4, random());
+        if (random() % 2)
+        {
+            // Integer vertices, so queries on the edges are exact
+            for (Point& p : comb)
+            {
+                p = Point(std::round(p.x * 64.0), std::round(p.y * 64.0));
+            }
+        }
+        return Case{ comb, GetQueries(random, comb, 32) };
+    }, [](const Case& c)
+    {
+        // The base has to stay the first two vertices, see GetCombChains()
+        if (c.points.size() < 4 || c.points[0].y != c.points[1].y || !IsSimple(c.points))
+        {
+            return false;
+        }
+        for (int i = 2; i < c.points.size(); i++)
+        {
+            Point previous = i == 2 ? c.points[1] : c.points[i - 1];
+            if (c.points[i].x >= previous.x || c.points[i].x <= c.points[0].x)
+            {
+                return false;
+            }
+        }
+        return true;
+    }, [](const Case& c)
+    {
+        std::vector<Point> upperChain;
+        std::vector<Point> lowerChain;
+        geometry::GetCombChains(c.points, upperChain, lowerChain);
+        for (Point P : c.queries)
+        {
+            PointLocation monotone = geometry::GetPointLocationMonotone(upperChain, lowerChain, P);
+            PointLocation rayCast = geometry::GetPointLocation(c.points, P);
+            if (monotone != rayCast)
+            {
+                return Format("(%.17g, %.17g): Monotone %s, RayCast %s", P.x, P.y, geometry::ToString(monotone), geometry::ToString(rayCast));
+            }
+        }
+        return std::string();
+    } });
+
+    properties.push_back({ "Winding", [](std::mt19937_64& random, int size)
+    {
+        // Random rings cross themselves and each other, on a grid their edges overlap too
+        Case c;
+        bool isGrid = random() % 2;
+        int ringCount = 1 + int(random() % 3);
+        for (int r = 0; r < ringCount; r++)
+        {
+            std::vector<Point> ring = GetPoints(random, size + 3);
+            for (Point& p : ring)
+            {
+                p = isGrid ? Point(std::round(p.x * 8.0), std::round(p.y * 8.0)) : p;
+            }
+            if (r > 0)
+            {
+                c.points.push_back(RingEnd);
+            }
+            c.points.insert(c.points.end(), ring.begin(), ring.end());
+            std::vector<Point> queries = GetQueries(random, ring, 16);
+            c.queries.insert(c.queries.end(), queries.begin(), queries.end());
+        }
+        return c;
+    }, [](const Case& c)
+    {
+        return !c.points.empty();
+    }, [](const Case& c)
+    {
+        std::vector<std::vector<Point>> rings = GetRings(c.points);
+        std::vector<Point> points;
+        std::vector<int> offsets(1, 0);
+        for (const std::vector<Point>& ring : rings)
+        {
+            points.insert(points.end(), ring.begin(), ring.end());
+            offsets.push_back(int(points.size()));
+        }
+        for (Point P : c.queries)
+        {
+            bool isEdge = false;
+            for (const std::vector<Point>& ring : rings)
+            {
+                for (int i = 0; i < ring.size(); i++)
+                {
+                    Point A = ring[i];
+                    Point B = ring[(i + 1) % ring.size()];
+                    isEdge = isEdge || (geometry::Orient2D(A, B, P) == 0.0
+                        && std::min(A.x, B.x) <= P.x && P.x <= std::max(A.x, B.x)
+                        && std::min(A.y, B.y) <= P.y && P.y <= std::max(A.y, B.y));
+                }
+            }
+            int winding = isEdge ? 0 : GetWinding(rings, P);
+            PointLocation nonZero = geometry::GetPointLocation(points, offsets, P, geometry::FillRule::NonZero);
+            PointLocation evenOdd = geometry::GetPointLocation(points, offsets, P, geometry::FillRule::EvenOdd);
+            PointLocation expectedNonZero = isEdge ? PointLocation::Edge : (winding != 0 ? PointLocation::Inside : PointLocation::Outside);
+            PointLocation expectedEvenOdd = isEdge ? PointLocation::Edge : (winding % 2 != 0 ? PointLocation::Inside : PointLocation::Outside);
+            if (nonZero != expectedNonZero || evenOdd != expectedEvenOdd || (!isEdge && geometry::GetWindingNumber(points, offsets, P) != winding))
+            {
+                return Format("(%.17g, %.17g): NonZero %s, EvenOdd %s, winding %d, expected %s, %s", P.x, P.y,
+                    geometry::ToString(nonZero), geometry::ToString(evenOdd), winding, geometry::ToString(expectedNonZero), geometry::ToString(expectedEvenOdd));
+            }
+            // One ring: the crossing parity of ray casting
+            if (rings.size() == 1 && geometry::GetPointLocation(rings[0], P, geometry::FillRule::EvenOdd) != geometry::GetPointLocation(rings[0], P))
+            {
+                return Format("(%.17g, %.17g): EvenOdd %s, RayCast %s", P.x, P.y, geometry::ToString(evenOdd), geometry::ToString(geometry::GetPointLocation(rings[0], P)));
+            }
+        }
+        return std::string();
+    } });
+
+    properties.push_back({ "SpatialOrder", [](std::mt19937_64& random, int size)
+    {
+        // Up to 8192 points, so both std::sort and the radix passes are used
+        return Case{ GetPoints(random, size * (1 + int(random() % 128))), {} };
+    }, [](const Case& c)
+    {
+        return !c.points.empty();
+    }, [](const Case& c)
+    {
+        Point min = c.points[0];
+        Point max = c.points[0];
+        std::vector<double> x;
+        std::vector<double> y;
+        for (Point p : c.points)
+        {
+            min = Point(std::min(min.x, p.x), std::min(min.y, p.y));
+            max = Point(std::max(max.x, p.x), std::max(max.y, p.y));
+            x.push_back(p.x);
+            y.push_back(p.y);
+        }
+        for (geometry::SpatialCurve curve : { geometry::SpatialCurve::Hilbert, geometry::SpatialCurve::Morton })
+        {
+            auto getKey = [&](int i)
+            {
+                Point P = c.points[i];
+                return curve == geometry::SpatialCurve::Hilbert ? uint64_t(geometry::GetHilbertKey(P, min, max)) : geometry::GetMortonKey(P, min, max);
+            };
+            std::vector<int> order = geometry::GetSpatialOrder(c.points, curve);
+            if (order != geometry::GetSpatialOrder(x, y, curve))
+            {
+                return Format("%s: the arrays give another order", geometry::ToString(curve));
+            }
+            std::vector<bool> isSeen(c.points.size());
+            for (int i = 0; i < order.size(); i++)
+            {
+                if (order.size() != c.points.size() || order[i] < 0 || order[i] >= c.points.size() || isSeen[order[i]])
+                {
+                    return Format("%s: not a permutation at %d", geometry::ToString(curve), i);
+                }
+                isSeen[order[i]] = true;
+                // Equal keys keep the order of the points
+                if (i > 0 && (getKey(order[i - 1]) > getKey(order[i]) || (getKey(order[i - 1]) == getKey(order[i]) && order[i - 1] > order[i])))
+                {
+                    return Format("%s: %d before %d", geometry::ToString(curve), order[i - 1], order[i]);
+                }
+            }
+        }
+        return std::string();
+    } });
+
+    properties.push_back({ "TrapezoidalMap", [](std::mt19937_64& random, int size)
+    {
+        std::vector<std::vector<Point>> parcels;
+        if (random() % 4 == 0)
+        {
+            // A fan, every edge but the outline meets in one vertex
+            std::vector<Point> outline = geometry::GetConvexPolygon(size + 3, random());
+            Point center(0.0, 0.0);
+            for (Point p : outline)
+            {
+                center += p / double(outline.size());
+            }
+            for (int i = 0; i < outline.size(); i++)
+            {
+                parcels.push_back({ center, outline[i], outline[(i + 1) % outline.size()] });
+            }
+        }
+        else
+        {
+            parcels = geometry::GetParcels(size + 1, random() % 3 ? 0.2 : 0.0, random());
+        }
+        bool isGrid = random() % 2;
+        for (std::vector<Point>& parcel : parcels)
+        {
+            for (Point& p : parcel)
+            {
+                p = isGrid ? Point(std::round(p.x * 8.0) / 8.0, std::round(p.y * 8.0) / 8.0) : p;
+            }
+            if (random() % 2)
+            {
+                std::reverse(parcel.begin(), parcel.end());
+            }
+        }
+        if (parcels.size() > 2 && random() % 2)
+        {
+            // A hole
+            parcels.erase(parcels.begin() + random() % parcels.size());
+        }
+
+        Case c;
+        std::vector<Point> queries = GetPoints(random, 2 * size + 8);
+        for (const std::vector<Point>& parcel : parcels)
+        {
+            if (!c.points.empty())
+            {
+                c.points.push_back(RingEnd);
+            }
+            c.points.insert(c.points.end(), parcel.begin(), parcel.end());
+            queries.push_back(parcel[random() % parcel.size()]);
+            int i = int(random() % parcel.size());
+            queries.push_back((parcel[i] + parcel[(i + 1) % parcel.size()]) / 2.0);
+            queries.push_back(Point(std::round(parcel[i].x * 8.0) / 8.0, parcel[(i + 1) % parcel.size()].y));
+        }
+        c.queries = queries;
+        return c;
+    }, [](const Case& c)
+    {
+        return !c.points.empty() && IsSubdivision(GetRings(c.points));
+    }, [](const Case& c)
+    {
+        std::vector<std::vector<Point>> parcels = GetRings(c.points);
+        geometry::TrapezoidalMap map(parcels, c.points.size());
+        std::vector<geometry::FaceLocation> locations;
+        map.GetLocations(c.queries, locations, 2);
+        for (int i = 0; i < c.queries.size(); i++)
+        {
+            Point P = c.queries[i];
+            geometry::FaceLocation location = locations[i];
+            int face = -1;
+            bool isEdge = false;
+            for (int j = 0; j < parcels.size(); j++)
+            {
+                PointLocation rayCast = geometry::GetPointLocation(parcels[j], P);
+                isEdge = isEdge || rayCast == PointLocation::Edge;
+                face = rayCast == PointLocation::Inside ? j : face;
+            }
+            PointLocation expected = isEdge ? PointLocation::Edge : (face == -1 ? PointLocation::Outside : PointLocation::Inside);
+            bool isFaceRight = isEdge ? location.face != -1 && geometry::GetPointLocation(parcels[location.face], P) == PointLocation::Edge : location.face == face;
+            if (location.location != expected || !isFaceRight)
+            {
+                return Format("(%.17g, %.17g): face %d %s, ray casting %d %s", P.x, P.y, location.face, geometry::ToString(location.location), face, geometry::ToString(expected));
+            }
+        }
+        return std::string();
+    } });
+
+    properties.push_back({ "EarcutArea", [](std::mt19937_64& random, int size)
+    {
+        return Case{ GetTriangulationPolygon(random, size), {} };
+    }, [](const Case& c)
+    {
+        return IsSimple(c.points);
+    }, [](const Case& c)
+    {
+        return CheckTriangles(c.points, geometry::Earcut(c.points));
+    } });
+
+    properties.push_back({ "MonotoneTriangulation", [](std::mt19937_64& random, int size)
+    {
+        return Case{ GetTriangulationPolygon(random, size), {} };
+    }, [](const Case& c)
+    {
+        return IsSimple(c.points);
+    }, [](const Case& c)
+    {
+        std::vector<geometry::Triangle> triangles = geometry::MonotoneTriangulation(c.points);
+        int n = 0;
+        for (int i = 0; i < c.points.size(); i++)
+        {
+            n += c.points[i] != c.points[(i + 1) % c.points.size()] ? 1 : 0;
+        }
+        if (triangles.size() != n - 2)
+        {
+            return Format("%zu triangles for %d vertices", triangles.size(), n);
+        }
+        return CheckTriangles(c.points, triangles);
+    } });
+
+    properties.push_back({ "SimplifyTopology", [](std::mt19937_64& random, int size)
+    {
+        uint64_t seed = random();
+        std::vector<Point> polygon = random() % 2 ? geometry::GetStarPolygon(size + 3, seed) : geometry::GetCombPolygon(size + 3, seed);
+        double noise = std::ldexp(1.0, -int(random() % 40));
+        polygon = geometry::GetOversampledPolygon(polygon, 2 + int(random() % 8), noise, random());
+        if (random() % 2)
+        {
+            for (Point& p : polygon)
+            {
+                p = Point(std::round(p.x * 64.0), std::round(p.y * 64.0));
+            }
+        }
+        return Case{ polygon, {} };
+    }, [](const Case& c)
+    {
+        return IsSimple(c.points);
+    }, [](const Case& c)
+    {
+        for (double tolerance : { 0.0, 1e-6, 1e-3, 0.1, 1.0, 100.0 })
+        {
+            std::vector<Point> simplified = geometry::Simplify_Visvalingam(c.points, tolerance);
+            // What is left must be a subsequence of the input
+            int next = 0;
+            for (Point p : simplified)
+            {
+                while (next < c.points.size() && c.points[next] != p)
+                {
+                    next++;
+                }
+                if (next++ == c.points.size())
+                {
+                    return Format("Tolerance %g: (%.17g, %.17g) is not in order", tolerance, p.x, p.y);
+                }
+            }
+            if (simplified.size() < 3 || GetArea(simplified) == 0.0 || !geometry::IsSimplePolygon(simplified))
+            {
+                return Format("Tolerance %g: not simple ", tolerance) + ToString(simplified);
+            }
+        }
+        return std::string();
+    } });
+
+    // The second polygon goes in the queries, its vertices are the query points too
+    properties.push_back({ "ConvexOps", [](std::mt19937_64& random, int size)
+    {
+        std::vector<Point> a = geometry::MonotoneChain_Andrews(GetPoints(random, size + 3));
+        std::vector<Point> b = geometry::MonotoneChain_Andrews(GetPoints(random, size + 3));
+        for (std::vector<Point>* polygon : { &a, &b })
+        {
+            if (!polygon->empty())
+            {
+                std::rotate(polygon->begin(), polygon->begin() + random() % polygon->size(), polygon->end());
+            }
+        }
+        if (random() % 2 && !a.empty())
+        {
+            // Around a, so that they meet in every way
+            std::vector<Point> queries = GetQueries(random, a, size + 3);
+            b = geometry::MonotoneChain_Andrews(queries);
+        }
+        return Case{ a, b };
+    }, [](const Case& c)
+    {
+        return IsConvex(c.points) && GetArea(c.points) > 0.0 && IsConvex(c.queries) && GetArea(c.queries) > 0.0;
+    }, [](const Case& c)
+    {
+        const std::vector<Point>& a = c.points;
+        const std::vector<Point>& b = c.queries;
+
+        double scale = 0.0;
+        for (const std::vector<Point>* polygon : { &a, &b })
+        {
+            for (Point p : *polygon)
+            {
+                scale = std::max(scale, std::max(std::abs(p.x), std::abs(p.y)));
+            }
+        }
+
+        std::vector<Point> intersection = geometry::IntersectConvex(a, b);
+        double area = intersection.size() >= 3 ? GetArea(intersection) : 0.0;
+        std::vector<Point> clipped = ClipConvex(a, b);
+        double expected = clipped.size() >= 3 ? GetArea(clipped) : 0.0;
+        if (std::abs(area - expected) > 1e-9 * scale * scale)
+        {
+            return Format("Intersection area %.17g, clipping gives %.17g\n", area, expected) + ToString(intersection);
+        }
+
+        std::vector<Point> sums;
+        for (Point p : a)
+        {
+            for (Point q : b)
+            {
+                sums.push_back(p + q);
+            }
+        }
+        std::vector<Point> minkowski = GetNormalized(geometry::GetMinkowskiSum(a, b));
+        std::vector<Point> expectedSum = GetNormalized(geometry::MonotoneChain_Andrews(sums));
+        // Corners of the rounded sums that are almost on a line may be left out
+        bool isSum = IsConvex(minkowski);
+        for (Point p : minkowski)
+        {
+            isSum = isSum && std::find(sums.begin(), sums.end(), p) != sums.end();
+        }
+        if (!isSum || std::abs(GetArea(minkowski) - GetArea(expectedSum)) > 1e-9 * scale * scale)
+        {
+            return "Minkowski sum " + ToString(minkowski) + "\nHull of the sums " + ToString(expectedSum);
+        }
+
+        for (Point P : b)
+        {
+            Point direction = P - a[0];
+            if (direction == Point(0.0, 0.0))
+            {
+                continue;
+            }
+            int extreme = geometry::GetExtremeVertex(a, direction);
+            for (Point q : a)
+            {
+                if (geometry::Orient2D(a[extreme], a[extreme] + ~direction, q) > 0.0 && (q - a[extreme]) * direction > 1e-12 * scale * scale)
+                {
+                    return Format("Direction (%.17g, %.17g): vertex %d, but (%.17g, %.17g) is further", direction.x, direction.y, extreme, q.x, q.y);
+                }
+            }
+
+            int first;
+            int second;
+            bool isOutside = geometry::GetPointLocationLinear(a, P) == PointLocation::Outside;
+            if (geometry::GetTangents(a, P, first, second) != isOutside)
+            {
+                return Format("(%.17g, %.17g) is %s but tangents %s", P.x, P.y, isOutside ? "outside" : "not outside", isOutside ? "not found" : "found");
+            }
+            if (!isOutside)
+            {
+                continue;
+            }
+            for (Point q : a)
+            {
+                if (geometry::Orient2D(P, a[first], q) > 0.0 || geometry::Orient2D(P, a[second], q) < 0.0)
+                {
+                    return Format("(%.17g, %.17g): tangents at %d and %d cut the polygon", P.x, P.y, first, second);
+                }
+            }
+        }
+        return std::string();
+    } });
+
+    properties.push_back({ "Calipers", [](std::mt19937_64& random, int size)
+    {
+        std::vector<Point> hull = geometry::MonotoneChain_Andrews(GetPoints(random, size + 3));
+        if (!hull.empty())
+        {
+            std::rotate(hull.begin(), hull.begin() + random() % hull.size(), hull.end());
+        }
+        return Case{ hull, {} };
+    }, [](const Case& c)
+    {
+        return IsConvex(c.points) && GetArea(c.points) > 0.0;
+    }, [](const Case& c)
+    {
+        const std::vector<Point>& hull = c.points;
+        int n = int(hull.size());
+        double scale = 0.0;
+        for (Point p : hull)
+        {
+            scale = std::max(scale, std::max(std::abs(p.x), std::abs(p.y)));
+        }
+        double tolerance = 1e-9 * scale;
+
+        // Brute force: every pair, and every edge with the box around it
+        double diameter = 0.0;
+        for (Point p : hull)
+        {
+            for (Point q : hull)
+            {
+                diameter = std::max(diameter, vecta::len(q - p));
+            }
+        }
+        double width = HUGE_VAL;
+        double area = HUGE_VAL;
+        double perimeter = HUGE_VAL;
+        for (int i = 0; i < n; i++)
+        {
+            Point u = hull[(i + 1) % n] - hull[i];
+            u = u / vecta::len(u);
+            double left = HUGE_VAL;
+            double right = -HUGE_VAL;
+            double height = 0.0;
+            for (Point p : hull)
+            {
+                left = std::min(left, u * (p - hull[i]));
+                right = std::max(right, u * (p - hull[i]));
+                height = std::max(height, u ^ (p - hull[i]));
+            }
+            width = std::min(width, height);
+            area = std::min(area, (right - left) * height);
+            perimeter = std::min(perimeter, 2.0 * (right - left + height));
+        }
+
+        geometry::HullMeasures measures = geometry::GetHullMeasures(hull);
+        if (std::abs(measures.diameter - diameter) > tolerance || std::abs(measures.diameter - vecta::len(hull[measures.diameterSecond] - hull[measures.diameterFirst])) > tolerance)
+        {
+            return Format("Diameter %.17g between %d and %d, brute force %.17g", measures.diameter, measures.diameterFirst, measures.diameterSecond, diameter);
+        }
+        if (std::abs(measures.width - width) > tolerance)
+        {
+            return Format("Width %.17g, brute force %.17g", measures.width, width);
+        }
+        if (std::abs(measures.minAreaBox.area - area) > tolerance * scale || std::abs(measures.minPerimeterBox.perimeter - perimeter) > tolerance)
+        {
+            return Format("Box area %.17g perimeter %.17g, brute force %.17g %.17g", measures.minAreaBox.area, measures.minPerimeterBox.perimeter, area, perimeter);
+        }
+        for (const geometry::OrientedBox* box : { &measures.minAreaBox, &measures.minPerimeterBox })
+        {
+            for (int k = 0; k < 4; k++)
+            {
+                Point A = box->corners[k];
+                Point B = box->corners[(k + 1) % 4];
+                Point u = (B - A) / std::max(vecta::len(B - A), 1e-300);
+                for (Point p : hull)
+                {
+                    if ((u ^ (p - A)) < -tolerance)
+                    {
+                        return Format("(%.17g, %.17g) is outside the box side %d", p.x, p.y, k);
+                    }
+                }
+            }
+        }
+
+        // Antipodal: some direction takes both to the two ends
+        std::vector<std::pair<int, int>> pairs;
+        geometry::GetAntipodalPairs(hull, pairs);
+        if (2 * pairs.size() > 3 * n)
+        {
+            return Format("%d antipodal pairs for %d vertices", int(pairs.size()), n);
+        }
+        bool hasDiameter = false;
+        for (int k = 0; k < pairs.size(); k++)
+        {
+            int a = pairs[k].first;
+            int b = pairs[k].second;
+            if (a >= b || (k > 0 && std::find(pairs.begin(), pairs.begin() + k, pairs[k]) != pairs.begin() + k))
+            {
+                return Format("Pair (%d, %d) out of order or repeated", a, b);
+            }
+            hasDiameter = hasDiameter || std::abs(vecta::len(hull[b] - hull[a]) - diameter) <= tolerance;
+            bool isAntipodal = false;
+            for (int e : { (a + n - 1) % n, a, (b + n - 1) % n, b })
+            {
+                Point u = hull[(e + 1) % n] - hull[e];
+                u = u / vecta::len(u);
+                double lowest = HUGE_VAL;
+                for (Point p : hull)
+                {
+                    lowest = std::min(lowest, u ^ (p - hull[e]));
+                }
+                // The line of edge e and its parallel through the other end hold the hull
+                int other = (e == a || e == (a + n - 1) % n) ? b : a;
+                double height = u ^ (hull[other] - hull[e]);
+                double highest = 0.0;
+                for (Point p : hull)
+                {
+                    highest = std::max(highest, u ^ (p - hull[e]));
+                }
+                isAntipodal = isAntipodal || (lowest >= -tolerance && height >= highest - tolerance);
+            }
+            if (!isAntipodal)
+            {
+                return Format("(%d, %d) is not antipodal", a, b);
+            }
+        }
+        if (!hasDiameter)
+        {
+            return std::string("The diameter is not among the antipodal pairs");
+        }
+
+        // The batch form over the same hull twice
+        std::vector<Point> hulls = hull;
+        hulls.insert(hulls.end(), hull.begin(), hull.end());
+        std::vector<geometry::HullMeasures> batch;
+        geometry::GetHullMeasures(hulls, { 0, n, 2 * n }, batch, 2);
+        for (const geometry::HullMeasures& m : batch)
+        {
+            if (m.diameter != measures.diameter || m.width != measures.width || m.minAreaBox.area != measures.minAreaBox.area)
+            {
+                return std::string("The batch form differs");
+            }
+        }
+        return std::string();
+    } });
+
+    // Subject rings in the points, clipping rings in the queries. Insideness by the even-odd
+    // rule at points away from every edge must match the winding of the result.
+    properties.push_back({ "EnclosingCircle", [](std::mt19937_64& random, int size)
+    {
+        return Case{ GetPoints(random, size), {} };
+    }, [](const Case& c)
+    {
+        // InCircle is of degree four, beyond about 1e75 it overflows
+        for (Point p : c.points)
+        {
+            if (std::abs(p.x) > 1e60 || std::abs(p.y) > 1e60)
+            {
+                return false;
+            }
+        }
+        return !c.points.empty();
+    }, [](const Case& c)
+    {
+        // Every point inside, up to the rounding of the center
+        auto isEnclosing = [&](geometry::Circle circle)
+        {
+            for (Point p : c.points)
+            {
+                if (vecta::len(p - circle.center) > circle.radius * (1.0 + 1e-9) + 1e-9)
+                {
+                    return false;
+                }
+            }
+            return true;
+        };
+        geometry::Circle welzl = geometry::Welzl(c.points, c.points.size());
+        geometry::Circle culled = geometry::GetMinimumEnclosingCircle(c.points, 2);
+        std::vector<Point> clusters = c.points;
+        clusters.insert(clusters.end(), c.points.begin(), c.points.end());
+        std::vector<geometry::Circle> batch;
+        geometry::GetMinimumEnclosingCircles(clusters, { 0, int(c.points.size()), int(clusters.size()) }, batch, 2);
+        for (geometry::Circle circle : { welzl, culled, batch[0], batch[1] })
+        {
+            if (!isEnclosing(circle) || std::abs(circle.radius - welzl.radius) > 1e-9 * (1.0 + welzl.radius))
+            {
+                return Format("Welzl (%.17g, %.17g) r %.17g, other (%.17g, %.17g) r %.17g", welzl.center.x, welzl.center.y, welzl.radius,
+                    circle.center.x, circle.center.y, circle.radius);
+            }
+        }
+
+        // No circle through two or three of the points that holds them all is smaller
+        int n = int(c.points.size());
+        if (n > 16)
+        {
+            return std::string();
+        }
+        std::vector<geometry::Circle> candidates;
+        for (int i = 0; i < n; i++)
+        {
+            for (int j = i; j < n; j++)
+            {
+                Point A = c.points[i];
+                Point B = c.points[j];
+                candidates.push_back({ (A + B) / 2.0, vecta::len(B - A) / 2.0 });
+                for (int k = j + 1; k < n; k++)
+                {
+                    Point C = c.points[k];
+                    Point AB = B - A;
+                    Point AC = C - A;
+                    double d = 2.0 * (AB ^ AC);
+                    if (geometry::Orient2D(A, B, C) != 0.0)
+                    {
+                        Point center = A + Point(AC.y * (AB * AB) - AB.y * (AC * AC), AB.x * (AC * AC) - AC.x * (AB * AB)) / d;
+                        candidates.push_back({ center, vecta::len(A - center) });
+                    }
+                }
+            }
+        }
+        for (geometry::Circle candidate : candidates)
+        {
+            if (candidate.radius < welzl.radius * (1.0 - 1e-9) - 1e-12 && isEnclosing(candidate))
+            {
+                return Format("Welzl r %.17g, (%.17g, %.17g) r %.17g is smaller", welzl.radius, candidate.center.x, candidate.center.y, candidate.radius);
+            }
+        }
+        return std::string();
+    } });
+
+    properties.push_back({ "Voronoi", [](std::mt19937_64& random, int size)
+    {
+        return Case{ GetPoints(random, size), {} };
+    }, [](const Case& c)
+    {
+        // The breakpoints are of degree four, beyond about 1e75 they overflow
+        for (Point p : c.points)
+        {
+            if (std::abs(p.x) > 1e60 || std::abs(p.y) > 1e60)
+            {
+                return false;
+            }
+        }
+        return !c.points.empty();
+    }, [](const Case& c)
+    {
+        geometry::VoronoiDiagram diagram = geometry::FortuneVoronoi(c.points);
+        int n = int(c.points.size());
+        Point min = c.points[0];
+        Point max = c.points[0];
+        for (Point p : c.points)
+        {
+            min = Point(std::min(min.x, p.x), std::min(min.y, p.y));
+            max = Point(std::max(max.x, p.x), std::max(max.y, p.y));
+        }
+        double scale = std::max({ max.x - min.x, max.y - min.y, std::abs(min.x), std::abs(min.y), std::abs(max.x), std::abs(max.y), 1e-300 });
+
+        // The cells are closed counter-clockwise loops of their own half-edges that tile the box
+        int edgeCount = int(diagram.origins.size());
+        double area = 0.0;
+        for (int i = 0; i < n; i++)
+        {
+            bool isFirst = true;
+            for (int j = 0; j < i; j++)
+            {
+                isFirst = isFirst && c.points[j] != c.points[i];
+            }
+            int first = diagram.cells[i];
+            if ((first != -1) != isFirst)
+            {
+                return Format("site %d has cell %d, first of its duplicates %d", i, first, int(isFirst));
+            }
+            if (first == -1)
+            {
+                continue;
+            }
+
+            double cellArea = 0.0;
+            int e = first;
+            int steps = 0;
+            do
+            {
+                int next = diagram.nexts[e];
+                if (diagram.sites[e] != i || next < 0 || next >= edgeCount || diagram.origins[next] != diagram.origins[e ^ 1] || ++steps > edgeCount)
+                {
+                    return Format("cell %d is not a loop at half-edge %d", i, e);
+                }
+                Point A = diagram.vertices[diagram.origins[e]];
+                Point B = diagram.vertices[diagram.origins[next]];
+                cellArea += (A ^ B) / 2.0;
+
+                // Every vertex is no nearer to another site
+                double d = vecta::len(A - c.points[i]);
+                for (Point p : c.points)
+                {
+                    if (vecta::len(A - p) < d - 1e-9 * scale)
+                    {
+                        return Format("vertex (%.17g, %.17g) of cell %d is nearer to (%.17g, %.17g)", A.x, A.y, i, p.x, p.y);
+                    }
+                }
+                e = next;
+            } while (e != first);
+            if (cellArea < -1e-9 * scale * scale)
+            {
+                return Format("cell %d is clockwise, area %.17g", i, cellArea);
+            }
+            area += cellArea;
+        }
+
+        double boxArea = 0.0;
+        for (int e = 0; e < edgeCount; e++)
+        {
+            if (diagram.sites[e ^ 1] == -1)
+            {
+                Point A = diagram.vertices[diagram.origins[e]];
+                Point B = diagram.vertices[diagram.origins[e ^ 1]];
+                boxArea += (A ^ B) / 2.0;
+            }
+        }
+        if (std::abs(area - boxArea) > 1e-9 * std::max(boxArea, scale * scale))
+        {
+            return Format("cells cover %.17g of the box %.17g", area, boxArea);
+        }
+        return std::string();
+    } });
+
+    properties.push_back({ "Overlay", [](std::mt19937_64& random, int size)
+    {
+        auto getRings = [&](int count)
+        {
+            std::vector<Point> points;
+            for (int r = 0; r < count; r++)
+            {
+                uint64_t seed = random();
+                std::vector<Point> ring;
+                switch (random() % 4)
+                {
+                case 0: ring = geometry::GetStarPolygon(size + 3, seed); break;
+                case 1: ring = geometry::GetCombPolygon(size + 3, seed); break;
+                case 2: ring = geometry::GetConvexPolygon(size + 3, seed); break;
+                default: ring = GetPoints(random, size + 3); break;
+                }
+                double scale = std::uniform_real_distribution<double>(0.25, 1.0)(random);
+                Point offset(std::uniform_real_distribution<double>(-0.5, 0.5)(random), std::uniform_real_distribution<double>(-0.5, 0.5)(random));
+                bool isGrid = random() % 2;
+                for (Point& p : ring)
+                {
+                    p = p * scale + offset;
+                    if (isGrid)
+                    {
+                        p = Point(std::round(p.x * 8.0), std::round(p.y * 8.0));
+                    }
+                }
+                if (r > 0)
+                {
+                    points.push_back(RingEnd);
+                }
+                points.insert(points.end(), ring.begin(), ring.end());
+            }
+            return points;
+        };
+        std::vector<Point> subject = getRings(1 + int(random() % 3));
+        std::vector<Point> clipping = getRings(1 + int(random() % 3));
+        if (random() % 4 == 0)
+        {
+            // Shared edges and vertices
+            clipping = subject;
+            Point shift(double(random() % 3), double(random() % 3));
+            for (Point& p : clipping)
+            {
+                p += shift;
+            }
+        }
+        return Case{ subject, clipping };
+    }, [](const Case& c)
+    {
+        return !c.points.empty() && !c.queries.empty();
+    }, [](const Case& c)
+    {
+        std::vector<std::vector<Point>> subject = GetRings(c.points);
+        std::vector<std::vector<Point>> clipping = GetRings(c.queries);
+        Point min(HUGE_VAL, HUGE_VAL);
+        Point max(-HUGE_VAL, -HUGE_VAL);
+        for (const std::vector<Point>* points : { &c.points, &c.queries })
+        {
+            for (Point p : *points)
+            {
+                if (!std::isnan(p.x))
+                {
+                    min = Point(std::min(min.x, p.x), std::min(min.y, p.y));
+                    max = Point(std::max(max.x, p.x), std::max(max.y, p.y));
+                }
+            }
+        }
+        double tolerance = 1e-9 * std::max(max.x - min.x, max.y - min.y);
+
+        std::mt19937_64 random(7);
+        std::uniform_real_distribution<double> unit(-0.1, 1.1);
+        const char* names[] = { "union", "intersection", "difference", "xor" };
+        for (int k = 0; k < 4; k++)
+        {
+            geometry::BooleanOperation operation = geometry::BooleanOperation(k);
+            std::vector<std::vector<Point>> result = geometry::Overlay(subject, clipping, operation);
+            for (const std::vector<Point>& ring : result)
+            {
+                // Splitting near-collinear edges can leave a crossing sliver of rounding width
+                bool isSliver = std::abs(GetArea(ring)) <= tolerance * std::max(max.x - min.x, max.y - min.y);
+                if (ring.size() < 3 || (!isSliver && !geometry::IsSimplePolygon(ring)))
+                {
+                    return Format("%s: ring not simple ", names[k]) + ToString(ring);
+                }
+            }
+
+            for (int q = 0; q < 64; q++)
+            {
+                Point P = min + Point(unit(random) * (max.x - min.x), unit(random) * (max.y - min.y));
+                bool isNear = false;
+                for (const std::vector<std::vector<Point>>* rings : { &subject, &clipping, &result })
+                {
+                    for (const std::vector<Point>& ring : *rings)
+                    {
+                        for (int i = 0; i < ring.size() && !isNear; i++)
+                        {
+                            isNear = GetDistance(P, ring[i], ring[(i + 1) % ring.size()]) <= tolerance;
+                        }
+                    }
+                }
+                if (isNear)
+                {
+                    continue;
+                }
+
+                bool a = GetWinding(subject, P) % 2 != 0;
+                bool b = GetWinding(clipping, P) % 2 != 0;
+                bool expected = k == 0 ? a || b : k == 1 ? a && b : k == 2 ? a && !b : a != b;
+                int winding = GetWinding(result, P);
+                if (winding != int(expected))
+                {
+                    return Format("%s: winding %d at (%.17g, %.17g), inside subject %d clipping %d\n", names[k], winding, P.x, P.y, int(a), int(b)) + ToString(result.empty() ? std::vector<Point>() : result[0]);
+                }
+            }
+        }
+        return std::string();
+    } });
+
+    // 3D points as x, y in points and z in queries
+    properties.push_back({ "Hull3D", [](std::mt19937_64& random, int size)
+    {
+        int n = size + 3;
+        std::uniform_real_distribution<double> unit(-1.0, 1.0);
+        std::uniform_int_distribution<int> small(-3, 3);
+        std::vector<Point3D> points;
+        int kind = int(random() % 6);
+        for (int i = 0; i < n; i++)
+        {
+            Point3D p(unit(random), unit(random), unit(random));
+            switch (kind)
+            {
+            case 1:
+                p = p / vecta::len(p);
+                break;
+            case 2:
+                p = Point3D(small(random), small(random), small(random));
+                break;
+            case 3:
+                // On a plane exactly, or off it by a hair
+                p = Point3D(small(random), small(random), 0.0);
+                p.z = 2.0 * p.x - 3.0 * p.y + (random() % 8 == 0 ? std::ldexp(unit(random), -40) : 0.0);
+                break;
+            case 4:
+                p = p * 1e100;
+                break;
+            case 5:
+                // Few points, repeated
+                p = Point3D(small(random) % 2, small(random) % 2, small(random) % 2);
+                break;
+            default:
+                break;
+            }
+            points.push_back(p);
+        }
+
+        Case c;
+        for (const Point3D& p : points)
+        {
+            c.points.push_back(Point(p.x, p.y));
+            c.queries.push_back(Point(p.z, 0.0));
+        }
+        return c;
+    }, [](const Case& c)
+    {
+        return c.points.size() == c.queries.size();
+    }, [](const Case& c)
+    {
+        std::vector<Point3D> points;
+        for (int i = 0; i < c.points.size(); i++)
+        {
+            points.push_back(Point3D(c.points[i].x, c.points[i].y, c.queries[i].x));
+        }
+        int n = int(points.size());
+        geometry::Hull3D hull = geometry::Quickhull3D_Barber(points, 1);
+        const std::vector<int>& triangles = hull.triangles;
+        if (hull.triangles != geometry::Quickhull3D_Barber(points, 3).triangles)
+        {
+            return std::string("the hull depends on the thread count");
+        }
+
+        if (triangles.empty())
+        {
+            // Only when every point is on one plane
+            for (int a = 0; a < n; a++)
+            {
+                for (int b = a + 1; b < n; b++)
+                {
+                    for (int d = b + 1; d < n; d++)
+                    {
+                        if (!IsCollinear3D(points[a], points[b], points[d]))
+                        {
+                            for (int q = 0; q < n; q++)
+                            {
+                                if (geometry::Orient3D(points[a], points[b], points[d], points[q]) != 0.0)
+                                {
+                                    return Format("empty hull but %d is off the plane of %d %d %d", q, a, b, d);
+                                }
+                            }
+                            return std::string();
+                        }
+                    }
+                }
+            }
+            return std::string();
+        }
+
+        std::vector<char> isVertex(n, false);
+        for (int e = 0; e < triangles.size(); e++)
+        {
+            int twin = hull.halfedges[e];
+            if (twin < 0 || twin >= triangles.size() || hull.halfedges[twin] != e
+                || triangles[twin] != triangles[geometry::NextHalfEdge(e)] || triangles[e] != triangles[geometry::NextHalfEdge(twin)])
+            {
+                return Format("half-edge %d does not match its twin", e);
+            }
+            isVertex[triangles[e]] = true;
+        }
+        int vertexCount = int(std::count(isVertex.begin(), isVertex.end(), char(true)));
+        int faceCount = int(triangles.size()) / 3;
+        if (vertexCount - int(triangles.size()) / 2 + faceCount != 2)
+        {
+            return Format("not a sphere: %d vertices, %d faces", vertexCount, faceCount);
+        }
+
+        for (int f = 0; f < faceCount; f++)
+        {
+            const Point3D& A = points[triangles[3 * f]];
+            const Point3D& B = points[triangles[3 * f + 1]];
+            const Point3D& C = points[triangles[3 * f + 2]];
+            if (IsCollinear3D(A, B, C))
+            {
+                return Format("face %d is degenerate", f);
+            }
+            for (int q = 0; q < n; q++)
+            {
+                if (geometry::Orient3D(A, B, C, points[q]) > 0.0)
+                {
+                    return Format("point %d is above face %d", q, f);
+                }
+            }
+        }
+        return std::string();
+    } });
+
+    properties.push_back({ "SvgWriter", [](std::mt19937_64& random, int size)
+    {
+        return Case{ GetPoints(random, size), {} };
+    }, [](const Case& c)
+    {
+        // Within a page, the cells of the resolution fit in 64 bits
+        return !c.points.empty() && std::all_of(c.points.begin(), c.points.end(), [](Point p)
+        {
+            return std::abs(p.x) <= 1e6 && std::abs(p.y) <= 1e6;
+        });
+    }, [](const Case& c)
+    {
+        // The same polyline and points in two styles. The level of detail drops repeats
+        // within a style, the second style draws all of it again.
+        Point min = c.points[0];
+        Point max = c.points[0];
+        for (Point p : c.points)
+        {
+            min = Point(std::min(min.x, p.x), std::min(min.y, p.y));
+            max = Point(std::max(max.x, p.x), std::max(max.y, p.y));
+        }
+        FILE* file = std::tmpfile();
+        if (!file)
+        {
+            return std::string("no temporary file");
+        }
+        {
+            geometry::SvgWriter writer(file, min, max, 0.05);
+            for (const char* colour : { "black", "red" })
+            {
+                geometry::SvgStyle style;
+                style.colour = colour;
+                writer.SetStyle(style);
+                for (int i = 0; i + 1 < c.points.size(); i++)
+                {
+                    writer.AddSegment(c.points[i], c.points[i + 1]);
+                }
+                for (Point p : c.points)
+                {
+                    writer.AddPoint(p);
+                }
+            }
+        }
+        std::string svg;
+        std::rewind(file);
+        char buffer[4096];
+        for (size_t read; (read = std::fread(buffer, 1, sizeof(buffer), file)) > 0;)
+        {
+            svg.append(buffer, read);
+        }
+        std::fclose(file);
+
+        std::vector<SvgGroup> groups = ReadSvgGroups(svg);
+        if (groups.size() != 2)
+        {
+            return Format("%d style groups instead of 2", int(groups.size()));
+        }
+        if (groups[1].segments != groups[0].segments)
+        {
+            return Format("%d segments in the first style, %d in the second", int(groups[0].segments.size()), int(groups[1].segments.size()));
+        }
+        if (groups[1].points != groups[0].points)
+        {
+            return Format("%d points in the first style, %d in the second", int(groups[0].points.size()), int(groups[1].points.size()));
+        }
+        return std::string();
+    } });
+
+    properties.push_back({ "SegmentIntersection", [](std::mt19937_64& random, int size)
+    {
+        // Segments between input points, and lines through a few shared points that are
+        // not on the grid, so that the crossings there round apart
+        std::vector<Point> points = GetPoints(random, 2 * (size / 2 + 1));
+        std::uniform_int_distribution<int> coordinate(-10, 10);
+        std::uniform_int_distribution<int> direction(-4, 4);
+        std::uniform_int_distribution<int> length(1, 3);
+        std::vector<Point> hubs;
+        for (int i = 0; i < 3; i++)
+        {
+            hubs.push_back(Point(coordinate(random) + 0.2, coordinate(random) - 0.2));
+        }
+        for (int i = 0; i <= size / 2; i++)
+        {
+            Point H = hubs[random() % hubs.size()];
+            Point D(direction(random), direction(random));
+            points.push_back(H + double(length(random)) * D);
+            points.push_back(H - double(length(random)) * D);
+        }
+        return Case{ points, {} };
+    }, [](const Case& c)
+    {
+        // Segment i goes from points[2i] to points[2i + 1]
+        return !c.points.empty() && c.points.size() % 2 == 0;
+    }, [](const Case& c)
+    {
+        std::vector<geometry::Segment> segments;
+        for (int i = 0; i + 1 < c.points.size(); i += 2)
+        {
+            segments.push_back({ c.points[i], c.points[i + 1] });
+        }
+        int n = int(segments.size());
+        std::vector<char> isReported(n * n, 0);
+        std::vector<geometry::SegmentIntersection> intersections = geometry::GetIntersections(segments);
+        for (const geometry::SegmentIntersection& intersection : intersections)
+        {
+            if (intersection.first >= intersection.second)
+            {
+                return Format("pair %d %d is not in order", intersection.first, intersection.second);
+            }
+            if (isReported[intersection.first * n + intersection.second])
+            {
+                return Format("pair %d %d is reported twice", intersection.first, intersection.second);
+            }
+            isReported[intersection.first * n + intersection.second] = 1;
+        }
+
+        for (int i = 0; i < n; i++)
+        {
+            for (int j = i + 1; j < n; j++)
+            {
+                bool isMeeting = IsMeeting(segments[i].A, segments[i].B, segments[j].A, segments[j].B);
+                if (isMeeting != bool(isReported[i * n + j]))
+                {
+                    return Format(isMeeting ? "segments %d and %d meet but are not reported" : "segments %d and %d are reported but do not meet", i, j);
+                }
+            }
+        }
+        if (geometry::GetIntersections(segments, true).empty() != intersections.empty())
+        {
+            return std::string("stopping at the first disagrees with the full sweep");
+        }
+        return std::string();
+    } });
+
+    return properties;
+}
+
+// Drops points and rounds coordinates while the case stays valid and keeps failing
+Case Shrink(const Property& property, Case c)
+{
+    auto fails = [&](const Case& candidate)
+    {
+        return property.isValid(candidate) && !property.check(candidate).empty();
+    };
+
+    bool changed = true;
+    while (changed)
+    {
+        changed = false;
+
+        for (std::vector<Point>* list : { &c.queries, &c.points })
+        {
+            // Halves first, then single points
+            for (int chunk = int(list->size()) / 2; chunk >= 1; chunk /= 2)
+            {
+                for (int i = 0; i + chunk <= list->size();)
+                {
+                    Case candidate = c;
+                    std::vector<Point>& candidateList = list == &c.points ? candidate.points : candidate.queries;
+                    candidateList.erase(candidateList.begin() + i, candidateList.begin() + i + chunk);
+                    if (fails(candidate))
+                    {
+                        c = candidate;
+                        changed = true;
+                    }
+                    else
+                    {
+                        i += chunk;
+                    }
+                }
+            }
+        }
+
+        // Fewer digits
+        for (double scale : { 1.0, 16.0, 1024.0 })
+        {
+            Case candidate = c;
+            for (std::vector<Point>* list : { &candidate.points, &candidate.queries })
+            {
+                for (Point& p : *list)
+                {
+                    p = Point(std::round(p.x * scale) / scale, std::round(p.y * scale) / scale);
+                }
+            }
+            if ((candidate.points != c.points || candidate.queries != c.queries) && fails(candidate))
+            {
+                c = candidate;
+                changed = true;
+                break;
+            }
+        }
+    }
+    return c;
+}
+
+void PrintFailure(const Property& property, const Case& c)
+{
+    printf("%s failed: %s\n", property.name, property.check(c).c_str());
+    printf("  points  (%zu): %s\n", c.points.size(), ToString(c.points).c_str());
+    if (!c.queries.empty())
+    {
+        printf("  queries (%zu): %s\n", c.queries.size(), ToString(c.queries).c_str());
+    }
+}
+
+#ifdef GEOMETRY_LIBFUZZER
+
+// clang++ -fsanitize=fuzzer: the bytes seed the generators, libFuzzer mutates the seed and the size
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size)
+{
+    static std::vector<Property> properties = GetProperties();
+    if (size < 9)
+    {
+        return 0;
+    }
+    uint64_t seed;
+    std::memcpy(&seed, data, sizeof(seed));
+    const Property& property = properties[data[8] % properties.size()];
+    std::mt19937_64 random(seed);
+    Case c = property.generate(random, 1 + int(size % 64));
+    if (property.isValid(c) && !property.check(c).empty())
+    {
+        PrintFailure(property, Shrink(property, c));
+        std::abort();
+    }
+    return 0;
+}
+
+#else
+
+int main(int argc, char** argv)
+{
+    // Fuzz [--runs=10000] [--seed=1] [--max_size=64] [--filter=text]
+    int runs = 10000;
+    uint64_t seed = 1;
+    int maxSize = 64;
+    std::string filter;
+    for (int i = 1; i < argc; i++)
+    {
+        const char* arg = argv[i];
+        if (std::strncmp(arg, "--runs=", 7) == 0)
+        {
+            runs = std::atoi(arg + 7);
+        }
+        else if (std::strncmp(arg, "--seed=", 7) == 0)
+        {
+            seed = std::strtoull(arg + 7, nullptr, 10);
+        }
+        else if (std::strncmp(arg, "--max_size=", 11) == 0)
+        {
+            maxSize = std::atoi(arg + 11);
+        }
+        else if (std::strncmp(arg, "--filter=", 9) == 0)
+        {
+            filter = arg + 9;
+        }
+        else
+        {
+            fprintf(stderr, "Unknown argument %s\n", arg);
+            return 1;
+        }
+    }
+
+    int failures = 0;
+    for (const Property& property : GetProperties())
+    {
+        if (std::string(property.name).find(filter) == std::string::npos)
+        {
+            continue;
+        }
+
+        int tested = 0;
+        for (int run = 0; run < runs; run++)
+        {
+            // Every run has its own seed so a failure can be replayed alone
+            std::mt19937_64 random(seed + run);
+            int size = 1 + int(random() % maxSize);
+            Case c = property.generate(random, size);
+            if (!property.isValid(c))
+            {
+                continue;
+            }
+            tested++;
+            if (!property.check(c).empty())
+            {
+                printf("run %d, replay with --seed=%llu --runs=1 --max_size=%d\n", run, (unsigned long long)(seed + run), maxSize);
+                PrintFailure(property, Shrink(property, c));
+                failures++;
+                break;
+            }
+        }
+        printf("%-18s %6d cases\n", property.name, tested);
+    }
+    return failures ? 1 : 0;
+}
+
+#endif
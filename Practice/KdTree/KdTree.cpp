@@ -0,0 +1,136 @@
+﻿#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "KdTree.h"
+
+using geometry::Point;
+
+std::vector<Point> GetRandomPoints(int n, uint64_t seed)
+{
+    std::mt19937_64 random(seed);
+    std::uniform_real_distribution<double> coordinate(0.0, 100.0);
+
+    std::vector<Point> points(n);
+    for (Point& p : points)
+    {
+        p = Point(coordinate(random), coordinate(random));
+    }
+    return points;
+}
+
+double GetDistanceSquared(Point a, Point b)
+{
+    return (a - b) * (a - b);
+}
+
+// Distances of the k nearest by checking every point, compared by distance since ties may pick other points
+std::vector<double> GetNearestDistancesBruteForce(const std::vector<Point>& points, Point P, int k)
+{
+    std::vector<double> distances(points.size());
+    for (int i = 0; i < points.size(); i++)
+    {
+        distances[i] = GetDistanceSquared(points[i], P);
+    }
+    k = std::min(k, int(points.size()));
+    std::partial_sort(distances.begin(), distances.begin() + k, distances.end());
+    distances.resize(k);
+    return distances;
+}
+
+double GetSeconds(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char** argv)
+{
+    // Input: point count, points, k, query point
+    // Test Case 1: 5 0 0 10 0 10 10 0 10 5 5 2 9 9
+    // Benchmark:   KdTree 10000000 1000000 8 0.05
+    if (argc > 1)
+    {
+        int n = std::atoi(argv[1]);
+        int queryCount = argc > 2 ? std::atoi(argv[2]) : 1000000;
+        int k = argc > 3 ? std::atoi(argv[3]) : 8;
+        double radius = argc > 4 ? std::atof(argv[4]) : 0.05;
+        std::vector<Point> points = GetRandomPoints(n, 42);
+        std::vector<Point> queries = GetRandomPoints(queryCount, 7);
+
+        auto start = std::chrono::steady_clock::now();
+        geometry::KdTree serialTree(points, 1);
+        double serialBuildTime = GetSeconds(start);
+
+        start = std::chrono::steady_clock::now();
+        geometry::KdTree tree(points);
+        double buildTime = GetSeconds(start);
+
+        start = std::chrono::steady_clock::now();
+        std::vector<int> nearest;
+        tree.GetNearest(queries, k, nearest);
+        double nearestTime = GetSeconds(start);
+
+        start = std::chrono::steady_clock::now();
+        std::vector<int> offsets;
+        std::vector<int> items;
+        tree.GetInRadius(queries, radius, offsets, items);
+        double radiusTime = GetSeconds(start);
+
+        // Brute force only runs a sample, it is far too slow for all of them
+        int sampleCount = std::min(queryCount, 100);
+        int count = std::min(k, n);
+        int mismatches = 0;
+        start = std::chrono::steady_clock::now();
+        for (int i = 0; i < sampleCount; i++)
+        {
+            std::vector<double> expected = GetNearestDistancesBruteForce(points, queries[i], k);
+            for (int j = 0; j < count; j++)
+            {
+                mismatches += expected[j] != GetDistanceSquared(points[nearest[i * count + j]], queries[i]);
+            }
+        }
+        double bruteForceTime = GetSeconds(start);
+
+        for (int i = 0; i < sampleCount; i++)
+        {
+            int expected = 0;
+            for (Point p : points)
+            {
+                expected += GetDistanceSquared(p, queries[i]) <= radius * radius;
+            }
+            mismatches += expected != offsets[i + 1] - offsets[i];
+        }
+
+        printf("%d points, %d queries, k = %d, radius = %g\n", n, queryCount, k, radius);
+        printf("Build:        %10.3f ms serial, %10.3f ms parallel\n", serialBuildTime * 1000.0, buildTime * 1000.0);
+        printf("Nearest:      %10.1f ns/query\n", nearestTime * 1e9 / std::max(queryCount, 1));
+        printf("In radius:    %10.1f ns/query, %.2f points/query\n", radiusTime * 1e9 / std::max(queryCount, 1), double(items.size()) / std::max(queryCount, 1));
+        printf("Brute force:  %10.1f ns/query (%d queries)\n", bruteForceTime * 1e9 / std::max(sampleCount, 1), sampleCount);
+        printf("%d mismatches against brute force\n", mismatches);
+        return 0;
+    }
+
+    int n;
+    std::cin >> n;
+
+    std::vector<Point> points(n);
+    for (Point& p : points)
+    {
+        std::cin >> p;
+    }
+
+    int k;
+    Point P;
+    std::cin >> k >> P;
+
+    geometry::KdTree tree(points);
+    for (int i : tree.GetNearest(P, k))
+    {
+        printf("[%.1lf, %.1lf] ", points[i].x, points[i].y);
+    }
+    printf("\n");
+}
@@ -0,0 +1,167 @@
+﻿#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "PolygonIndex.h"
+
+using geometry::Point;
+
+const double Pi = std::acos(-1.0);
+
+// Small star-shaped polygons scattered over a 1000 x 1000 square, neighbours overlap
+std::vector<std::vector<Point>> GetRandomPolygons(int count)
+{
+    std::mt19937_64 random(42);
+    std::uniform_real_distribution<double> coordinate(0.0, 1000.0);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+
+    double size = 1000.0 / std::sqrt(double(std::max(count, 1)));
+    std::vector<std::vector<Point>> polygons(count);
+    for (std::vector<Point>& polygon : polygons)
+    {
+        Point center(coordinate(random), coordinate(random));
+        int n = 5 + random() % 12;
+        polygon.resize(n);
+        for (int i = 0; i < n; i++)
+        {
+            double angle = 2.0 * Pi * (i + 0.5 * unit(random)) / n;
+            double radius = size * (0.3 + 0.7 * unit(random));
+            polygon[i] = center + Point(radius * std::cos(angle), radius * std::sin(angle));
+        }
+    }
+    return polygons;
+}
+
+std::vector<Point> GetRandomPoints(int count)
+{
+    std::mt19937_64 random(7);
+    std::uniform_real_distribution<double> coordinate(0.0, 1000.0);
+
+    std::vector<Point> points(count);
+    for (Point& p : points)
+    {
+        p = Point(coordinate(random), coordinate(random));
+    }
+    return points;
+}
+
+// What the index replaces: every bounding box checked for every point
+std::vector<int> GetContainingPolygonsLinear(const std::vector<std::vector<Point>>& polygons, const std::vector<geometry::Box>& boxes, Point P)
+{
+    std::vector<int> result;
+    for (int i = 0; i < polygons.size(); i++)
+    {
+        if (boxes[i].Contains(P) && geometry::GetPointLocation(polygons[i], P) != geometry::PointLocation::Outside)
+        {
+            result.push_back(i);
+        }
+    }
+    return result;
+}
+
+double GetSeconds(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char** argv)
+{
+    // Input: polygon count, every polygon as a vertex count and vertices, query count and queries
+    // Test Case 1: 2 4 0 0 10 0 10 10 0 10 3 5 5 15 5 15 20 3 5 5 12 12 20 20
+    // Benchmark:   PolygonIndex 500000 1000000
+    if (argc > 1)
+    {
+        int polygonCount = std::atoi(argv[1]);
+        int queryCount = argc > 2 ? std::atoi(argv[2]) : 1000000;
+        std::vector<std::vector<Point>> polygons = GetRandomPolygons(polygonCount);
+        std::vector<Point> queries = GetRandomPoints(queryCount);
+
+        auto start = std::chrono::steady_clock::now();
+        geometry::PolygonIndex index(polygons);
+        double buildTime = GetSeconds(start);
+
+        start = std::chrono::steady_clock::now();
+        size_t singleHits = 0;
+        for (Point P : queries)
+        {
+            singleHits += index.GetContainingPolygons(P).size();
+        }
+        double singleTime = GetSeconds(start);
+
+        start = std::chrono::steady_clock::now();
+        std::vector<int> offsets;
+        std::vector<int> items;
+        index.GetContainingPolygons(queries, offsets, items);
+        double batchTime = GetSeconds(start);
+
+        std::vector<geometry::Box> boxes(polygons.size());
+        for (int i = 0; i < polygons.size(); i++)
+        {
+            boxes[i] = geometry::GetBoundingBox(polygons[i]);
+        }
+
+        // The linear scan only runs a sample, it is far too slow for all of them
+        int sampleCount = std::min(queryCount, 1000);
+        int mismatches = 0;
+        start = std::chrono::steady_clock::now();
+        for (int i = 0; i < sampleCount; i++)
+        {
+            std::vector<int> expected = GetContainingPolygonsLinear(polygons, boxes, queries[i]);
+            std::vector<int> found(items.begin() + offsets[i], items.begin() + offsets[i + 1]);
+            std::sort(found.begin(), found.end());
+            mismatches += expected != found;
+        }
+        double linearTime = GetSeconds(start);
+
+        printf("%d polygons, %d queries, %zu hits\n", polygonCount, queryCount, items.size());
+        printf("Build:   %10.3f ms\n", buildTime * 1000.0);
+        printf("Single:  %10.1f ns/query\n", singleTime * 1e9 / std::max(queryCount, 1));
+        printf("Batch:   %10.1f ns/query\n", batchTime * 1e9 / std::max(queryCount, 1));
+        printf("Linear:  %10.1f ns/query (%d queries)\n", linearTime * 1e9 / std::max(sampleCount, 1), sampleCount);
+        printf("Single and batch hits %s, %d mismatches against the linear scan\n", singleHits == items.size() ? "agree" : "differ", mismatches);
+        return 0;
+    }
+
+    int polygonCount;
+    std::cin >> polygonCount;
+
+    std::vector<std::vector<Point>> polygons(polygonCount);
+    for (std::vector<Point>& polygon : polygons)
+    {
+        int n;
+        std::cin >> n;
+        polygon.resize(n);
+        for (Point& p : polygon)
+        {
+            std::cin >> p;
+        }
+    }
+
+    int queryCount;
+    std::cin >> queryCount;
+
+    std::vector<Point> queries(queryCount);
+    for (Point& p : queries)
+    {
+        std::cin >> p;
+    }
+
+    geometry::PolygonIndex index(polygons);
+    std::vector<int> offsets;
+    std::vector<int> items;
+    index.GetContainingPolygons(queries, offsets, items);
+    for (int i = 0; i < queryCount; i++)
+    {
+        printf("[%.1lf, %.1lf]:", queries[i].x, queries[i].y);
+        for (int j = offsets[i]; j < offsets[i + 1]; j++)
+        {
+            printf(" %d", items[j]);
+        }
+        printf("\n");
+    }
+}
@@ -0,0 +1,714 @@
+﻿#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <future>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "ConvexHull.h"
+#include "Generators.h"
+#include "MonotoneTriangulation.h"
+#include "Parallel.h"
+#include "PolygonIndex.h"
+#include "SegmentIntersection.h"
+
+using geometry::Point;
+using geometry::Triangle;
+
+// The programs in the Week folders read one input and exit, so every query pays for the
+// process and for parsing the polygons again. The server loads them once, keeps the index
+// over them and answers requests over a Unix domain socket until a Stop request comes.
+//
+// Every request is a RequestHeader and count points, every response a ResponseHeader and
+// count items, all in host byte order since both ends are on one machine:
+//   Locate       queries                  -> per query the lowest polygon containing it, -1 for none
+//   Hull         points, none for the     -> hull vertices counter-clockwise
+//                loaded point set
+//   Triangulate  a simple polygon, none   -> triangles, three points each
+//                for loaded polygon index
+//   Stop                                  -> nothing, the server exits once all requests are answered
+enum class Op : uint32_t
+{
+    Locate = 1,
+    Hull = 2,
+    Triangulate = 3,
+    Stop = 4,
+};
+
+enum class Status : uint32_t
+{
+    Ok = 0,
+    BadRequest = 1,
+    NotSimple = 2,
+};
+
+struct RequestHeader
+{
+    uint32_t op;
+    int32_t index;
+    uint32_t count;
+};
+
+struct ResponseHeader
+{
+    uint32_t status;
+    uint32_t count;
+};
+
+// No request may carry more points than this
+const uint32_t MaxCount = 1u << 24;
+
+// Locate requests waiting together are answered in one batch of up to this many queries
+const int MaxBatchQueries = 1 << 16;
+
+bool ReadAll(int socket, void* data, size_t size)
+{
+    char* bytes = static_cast<char*>(data);
+    while (size > 0)
+    {
+        ssize_t count = recv(socket, bytes, size, 0);
+        if (count < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (count <= 0)
+        {
+            return false;
+        }
+        bytes += count;
+        size -= size_t(count);
+    }
+    return true;
+}
+
+bool WriteAll(int socket, const void* data, size_t size)
+{
+    const char* bytes = static_cast<const char*>(data);
+    while (size > 0)
+    {
+        ssize_t count = send(socket, bytes, size, MSG_NOSIGNAL);
+        if (count < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (count <= 0)
+        {
+            return false;
+        }
+        bytes += count;
+        size -= size_t(count);
+    }
+    return true;
+}
+
+sockaddr_un GetAddress(const std::string& path)
+{
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    std::strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+    return address;
+}
+
+int Connect(const std::string& path)
+{
+    int socket = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un address = GetAddress(path);
+    if (socket < 0 || connect(socket, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0)
+    {
+        fprintf(stderr, "Cannot connect to %s: %s\n", path.c_str(), std::strerror(errno));
+        if (socket >= 0)
+        {
+            close(socket);
+        }
+        return -1;
+    }
+    return socket;
+}
+
+// The polygons and the points, loaded once with everything the requests need built ahead
+class Dataset
+{
+public:
+    Dataset(std::vector<std::vector<Point>> polygonsToServe, const std::vector<Point>& points)
+        : polygons(std::move(polygonsToServe)), index(polygons), hull(geometry::MonotoneChain_Andrews(points))
+    {
+        for (const std::vector<Point>& polygon : polygons)
+        {
+            bool isPolygonSimple = geometry::IsSimplePolygon(polygon);
+            isSimple.push_back(isPolygonSimple);
+            triangles.push_back(isPolygonSimple ? geometry::MonotoneTriangulation(polygon) : std::vector<Triangle>());
+        }
+    }
+
+    Dataset(const Dataset&) = delete;
+    Dataset& operator=(const Dataset&) = delete;
+
+    // The index keeps a reference to polygons, declared before it
+    std::vector<std::vector<Point>> polygons;
+    geometry::PolygonIndex index;
+    std::vector<std::vector<Triangle>> triangles;
+    std::vector<char> isSimple;
+    std::vector<Point> hull;
+};
+
+// A request read by its connection, answered by a worker
+struct Job
+{
+    RequestHeader request;
+    std::vector<Point> points;
+    ResponseHeader response;
+    std::vector<char> payload;
+    std::promise<void> done;
+};
+
+template <typename T>
+void SetPayload(Job& job, const std::vector<T>& items, uint32_t count)
+{
+    job.response = { uint32_t(Status::Ok), count };
+    job.payload.resize(items.size() * sizeof(T));
+    std::memcpy(job.payload.data(), items.data(), job.payload.size());
+}
+
+class Server
+{
+public:
+    Server(const Dataset& dataset, int threadCount)
+        : dataset(dataset), threadCount(threadCount)
+    {
+    }
+
+    int Run(const std::string& path)
+    {
+        listener = socket(AF_UNIX, SOCK_STREAM, 0);
+        sockaddr_un address = GetAddress(path);
+        unlink(path.c_str());
+        if (listener < 0 || bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || listen(listener, 64) != 0)
+        {
+            fprintf(stderr, "Cannot listen on %s: %s\n", path.c_str(), std::strerror(errno));
+            return 1;
+        }
+        printf("Listening on %s with %d workers\n", path.c_str(), threadCount);
+        fflush(stdout);
+
+        std::vector<std::thread> workers;
+        for (int i = 0; i < threadCount; i++)
+        {
+            workers.emplace_back(&Server::Work, this);
+        }
+
+        // Connections that are done are joined as new ones come, so neither their threads nor
+        // their descriptors pile up on a long running server
+        std::list<Connection> connections;
+        while (!isStopping)
+        {
+            int client = accept(listener, nullptr, nullptr);
+            for (auto connection = connections.begin(); connection != connections.end();)
+            {
+                if (connection->isFinished)
+                {
+                    connection->thread.join();
+                    connection = connections.erase(connection);
+                }
+                else
+                {
+                    ++connection;
+                }
+            }
+            if (client < 0)
+            {
+                if (errno == EINTR || errno == ECONNABORTED)
+                {
+                    continue;
+                }
+                // Out of descriptors is transient: clients closing give them back
+                if (!isStopping && (errno == EMFILE || errno == ENFILE || errno == ENOBUFS || errno == ENOMEM))
+                {
+                    fprintf(stderr, "Cannot accept: %s, retrying\n", std::strerror(errno));
+                    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+                    continue;
+                }
+                break;
+            }
+            std::lock_guard<std::mutex> lock(mutex);
+            clients.push_back(client);
+            connections.emplace_back();
+            connections.back().thread = std::thread(&Server::Serve, this, client, &connections.back().isFinished);
+        }
+
+        // Connections waiting for an answer still get it, the workers stop last
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (int client : clients)
+            {
+                shutdown(client, SHUT_RD);
+            }
+        }
+        for (Connection& connection : connections)
+        {
+            connection.thread.join();
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            isDone = true;
+        }
+        ready.notify_all();
+        for (std::thread& worker : workers)
+        {
+            worker.join();
+        }
+        close(listener);
+        unlink(path.c_str());
+        printf("Served %lld requests\n", (long long)served.load());
+        return 0;
+    }
+
+private:
+    struct Connection
+    {
+        std::thread thread;
+        std::atomic<bool> isFinished{ false };
+    };
+
+    // One thread per connection, one request at a time: read it, queue it, write the answer.
+    // The descriptor is closed here, isFinished set last.
+    void Serve(int client, std::atomic<bool>* isFinished)
+    {
+        ServeRequests(client);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            clients.erase(std::find(clients.begin(), clients.end(), client));
+            close(client);
+        }
+        *isFinished = true;
+    }
+
+    void ServeRequests(int client)
+    {
+        RequestHeader request;
+        while (ReadAll(client, &request, sizeof(request)))
+        {
+            if (request.count > MaxCount)
+            {
+                ResponseHeader response = { uint32_t(Status::BadRequest), 0 };
+                WriteAll(client, &response, sizeof(response));
+                break;
+            }
+            Job job;
+            job.request = request;
+            job.points.resize(request.count);
+            if (!ReadAll(client, job.points.data(), job.points.size() * sizeof(Point)))
+            {
+                break;
+            }
+
+            if (Op(request.op) == Op::Stop)
+            {
+                ResponseHeader response = { uint32_t(Status::Ok), 0 };
+                WriteAll(client, &response, sizeof(response));
+                Stop();
+                break;
+            }
+
+            std::future<void> done = job.done.get_future();
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                queue.push_back(&job);
+            }
+            ready.notify_one();
+            done.wait();
+            served++;
+
+            if (!WriteAll(client, &job.response, sizeof(job.response)) || !WriteAll(client, job.payload.data(), job.payload.size()))
+            {
+                break;
+            }
+        }
+    }
+
+    void Stop()
+    {
+        isStopping = true;
+        shutdown(listener, SHUT_RDWR);
+    }
+
+    // Takes the first job waiting and, for Locate, every other Locate waiting behind it
+    void Work()
+    {
+        std::vector<Job*> batch;
+        std::vector<Point> queries;
+        std::vector<int> offsets;
+        std::vector<int> items;
+        while (true)
+        {
+            batch.clear();
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                ready.wait(lock, [&] { return !queue.empty() || isDone; });
+                if (queue.empty())
+                {
+                    return;
+                }
+                batch.push_back(queue.front());
+                queue.pop_front();
+                if (Op(batch[0]->request.op) == Op::Locate)
+                {
+                    size_t queryCount = batch[0]->points.size();
+                    for (auto job = queue.begin(); job != queue.end() && queryCount < MaxBatchQueries;)
+                    {
+                        if (Op((*job)->request.op) != Op::Locate)
+                        {
+                            ++job;
+                            continue;
+                        }
+                        queryCount += (*job)->points.size();
+                        batch.push_back(*job);
+                        job = queue.erase(job);
+                    }
+                }
+            }
+
+            if (Op(batch[0]->request.op) == Op::Locate)
+            {
+                Locate(batch, queries, offsets, items);
+            }
+            else
+            {
+                Answer(*batch[0]);
+            }
+            for (Job* job : batch)
+            {
+                job->done.set_value();
+            }
+        }
+    }
+
+    // All queries of the batch in one call, the index walks them along a Hilbert curve
+    void Locate(const std::vector<Job*>& batch, std::vector<Point>& queries, std::vector<int>& offsets, std::vector<int>& items) const
+    {
+        queries.clear();
+        for (const Job* job : batch)
+        {
+            queries.insert(queries.end(), job->points.begin(), job->points.end());
+        }
+        dataset.index.GetContainingPolygons(queries, offsets, items);
+
+        int query = 0;
+        for (Job* job : batch)
+        {
+            std::vector<int32_t> polygons(job->points.size());
+            for (int32_t& polygon : polygons)
+            {
+                polygon = offsets[query] < offsets[query + 1] ? *std::min_element(items.begin() + offsets[query], items.begin() + offsets[query + 1]) : -1;
+                query++;
+            }
+            SetPayload(*job, polygons, uint32_t(polygons.size()));
+        }
+    }
+
+    void Answer(Job& job) const
+    {
+        job.response = { uint32_t(Status::BadRequest), 0 };
+        switch (Op(job.request.op))
+        {
+        case Op::Hull:
+        {
+            std::vector<Point> hull = job.points.empty() ? dataset.hull : geometry::MonotoneChain_Andrews(job.points);
+            SetPayload(job, hull, uint32_t(hull.size()));
+            break;
+        }
+        case Op::Triangulate:
+            if (!job.points.empty())
+            {
+                if (!geometry::IsSimplePolygon(job.points))
+                {
+                    job.response.status = uint32_t(Status::NotSimple);
+                    break;
+                }
+                std::vector<Triangle> triangles = geometry::MonotoneTriangulation(job.points);
+                SetPayload(job, triangles, uint32_t(triangles.size()));
+            }
+            else if (job.request.index >= 0 && job.request.index < dataset.polygons.size() && !dataset.isSimple[job.request.index])
+            {
+                job.response.status = uint32_t(Status::NotSimple);
+            }
+            else if (job.request.index >= 0 && job.request.index < dataset.polygons.size())
+            {
+                const std::vector<Triangle>& triangles = dataset.triangles[job.request.index];
+                SetPayload(job, triangles, uint32_t(triangles.size()));
+            }
+            break;
+        default:
+            break;
+        }
+    }
+
+    const Dataset& dataset;
+    int threadCount;
+    int listener = -1;
+
+    std::mutex mutex;
+    std::condition_variable ready;
+    std::deque<Job*> queue;
+    std::vector<int> clients;
+    std::atomic<bool> isStopping{ false };
+    bool isDone = false;
+    std::atomic<int64_t> served{ 0 };
+};
+
+// Polygon count, every polygon as a vertex count and vertices, the input of PolygonIndex
+bool ReadPolygons(const std::string& path, std::vector<std::vector<Point>>& polygons)
+{
+    std::ifstream file(path);
+    int count = 0;
+    file >> count;
+    polygons.resize(std::max(count, 0));
+    for (std::vector<Point>& polygon : polygons)
+    {
+        int n = 0;
+        file >> n;
+        polygon.resize(std::max(n, 0));
+        for (Point& p : polygon)
+        {
+            file >> p;
+        }
+    }
+    return bool(file);
+}
+
+// Point count and points
+bool ReadPoints(const std::string& path, std::vector<Point>& points)
+{
+    std::ifstream file(path);
+    int count = 0;
+    file >> count;
+    points.resize(std::max(count, 0));
+    for (Point& p : points)
+    {
+        file >> p;
+    }
+    return bool(file);
+}
+
+// Requests of one kind from several connections for a while, each waits for its answer
+// before sending the next. Queries and points are in [-1, 1] x [-1, 1] like the generated data.
+int RunLoad(const std::string& path, const std::string& opName, int connectionCount, int batch, double seconds, bool isStopping)
+{
+    Op op = opName == "hull" ? Op::Hull : (opName == "triangulate" ? Op::Triangulate : Op::Locate);
+    struct Connection
+    {
+        std::vector<int64_t> latencies;
+        int64_t points = 0;
+        bool isFailed = false;
+    };
+    std::vector<Connection> connections(connectionCount);
+    auto start = std::chrono::steady_clock::now();
+    auto end = start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(seconds));
+
+    std::vector<std::thread> threads;
+    for (int c = 0; c < connectionCount; c++)
+    {
+        threads.emplace_back([&, c]
+        {
+            Connection& connection = connections[c];
+            int socket = Connect(path);
+            if (socket < 0)
+            {
+                connection.isFailed = true;
+                return;
+            }
+            std::vector<char> payload;
+            for (uint64_t seed = c; std::chrono::steady_clock::now() < end; seed += connectionCount)
+            {
+                std::vector<Point> points = op == Op::Triangulate ? geometry::GetStarPolygon(std::max(batch, 3), seed)
+                    : geometry::GetRandomPoints(geometry::PointDistribution::Uniform, batch, seed);
+                RequestHeader request = { uint32_t(op), -1, uint32_t(points.size()) };
+
+                auto sent = std::chrono::steady_clock::now();
+                ResponseHeader response;
+                size_t itemSize = op == Op::Locate ? sizeof(int32_t) : (op == Op::Hull ? sizeof(Point) : sizeof(Triangle));
+                if (!WriteAll(socket, &request, sizeof(request)) || !WriteAll(socket, points.data(), points.size() * sizeof(Point))
+                    || !ReadAll(socket, &response, sizeof(response)))
+                {
+                    connection.isFailed = true;
+                    break;
+                }
+                payload.resize(response.count * itemSize);
+                if (!ReadAll(socket, payload.data(), payload.size()) || response.status != uint32_t(Status::Ok))
+                {
+                    connection.isFailed = true;
+                    break;
+                }
+                connection.latencies.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - sent).count());
+                connection.points += int64_t(points.size());
+            }
+            close(socket);
+        });
+    }
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::vector<int64_t> latencies;
+    int64_t points = 0;
+    int failed = 0;
+    for (const Connection& connection : connections)
+    {
+        latencies.insert(latencies.end(), connection.latencies.begin(), connection.latencies.end());
+        points += connection.points;
+        failed += connection.isFailed;
+    }
+    std::sort(latencies.begin(), latencies.end());
+    auto getPercentile = [&](double p) { return latencies.empty() ? 0.0 : latencies[std::min(latencies.size() - 1, size_t(p * latencies.size()))] / 1e3; };
+    printf("%s: %d connections, %d points per request, %zu requests in %.2f s\n", opName.c_str(), connectionCount, batch, latencies.size(), elapsed);
+    printf("QPS:  %12.0f requests/s, %.4g points/s\n", latencies.size() / elapsed, points / elapsed);
+    printf("p50:  %12.1f us\n", getPercentile(0.50));
+    printf("p99:  %12.1f us\n", getPercentile(0.99));
+    printf("max:  %12.1f us\n", latencies.empty() ? 0.0 : latencies.back() / 1e3);
+    if (failed > 0)
+    {
+        printf("%d connections failed\n", failed);
+    }
+
+    if (isStopping)
+    {
+        int socket = Connect(path);
+        RequestHeader request = { uint32_t(Op::Stop), -1, 0 };
+        ResponseHeader response;
+        if (socket < 0 || !WriteAll(socket, &request, sizeof(request)) || !ReadAll(socket, &response, sizeof(response)))
+        {
+            return 1;
+        }
+        close(socket);
+    }
+    return failed > 0 ? 1 : 0;
+}
+
+int main(int argc, char** argv)
+{
+    // Server:          QueryServer [--socket=/tmp/geometry.sock] [--polygons=file | --parcels=10000]
+    //                              [--points=file | --random=100000] [--threads=0]
+    // Load generator:  QueryServer --load [--socket=...] [--op=locate|hull|triangulate]
+    //                              [--connections=8] [--batch=16] [--seconds=3] [--stop]
+    // --batch=0 with hull asks for the hull of the loaded points
+    std::string path = "/tmp/geometry.sock";
+    std::string polygonsPath;
+    std::string pointsPath;
+    std::string op = "locate";
+    int parcelCount = 10000;
+    int randomCount = 100000;
+    int threadCount = 0;
+    int connectionCount = 8;
+    int batch = 16;
+    double seconds = 3.0;
+    bool isLoad = false;
+    bool isStopping = false;
+    for (int i = 1; i < argc; i++)
+    {
+        const char* arg = argv[i];
+        if (std::strncmp(arg, "--socket=", 9) == 0)
+        {
+            path = arg + 9;
+        }
+        else if (std::strncmp(arg, "--polygons=", 11) == 0)
+        {
+            polygonsPath = arg + 11;
+        }
+        else if (std::strncmp(arg, "--parcels=", 10) == 0)
+        {
+            parcelCount = std::atoi(arg + 10);
+        }
+        else if (std::strncmp(arg, "--points=", 9) == 0)
+        {
+            pointsPath = arg + 9;
+        }
+        else if (std::strncmp(arg, "--random=", 9) == 0)
+        {
+            randomCount = std::atoi(arg + 9);
+        }
+        else if (std::strncmp(arg, "--threads=", 10) == 0)
+        {
+            threadCount = std::atoi(arg + 10);
+        }
+        else if (std::strcmp(arg, "--load") == 0)
+        {
+            isLoad = true;
+        }
+        else if (std::strncmp(arg, "--op=", 5) == 0)
+        {
+            op = arg + 5;
+        }
+        else if (std::strncmp(arg, "--connections=", 14) == 0)
+        {
+            connectionCount = std::max(1, std::atoi(arg + 14));
+        }
+        else if (std::strncmp(arg, "--batch=", 8) == 0)
+        {
+            batch = std::max(0, std::atoi(arg + 8));
+        }
+        else if (std::strncmp(arg, "--seconds=", 10) == 0)
+        {
+            seconds = std::atof(arg + 10);
+        }
+        else if (std::strcmp(arg, "--stop") == 0)
+        {
+            isStopping = true;
+        }
+        else
+        {
+            fprintf(stderr, "Unknown argument %s\n", arg);
+            return 1;
+        }
+    }
+
+    if (isLoad)
+    {
+        return RunLoad(path, op, connectionCount, batch, seconds, isStopping);
+    }
+
+    std::vector<std::vector<Point>> polygons;
+    if (polygonsPath.empty())
+    {
+        polygons = geometry::GetParcels(parcelCount, 0.2, 42);
+    }
+    else if (!ReadPolygons(polygonsPath, polygons))
+    {
+        fprintf(stderr, "Cannot read polygons from %s\n", polygonsPath.c_str());
+        return 1;
+    }
+    std::vector<Point> points;
+    if (pointsPath.empty())
+    {
+        points = geometry::GetRandomPoints(geometry::PointDistribution::Uniform, randomCount, 42);
+    }
+    else if (!ReadPoints(pointsPath, points))
+    {
+        fprintf(stderr, "Cannot read points from %s\n", pointsPath.c_str());
+        return 1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    Dataset dataset(std::move(polygons), points);
+    printf("%zu polygons and %zu points prepared in %.3f s\n", dataset.polygons.size(), points.size(),
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+
+    Server server(dataset, geometry::GetThreadCount(threadCount));
+    return server.Run(path);
+}
@@ -0,0 +1,144 @@
+﻿#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "SegmentIntersection.h"
+
+using geometry::Point;
+using geometry::Segment;
+
+const double Pi = std::acos(-1.0);
+
+// Simple by construction: one vertex per sorted angle
+std::vector<Point> GetRandomStarPolygon(int n)
+{
+    std::mt19937_64 random(42);
+    std::uniform_real_distribution<double> angle(0.0, 2.0 * Pi);
+    std::uniform_real_distribution<double> radius(10.0, 100.0);
+
+    std::vector<double> angles(n);
+    for (double& a : angles)
+    {
+        a = angle(random);
+    }
+    std::sort(angles.begin(), angles.end());
+
+    std::vector<Point> polygon(n);
+    for (int i = 0; i < n; i++)
+    {
+        double r = radius(random);
+        polygon[i] = Point(r * std::cos(angles[i]), r * std::sin(angles[i]));
+    }
+    return polygon;
+}
+
+std::vector<Segment> GetRandomSegments(int n, double length)
+{
+    std::mt19937_64 random(7);
+    std::uniform_real_distribution<double> coordinate(0.0, 100.0);
+    std::uniform_real_distribution<double> offset(-length, length);
+
+    std::vector<Segment> segments(n);
+    for (Segment& s : segments)
+    {
+        s.A = Point(coordinate(random), coordinate(random));
+        s.B = s.A + Point(offset(random), offset(random));
+    }
+    return segments;
+}
+
+bool IsIntersecting(const Segment& s, const Segment& t)
+{
+    auto sign = [](double value) { return (value > 0.0) - (value < 0.0); };
+    auto isOn = [](Point A, Point B, Point P)
+    {
+        return std::min(A.x, B.x) <= P.x && P.x <= std::max(A.x, B.x) && std::min(A.y, B.y) <= P.y && P.y <= std::max(A.y, B.y);
+    };
+
+    int abc = sign(geometry::Orient2D(s.A, s.B, t.A));
+    int abd = sign(geometry::Orient2D(s.A, s.B, t.B));
+    int cda = sign(geometry::Orient2D(t.A, t.B, s.A));
+    int cdb = sign(geometry::Orient2D(t.A, t.B, s.B));
+    if (abc * abd < 0 && cda * cdb < 0)
+    {
+        return true;
+    }
+    return (abc == 0 && isOn(s.A, s.B, t.A)) || (abd == 0 && isOn(s.A, s.B, t.B)) || (cda == 0 && isOn(t.A, t.B, s.A)) || (cdb == 0 && isOn(t.A, t.B, s.B));
+}
+
+// What the sweep replaces: every pair of segments
+int CountIntersectionsBruteForce(const std::vector<Segment>& segments)
+{
+    int count = 0;
+    for (int i = 0; i < segments.size(); i++)
+    {
+        for (int j = i + 1; j < segments.size(); j++)
+        {
+            count += IsIntersecting(segments[i], segments[j]);
+        }
+    }
+    return count;
+}
+
+double GetSeconds(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char** argv)
+{
+    // Test Case Simple:    4 0 0 10 0 10 10 0 10
+    // Test Case Bow tie:   4 0 0 10 10 10 0 0 10
+    // Test Case Touching:  6 0 0 10 0 10 10 5 0 0 10 -5 5
+    // Benchmark:           SegmentIntersection 100000
+    if (argc > 1)
+    {
+        int n = std::atoi(argv[1]);
+        std::vector<Point> polygon = GetRandomStarPolygon(n);
+
+        auto start = std::chrono::steady_clock::now();
+        bool isSimple = geometry::IsSimplePolygon(polygon);
+        double simpleTime = GetSeconds(start);
+        printf("Star polygon, %d vertices: %s in %.3f ms\n", n, isSimple ? "simple" : "not simple", simpleTime * 1000.0);
+
+        // The brute force is quadratic, both run on a smaller set of random segments
+        int segmentCount = std::min(n, 20000);
+        std::vector<Segment> segments = GetRandomSegments(segmentCount, 2.0);
+
+        start = std::chrono::steady_clock::now();
+        std::vector<geometry::SegmentIntersection> intersections = geometry::GetIntersections(segments);
+        double sweepTime = GetSeconds(start);
+
+        start = std::chrono::steady_clock::now();
+        int expected = CountIntersectionsBruteForce(segments);
+        double bruteForceTime = GetSeconds(start);
+
+        printf("%d random segments, %zu intersections: sweep %.3f ms, brute force %.3f ms (%d intersections)\n",
+            segmentCount, intersections.size(), sweepTime * 1000.0, bruteForceTime * 1000.0, expected);
+        return 0;
+    }
+
+    int n;
+    std::cin >> n;
+
+    std::vector<Point> polygon(n);
+    for (Point& p : polygon)
+    {
+        std::cin >> p;
+    }
+
+    std::vector<geometry::SegmentIntersection> intersections = geometry::GetSelfIntersections(polygon);
+    if (intersections.empty())
+    {
+        printf("Simple\n");
+    }
+    for (const geometry::SegmentIntersection& intersection : intersections)
+    {
+        printf("Edges %d and %d meet at (%.2f, %.2f)\n", intersection.first, intersection.second, intersection.P.x, intersection.P.y);
+    }
+}
@@ -0,0 +1,539 @@
+﻿#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "SvgWriter.h"
+
+using geometry::Point;
+using geometry::SvgStyle;
+
+// Renders the SP drawing language to SVG, the same input sp.exe takes:
+//   unit 5          scale, millimetres per unit
+//   move 8 230      origin on the page, in millimetres
+//   rotate 30       degrees, counter-clockwise
+//   colour 1 0 0    red, green and blue in [0, 1], or an SVG colour name
+//   width 1         in points
+//   linetype 2 1    dashes in millimetres, none for a solid line
+//   cap round       butt, round, square or 0, 1, 2
+//   join round      miter, round, bevel or 0, 1, 2
+// followed by data lines for
+//   lines           x1 y1 x2 y2
+//   lines>          x1 y1 x2 y2, arrow head at the end
+//   lines<>         x1 y1 x2 y2, heads at both ends
+//   points          x y
+//   polygon         x y per line, a blank line or a command ends it
+//   polygon*        filled
+//   circles         x y r
+//   circles*        filled
+// Anything after the numbers of a line is a comment, and so are lines that start with "-".
+
+const double Pi = std::acos(-1.0);
+
+enum class Kind
+{
+    Lines,
+    Arrows,
+    DoubleArrows,
+    Points,
+    Polygon,
+    FilledPolygon,
+    Circles,
+    FilledCircles,
+};
+
+struct Command
+{
+    const char* name;
+    Kind kind;
+    int count;
+};
+
+const Command Commands[] = {
+    { "lines", Kind::Lines, 4 },
+    { "lines>", Kind::Arrows, 4 },
+    { "lines<>", Kind::DoubleArrows, 4 },
+    { "points", Kind::Points, 2 },
+    { "polygon", Kind::Polygon, 2 },
+    { "polygon*", Kind::FilledPolygon, 2 },
+    { "circles", Kind::Circles, 3 },
+    { "circles*", Kind::FilledCircles, 3 },
+};
+
+// The input is read in chunks of this size, a longer line grows the buffer
+const size_t ChunkSize = 1 << 16;
+
+bool IsSpace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+const char* SkipSpaces(const char* p, const char* end)
+{
+    while (p < end && IsSpace(*p))
+    {
+        p++;
+    }
+    return p;
+}
+
+// Numbers from the start of the text up to the first thing that is not one, at most count
+int ReadNumbers(const char* p, const char* end, double* numbers, int count)
+{
+    int read = 0;
+    while (read < count)
+    {
+        p = SkipSpaces(p, end);
+        std::from_chars_result result = std::from_chars(p, end, numbers[read]);
+        if (result.ec != std::errc() || (result.ptr < end && !IsSpace(*result.ptr)))
+        {
+            break;
+        }
+        p = result.ptr;
+        read++;
+    }
+    return read;
+}
+
+std::string ReadWord(const char*& p, const char* end)
+{
+    p = SkipSpaces(p, end);
+    const char* begin = p;
+    while (p < end && !IsSpace(*p))
+    {
+        p++;
+    }
+    return std::string(begin, p);
+}
+
+// Reads the input a chunk at a time and hands every element to the writer as soon as its
+// line is read, only an open polygon is kept. Without a writer only the bounds are taken:
+// the page size goes first and depends on everything that is drawn.
+class Parser
+{
+public:
+    explicit Parser(geometry::SvgWriter* writer)
+        : writer(writer)
+    {
+    }
+
+    // False with a message on stderr when a line is not understood or the file is not read
+    bool Parse(FILE* file)
+    {
+        std::vector<char> buffer(ChunkSize);
+        size_t size = 0;
+        int lineNumber = 0;
+        bool isEnd = false;
+        while (!isEnd)
+        {
+            if (size == buffer.size())
+            {
+                buffer.resize(2 * buffer.size());
+            }
+            size_t read = std::fread(buffer.data() + size, 1, buffer.size() - size, file);
+            if (read == 0 && std::ferror(file))
+            {
+                fprintf(stderr, "Cannot read the input\n");
+                return false;
+            }
+            isEnd = read == 0;
+            size += read;
+
+            const char* p = buffer.data();
+            const char* end = p + size;
+            while (p < end)
+            {
+                const char* lineEnd = static_cast<const char*>(std::memchr(p, '\n', end - p));
+                if (lineEnd == nullptr)
+                {
+                    // The rest of the line comes with the next chunk
+                    if (!isEnd)
+                    {
+                        break;
+                    }
+                    lineEnd = end;
+                }
+                lineNumber++;
+                // A UTF-8 byte order mark
+                if (lineNumber == 1 && lineEnd - p >= 3 && std::memcmp(p, "\xef\xbb\xbf", 3) == 0)
+                {
+                    p += 3;
+                }
+                if (!ParseLine(SkipSpaces(p, lineEnd), lineEnd, lineNumber))
+                {
+                    return false;
+                }
+                p = lineEnd + 1;
+            }
+            size = p < end ? end - p : 0;
+            std::memmove(buffer.data(), p, size);
+        }
+        EndItem();
+        return true;
+    }
+
+    Point GetMin() const
+    {
+        return min;
+    }
+
+    Point GetMax() const
+    {
+        return max;
+    }
+
+    int64_t GetItemCount() const
+    {
+        return itemCount;
+    }
+
+    int64_t GetValueCount() const
+    {
+        return valueCount;
+    }
+
+private:
+    bool ParseLine(const char* p, const char* end, int lineNumber)
+    {
+        if (p == end)
+        {
+            // A blank line ends a polygon
+            EndItem();
+            return true;
+        }
+
+        double numbers[4];
+        if (ReadNumbers(p, end, numbers, 1) == 1)
+        {
+            if (command == nullptr)
+            {
+                fprintf(stderr, "Line %d: data before lines, points, polygon or circles\n", lineNumber);
+                return false;
+            }
+            int count = command->count;
+            int read = ReadNumbers(p, end, numbers, count);
+            if (read < count)
+            {
+                fprintf(stderr, "Line %d: %s takes %d numbers per line, found %d\n", lineNumber, command->name, count, read);
+                return false;
+            }
+            AddData(numbers);
+            return true;
+        }
+
+        const char* word = p;
+        std::string name = ReadWord(p, end);
+        if (name[0] == '-' || name[0] == '#')
+        {
+            return true;
+        }
+
+        for (const Command& c : Commands)
+        {
+            if (name == c.name)
+            {
+                EndItem();
+                command = &c;
+                return true;
+            }
+        }
+
+        int read = ReadNumbers(p, end, numbers, 3);
+        if (name == "unit" && read >= 1)
+        {
+            unit = numbers[0];
+        }
+        else if (name == "move" && read >= 2)
+        {
+            move = Point(numbers[0], numbers[1]);
+        }
+        else if (name == "rotate" && read >= 1)
+        {
+            angle = numbers[0] * Pi / 180.0;
+        }
+        else if (name == "width" && read >= 1)
+        {
+            EndItem();
+            style.width = numbers[0];
+            isStyleChanged = true;
+        }
+        else if ((name == "colour" || name == "color") && read == 3)
+        {
+            EndItem();
+            char rgb[64];
+            snprintf(rgb, sizeof(rgb), "rgb(%d,%d,%d)", GetChannel(numbers[0]), GetChannel(numbers[1]), GetChannel(numbers[2]));
+            style.colour = rgb;
+            isStyleChanged = true;
+        }
+        else if ((name == "colour" || name == "color") && read == 0)
+        {
+            EndItem();
+            style.colour = ReadWord(p, end);
+            isStyleChanged = true;
+        }
+        else if (name == "linetype")
+        {
+            EndItem();
+            style.dashes.clear();
+            double dash;
+            const char* q = p;
+            while (ReadNumbers(q, end, &dash, 1) == 1 && dash > 0.0)
+            {
+                style.dashes.push_back(dash);
+                ReadWord(q, end);
+            }
+            isStyleChanged = true;
+        }
+        else if (name == "cap")
+        {
+            EndItem();
+            const char* caps[] = { "butt", "round", "square" };
+            style.cap = read >= 1 ? caps[std::abs(int(numbers[0])) % 3] : ReadWord(p, end);
+            isStyleChanged = true;
+        }
+        else if (name == "join")
+        {
+            EndItem();
+            const char* joins[] = { "miter", "round", "bevel" };
+            style.join = read >= 1 ? joins[std::abs(int(numbers[0])) % 3] : ReadWord(p, end);
+            isStyleChanged = true;
+        }
+        else
+        {
+            fprintf(stderr, "Line %d: unknown command or missing values: %.*s\n", lineNumber, int(end - word), word);
+            return false;
+        }
+        return true;
+    }
+
+    static int GetChannel(double value)
+    {
+        return int(std::lround(std::min(1.0, std::max(0.0, value)) * 255.0));
+    }
+
+    Point ToPage(double x, double y) const
+    {
+        return move + unit * (Point(x, y) & angle);
+    }
+
+    void Include(Point P, double radius)
+    {
+        min.x = std::min(min.x, P.x - radius);
+        min.y = std::min(min.y, P.y - radius);
+        max.x = std::max(max.x, P.x + radius);
+        max.y = std::max(max.y, P.y + radius);
+    }
+
+    void AddData(const double* numbers)
+    {
+        Kind kind = command->kind;
+        if (!isItemOpen)
+        {
+            itemCount++;
+            isItemOpen = true;
+        }
+
+        Point A = ToPage(numbers[0], numbers[1]);
+        bool isCircle = kind == Kind::Circles || kind == Kind::FilledCircles;
+        double radius = isCircle ? std::abs(unit * numbers[2]) : 0.0;
+        Include(A, radius);
+        valueCount += isCircle ? 3 : 2;
+        Point B = A;
+        if (kind == Kind::Lines || kind == Kind::Arrows || kind == Kind::DoubleArrows)
+        {
+            B = ToPage(numbers[2], numbers[3]);
+            Include(B, 0.0);
+            valueCount += 2;
+        }
+        if (writer == nullptr)
+        {
+            return;
+        }
+
+        // Styles that no element uses are left out
+        if (isStyleChanged)
+        {
+            writer->SetStyle(style);
+            isStyleChanged = false;
+        }
+        switch (kind)
+        {
+        case Kind::Lines:
+            writer->AddSegment(A, B);
+            break;
+        case Kind::Arrows:
+        case Kind::DoubleArrows:
+            writer->AddArrow(A, B, kind == Kind::DoubleArrows);
+            break;
+        case Kind::Points:
+            writer->AddPoint(A);
+            break;
+        case Kind::Polygon:
+        case Kind::FilledPolygon:
+            polygon.push_back(A);
+            break;
+        case Kind::Circles:
+        case Kind::FilledCircles:
+            writer->AddCircle(A, radius, kind == Kind::FilledCircles);
+            break;
+        }
+    }
+
+    // A polygon is written once it is complete, in the style it began with
+    void EndItem()
+    {
+        if (writer != nullptr && !polygon.empty())
+        {
+            writer->AddPolygon(polygon, command->kind == Kind::FilledPolygon);
+            polygon.clear();
+        }
+        isItemOpen = false;
+    }
+
+    geometry::SvgWriter* writer;
+    SvgStyle style;
+    bool isStyleChanged = false;
+    const Command* command = nullptr;
+    bool isItemOpen = false;
+    std::vector<Point> polygon;
+
+    double unit = 1.0;
+    Point move = Point(0.0, 0.0);
+    double angle = 0.0;
+
+    Point min = Point(HUGE_VAL, HUGE_VAL);
+    Point max = Point(-HUGE_VAL, -HUGE_VAL);
+    int64_t itemCount = 0;
+    int64_t valueCount = 0;
+};
+
+// Copies a pipe to a temporary file, so that it can be read twice
+FILE* Spool(FILE* input)
+{
+    FILE* file = std::tmpfile();
+    if (file == nullptr)
+    {
+        return nullptr;
+    }
+    std::vector<char> chunk(ChunkSize);
+    size_t read;
+    while ((read = std::fread(chunk.data(), 1, chunk.size(), input)) > 0)
+    {
+        if (std::fwrite(chunk.data(), 1, read, file) != read)
+        {
+            break;
+        }
+    }
+    if (std::ferror(input) || std::ferror(file) || std::fseek(file, 0, SEEK_SET) != 0)
+    {
+        std::fclose(file);
+        return nullptr;
+    }
+    return file;
+}
+
+int main(int argc, char** argv)
+{
+    // SvgRender [svg] [--input=file] [--output=file] [--resolution=0.05] [--stats]
+    // The resolution is in millimetres on the page, 0 writes everything as it is
+    const char* inputName = nullptr;
+    const char* outputName = nullptr;
+    double resolution = 0.05;
+    bool printStats = false;
+    for (int i = 1; i < argc; i++)
+    {
+        const char* arg = argv[i];
+        if (std::strcmp(arg, "svg") == 0)
+        {
+            // The sp.exe mode, the only one there is
+        }
+        else if (std::strncmp(arg, "--input=", 8) == 0)
+        {
+            inputName = arg + 8;
+        }
+        else if (std::strncmp(arg, "--output=", 9) == 0)
+        {
+            outputName = arg + 9;
+        }
+        else if (std::strncmp(arg, "--resolution=", 13) == 0)
+        {
+            resolution = std::atof(arg + 13);
+        }
+        else if (std::strcmp(arg, "--stats") == 0)
+        {
+            printStats = true;
+        }
+        else
+        {
+            fprintf(stderr, "Unknown argument %s, only svg output is supported\n", arg);
+            return 1;
+        }
+    }
+
+    FILE* input = inputName ? std::fopen(inputName, "rb") : stdin;
+    if (input == nullptr)
+    {
+        fprintf(stderr, "Cannot open %s\n", inputName);
+        return 1;
+    }
+    // Read twice, for the bounds and then to write it out. A pipe goes to a temporary file
+    // first, the drawing itself is never held in memory.
+    FILE* source = input;
+    long start = std::ftell(input);
+    if (start < 0)
+    {
+        source = Spool(input);
+        start = 0;
+    }
+    Parser bounds(nullptr);
+    bool isParsed = source != nullptr && bounds.Parse(source) && std::fseek(source, start, SEEK_SET) == 0;
+    if (source == nullptr || !isParsed)
+    {
+        if (source == nullptr)
+        {
+            fprintf(stderr, "Cannot read the input\n");
+        }
+        else if (source != input)
+        {
+            std::fclose(source);
+        }
+        if (inputName)
+        {
+            std::fclose(input);
+        }
+        return 1;
+    }
+
+    FILE* output = outputName ? std::fopen(outputName, "wb") : stdout;
+    if (output == nullptr)
+    {
+        fprintf(stderr, "Cannot create %s\n", outputName);
+        return 1;
+    }
+    geometry::SvgWriter writer(output, bounds.GetMin(), bounds.GetMax(), resolution);
+    Parser parser(&writer);
+    isParsed = parser.Parse(source);
+    writer.Finish();
+    if (printStats)
+    {
+        fprintf(stderr, "%lld items, %lld values, %lld dropped\n", (long long)parser.GetItemCount(), (long long)parser.GetValueCount(), (long long)writer.GetDroppedCount());
+    }
+    if (source != input)
+    {
+        std::fclose(source);
+    }
+    if (inputName)
+    {
+        std::fclose(input);
+    }
+    if (outputName)
+    {
+        std::fclose(output);
+    }
+    return isParsed ? 0 : 1;
+}
@@ -0,0 +1,3 @@
+#!/bin/sh
+# SvgRender comes from the CMake build, set SVG_RENDER when it is not in ../build
+"${SVG_RENDER:-../build/SvgRender}" svg <Input.txt >result.svg
@@ -1,23 +1,25 @@
 ﻿#include <iostream>
-#include "vecta.h"
 
-typedef vecta::vec2d<double> Point;
+#include "Geometry.h"
+#include "Output.h"
 
-template <typename T>
-T GetAreaFromPoints(vecta::vec2d<T> a, vecta::vec2d<T> b, vecta::vec2d<T> p)
-{
-	vecta::vec2d<double> AB = b - a;
-	vecta::vec2d<double> AP = p - a;
-	return AB ^ AP;
-}
+using geometry::Point;
+using geometry::GetAreaFromPoints;
 
 /// TestCase Line    1: 0 0 10 0 5 5 2.5 2.5
 /// TestCase Inside  2: 0 0 10 0 5 5 5 2.5
 /// TestCase Outside 3: 0 0 10 0 5 5 0 1
 /// TestCase Outside 4: 0 0 10 0 5 5 5 -1
 /// TestCase Edge    5: 0 0 10 0 5 5 0 0
-int main()
+int main(int argc, char** argv)
 {
+	geometry::OutputFormat format;
+	if (!geometry::ParseOutputFormat(argc, argv, format))
+	{
+		return 1;
+	}
+	geometry::Output output(stdout, format);
+
 	Point A, B, C, P;
 	std::cin >> A >> B >> C >> P;
 
@@ -25,13 +27,16 @@ int main()
 	double BCP = GetAreaFromPoints(B, C, P);
 	double CAP = GetAreaFromPoints(C, A, P);
 
-	std::cout << "Area ABP:" << ABP << "\n"
-	          << "Area BCP:" << BCP << "\n"
-	          << "Area CAP:" << CAP << "\n";
+	output << "Area ABP:";
+	output.Write(ABP);
+	output << "Area BCP:";
+	output.Write(BCP);
+	output << "Area CAP:";
+	output.Write(CAP);
 
 	if ((ABP > 0 && BCP > 0 && CAP > 0) || (ABP < 0 && BCP < 0 && CAP < 0))
 	{
-		std::cout << "Point is inside triangle\n";
+		output << "Point is inside triangle\n";
 	}
 	else
 	{
@@ -42,15 +47,15 @@ int main()
 
 		if (zeros == 2)
 		{
-			std::cout << "Point is at edge\n";
+			output << "Point is at edge\n";
 		}
 		else if (zeros == 1)
 		{
-			std::cout << "Point is at a line\n";
+			output << "Point is at a line\n";
 		}
 		else
 		{
-			std::cout << "Point is outside triangle\n";
+			output << "Point is outside triangle\n";
 		}
 	}
 }
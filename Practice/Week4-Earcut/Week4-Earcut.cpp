@@ -1,63 +1,22 @@
 ﻿#include <iostream>
 #include <vector>
 
-#include "vecta.h"
+#include "Earcut.h"
+#include "Output.h"
+#include "SegmentIntersection.h"
 
-typedef vecta::vec2d<double> Point;
+using geometry::Point;
+using geometry::Triangle;
 
-struct Triangle
+int main(int argc, char** argv)
 {
-	Point A;
-	Point B;
-	Point C;
-};
-
-template <typename T>
-T GetAreaFromPoints(vecta::vec2d<T> a, vecta::vec2d<T> b, vecta::vec2d<T> p)
-{
-	vecta::vec2d<T> AB = b - a;
-	vecta::vec2d<T> AP = p - a;
-	return AB ^ AP;
-}
-
-std::vector<Triangle> Earcut(std::vector<Point> polygon)
-{
-	int orientation = 0;
-	for (int i = 0; i < polygon.size(); i++)
-	{
-		Point a = polygon[i];
-		Point b = polygon[(i + 1) % polygon.size()];
-		orientation += (a.x * b.y) - (a.y * b.x);
-	}
-
-	//std::cout << orientation;
-
-	std::vector<Triangle> triangles;
-	int i = 1;
-	while (polygon.size() > 3)
+	geometry::OutputFormat format;
+	if (!geometry::ParseOutputFormat(argc, argv, format))
 	{
-		Point A = polygon[i ? i - 1 : polygon.size() - 1];
-		Point B = polygon[i];
-		Point C = polygon[(i + 1) % polygon.size()];
-		bool isEar = GetAreaFromPoints(A, B, C) * orientation > 0;
-
-		if (isEar)
-		{
-			triangles.push_back({ A, B, C });
-			polygon.erase(polygon.begin() + i);
-			i = 0;
-		}
-		else
-		{
-			i++;
-		}
+		return 1;
 	}
-	triangles.push_back({ polygon[2], polygon[0], polygon[1] });
-	return triangles;
-}
+	geometry::Output output(stdout, format);
 
-int main()
-{
 	// Test Case 1: 4 0 0 10 0 10 10 0 10
 	// Test Case 2: 5 0 0 10 0 10 10 15 15 0 15
 	int n;
@@ -69,26 +28,15 @@ int main()
 		std::cin >> p;
 	}
 
-	std::vector<Triangle> triangles = Earcut(polygon);
-	for (int i = 0; i < triangles.size(); i++)
+	std::vector<geometry::SegmentIntersection> intersections = geometry::GetSelfIntersections(polygon, true);
+	if (!intersections.empty())
 	{
-		const Triangle& tri = triangles[i];
-		Point A = tri.A;
-		Point B = tri.B;
-		Point C = tri.C;
-		printf("Triangle %d: A(%.2f, %.2f) B(%.2f, %.2f) C(%.2f, %.2f)\n", i, A.x, A.y, B.x, B.y, C.x, C.y);
+		const geometry::SegmentIntersection& first = intersections[0];
+		fprintf(stderr, "Not a simple polygon: edges %d and %d meet at (%.2f, %.2f)\n", first.first, first.second, first.P.x, first.P.y);
+		return 1;
 	}
 
-	// SP
-	printf("\n");
-	for (int i = 0; i < triangles.size(); i++)
-	{
-		const Triangle& tri = triangles[i];
-		Point A = tri.A;
-		Point B = tri.B;
-		Point C = tri.C;
-		printf("%.1f %.1f %.1f %.1f\n", A.x, A.y, B.x, B.y);
-		printf("%.1f %.1f %.1f %.1f\n", B.x, B.y, C.x, C.y);
-		printf("%.1f %.1f %.1f %.1f\n", C.x, C.y, A.x, A.y);
-	}
+	std::vector<Triangle> triangles = geometry::Earcut(polygon);
+	// --format=sp draws them, pipe it into SvgRender
+	output.Write(triangles);
 }
@@ -0,0 +1,353 @@
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <set>
+#include <thread>
+
+#include "ClosestPair.h"
+#include "Delaunay.h"
+#include "Parallel.h"
+
+namespace geometry
+{
+    namespace
+    {
+        const int ParallelBatch = 1 << 15;
+        const int BruteForceSize = 8;
+
+        double GetDistance2(Point A, Point B)
+        {
+            double dx = A.x - B.x;
+            double dy = A.y - B.y;
+            return dx * dx + dy * dy;
+        }
+
+        // Sorted points i < j. Of equally near pairs the first by i then j wins, so that every
+        // way of finding the pairs gives the same one.
+        struct Candidate
+        {
+            double distance2;
+            int i;
+            int j;
+
+            bool IsBetter(const Candidate& other) const
+            {
+                if (distance2 != other.distance2)
+                {
+                    return distance2 < other.distance2;
+                }
+                return i < other.i || (i == other.i && j < other.j);
+            }
+        };
+
+        void Consider(const std::vector<Point>& points, int i, int j, Candidate& best)
+        {
+            Candidate candidate = { GetDistance2(points[i], points[j]), std::min(i, j), std::max(i, j) };
+            if (candidate.IsBetter(best))
+            {
+                best = candidate;
+            }
+        }
+
+        struct CompareByY
+        {
+            const std::vector<Point>* points;
+
+            bool operator()(int a, int b) const
+            {
+                double ay = (*points)[a].y;
+                double by = (*points)[b].y;
+                return ay < by || (ay == by && a < b);
+            }
+        };
+
+        // Calls visit(i, j) for the sorted points i < j with dx^2 <= reach2 and dy^2 <= reach2
+        // as the sweep reaches j, visit may shrink reach2. The squares never round below
+        // dx^2 + dy^2, so no pair within reach2 is missed.
+        template <typename Visit>
+        void SweepNearPairs(const std::vector<Point>& points, double& reach2, Visit visit)
+        {
+            std::set<int, CompareByY> active(CompareByY{ &points });
+            int left = 0;
+            for (int j = 0; j < points.size(); j++)
+            {
+                Point P = points[j];
+                for (; left < j; left++)
+                {
+                    double dx = P.x - points[left].x;
+                    if (dx * dx <= reach2)
+                    {
+                        break;
+                    }
+                    active.erase(left);
+                }
+
+                std::set<int, CompareByY>::iterator position = active.insert(j).first;
+                for (std::set<int, CompareByY>::iterator i = position; i != active.begin();)
+                {
+                    --i;
+                    double dy = P.y - points[*i].y;
+                    if (dy * dy > reach2)
+                    {
+                        break;
+                    }
+                    visit(*i, j);
+                }
+                for (std::set<int, CompareByY>::iterator i = std::next(position); i != active.end(); ++i)
+                {
+                    double dy = points[*i].y - P.y;
+                    if (dy * dy > reach2)
+                    {
+                        break;
+                    }
+                    visit(*i, j);
+                }
+            }
+        }
+
+        // A point of the strip around a split, copied so that sorting it by y reads no further
+        struct Item
+        {
+            Point P;
+            int index;
+        };
+
+        bool IsBelow(const Item& a, const Item& b)
+        {
+            return a.P.y < b.P.y || (a.P.y == b.P.y && a.index < b.index);
+        }
+
+        // The best of bound and the pairs of the sorted points [begin, end). On one thread the
+        // left half's best bounds the right half, which narrows its strips. The strip around the
+        // split is a range of the points, only it is sorted by y.
+        Candidate Solve(const std::vector<Point>& points, int begin, int end, Candidate bound, int parallelDepth, std::vector<Item>& strip)
+        {
+            Candidate best = bound;
+            if (end - begin <= BruteForceSize)
+            {
+                for (int i = begin; i < end; i++)
+                {
+                    for (int j = i + 1; j < end; j++)
+                    {
+                        Consider(points, i, j, best);
+                    }
+                }
+                return best;
+            }
+
+            int mid = (begin + end) / 2;
+            if (parallelDepth > 0 && end - begin >= ParallelBatch)
+            {
+                Candidate left;
+                std::thread thread([&]()
+                {
+                    std::vector<Item> leftStrip;
+                    left = Solve(points, begin, mid, bound, parallelDepth - 1, leftStrip);
+                });
+                Candidate right = Solve(points, mid, end, bound, parallelDepth - 1, strip);
+                thread.join();
+                best = right.IsBetter(left) ? right : left;
+            }
+            else
+            {
+                best = Solve(points, begin, mid, best, 0, strip);
+                best = Solve(points, mid, end, best, 0, strip);
+            }
+
+            // A pair across the split is no farther apart in x than either point is from it
+            double split = points[mid].x;
+            int stripBegin = mid;
+            int stripEnd = mid;
+            while (stripBegin > begin && (split - points[stripBegin - 1].x) * (split - points[stripBegin - 1].x) <= best.distance2)
+            {
+                stripBegin--;
+            }
+            while (stripEnd < end && (points[stripEnd].x - split) * (points[stripEnd].x - split) <= best.distance2)
+            {
+                stripEnd++;
+            }
+            strip.clear();
+            for (int k = stripBegin; k < stripEnd; k++)
+            {
+                strip.push_back({ points[k], k });
+            }
+            std::sort(strip.begin(), strip.end(), IsBelow);
+            for (int s = 0; s < strip.size(); s++)
+            {
+                for (int t = s + 1; t < strip.size(); t++)
+                {
+                    double dy = strip[t].P.y - strip[s].P.y;
+                    if (dy * dy > best.distance2)
+                    {
+                        break;
+                    }
+                    Consider(points, strip[s].index, strip[t].index, best);
+                }
+            }
+            return best;
+        }
+
+        PointPair GetPair(const SortedPoints& sorted, const Candidate& best)
+        {
+            PointPair pair;
+            for (int k = 0; k < sorted.ids.size(); k++)
+            {
+                int first = sorted.firsts[sorted.ids[k]];
+                if (first != k)
+                {
+                    pair.a = first;
+                    pair.b = k;
+                    pair.distance = 0.0;
+                    return pair;
+                }
+            }
+            if (best.i != -1)
+            {
+                pair.a = std::min(sorted.firsts[best.i], sorted.firsts[best.j]);
+                pair.b = std::max(sorted.firsts[best.i], sorted.firsts[best.j]);
+                pair.distance = std::sqrt(best.distance2);
+            }
+            return pair;
+        }
+
+        int FindRoot(std::vector<int>& parents, int i)
+        {
+            while (parents[i] != i)
+            {
+                parents[i] = parents[parents[i]];
+                i = parents[i];
+            }
+            return i;
+        }
+    }
+
+    PointPair ClosestPair_Sweep(const SortedPoints& sorted)
+    {
+        GEOMETRY_STAGE(stage, "ClosestPair/sweep");
+        const std::vector<Point>& points = sorted.points;
+        Candidate best = { std::numeric_limits<double>::infinity(), -1, -1 };
+        if (sorted.points.size() == sorted.ids.size())
+        {
+            SweepNearPairs(points, best.distance2, [&](int i, int j)
+            {
+                Consider(points, i, j, best);
+            });
+        }
+        return GetPair(sorted, best);
+    }
+
+    PointPair ClosestPair_DivideAndConquer(const SortedPoints& sorted, int threadCount)
+    {
+        GEOMETRY_STAGE(stage, "ClosestPair/divide");
+        Candidate best = { std::numeric_limits<double>::infinity(), -1, -1 };
+        if (sorted.points.size() == sorted.ids.size() && sorted.points.size() >= 2)
+        {
+            int parallelDepth = 0;
+            while ((1 << parallelDepth) < GetThreadCount(threadCount))
+            {
+                parallelDepth++;
+            }
+            std::vector<Item> strip;
+            best = Solve(sorted.points, 0, int(sorted.points.size()), best, parallelDepth, strip);
+        }
+        return GetPair(sorted, best);
+    }
+
+    std::vector<int> GetNearDuplicates(const SortedPoints& sorted, double epsilon)
+    {
+        GEOMETRY_STAGE(stage, "NearDuplicates/sweep");
+        const std::vector<Point>& points = sorted.points;
+        std::vector<int> parents(points.size());
+        std::iota(parents.begin(), parents.end(), 0);
+        double reach2 = epsilon >= 0.0 ? epsilon * epsilon : -1.0;
+        SweepNearPairs(points, reach2, [&](int i, int j)
+        {
+            if (GetDistance2(points[i], points[j]) <= reach2)
+            {
+                int a = FindRoot(parents, i);
+                int b = FindRoot(parents, j);
+                parents[std::max(a, b)] = std::min(a, b);
+            }
+        });
+
+        GEOMETRY_NEXT_STAGE(stage, "NearDuplicates/groups");
+        std::vector<int> groupFirsts(points.size(), -1);
+        for (int s = 0; s < points.size(); s++)
+        {
+            int& first = groupFirsts[FindRoot(parents, s)];
+            first = first == -1 ? sorted.firsts[s] : std::min(first, sorted.firsts[s]);
+        }
+        std::vector<int> result(sorted.ids.size());
+        for (int k = 0; k < sorted.ids.size(); k++)
+        {
+            result[k] = groupFirsts[FindRoot(parents, sorted.ids[k])];
+        }
+        return result;
+    }
+
+    std::vector<int> GetAllNearestNeighbours(const SortedPoints& sorted)
+    {
+        GEOMETRY_STAGE(stage, "NearestNeighbours/delaunay");
+        const std::vector<Point>& points = sorted.points;
+        int count = int(points.size());
+        std::vector<int> nearest(count, -1);
+        std::vector<double> nearest2(count, std::numeric_limits<double>::infinity());
+        auto consider = [&](int u, int v)
+        {
+            double distance2 = GetDistance2(points[u], points[v]);
+            if (distance2 < nearest2[u] || (distance2 == nearest2[u] && sorted.firsts[v] < sorted.firsts[nearest[u]]))
+            {
+                nearest[u] = v;
+                nearest2[u] = distance2;
+            }
+        };
+
+        Triangulation triangulation = count >= 3 ? DelaunayTriangulation(points) : Triangulation();
+        if (triangulation.triangles.empty())
+        {
+            for (int s = 1; s < count; s++)
+            {
+                consider(s - 1, s);
+                consider(s, s - 1);
+            }
+        }
+        for (int e = 0; e < triangulation.triangles.size(); e++)
+        {
+            int u = triangulation.triangles[e];
+            int v = triangulation.triangles[NextHalfEdge(e)];
+            consider(u, v);
+            consider(v, u);
+        }
+
+        // An equal point is nearer than any other: the first of them, or for the first itself
+        // the second
+        GEOMETRY_NEXT_STAGE(stage, "NearestNeighbours/duplicates");
+        std::vector<int> seconds(count, -1);
+        for (int k = 0; k < sorted.ids.size(); k++)
+        {
+            int s = sorted.ids[k];
+            if (sorted.firsts[s] != k && seconds[s] == -1)
+            {
+                seconds[s] = k;
+            }
+        }
+        std::vector<int> result(sorted.ids.size(), -1);
+        for (int k = 0; k < sorted.ids.size(); k++)
+        {
+            int s = sorted.ids[k];
+            if (sorted.firsts[s] != k)
+            {
+                result[k] = sorted.firsts[s];
+            }
+            else if (seconds[s] != -1)
+            {
+                result[k] = seconds[s];
+            }
+            else if (nearest[s] != -1)
+            {
+                result[k] = sorted.firsts[nearest[s]];
+            }
+        }
+        return result;
+    }
+}
@@ -0,0 +1,46 @@
+#ifndef CLOSEST_PAIR_H
+#define CLOSEST_PAIR_H
+
+#include <limits>
+#include <vector>
+
+#include "ConvexHull.h"
+#include "Geometry.h"
+
+namespace geometry
+{
+    // Two input points, a < b, and their distance. a and b are -1 for fewer than two distinct
+    // points.
+    struct PointPair
+    {
+        int a = -1;
+        int b = -1;
+        double distance = std::numeric_limits<double>::infinity();
+    };
+
+    // The closest pairs below all work on the points as SortByXThenByY() leaves them, so one
+    // sort serves the hull too. Equal input points are at distance 0: the first input point
+    // with an earlier equal one is returned with it.
+
+    // Sweep in x keeping the points nearer than the best distance in x in a set by y, each
+    // point compared with the ones near it in y only. O(n log n).
+    PointPair ClosestPair_Sweep(const SortedPoints& sorted);
+
+    // Halves by x, the best pair so far bounding the next half, and the strip around each split
+    // sorted by y and compared across it. The strips are few points unless many share an x,
+    // O(n log^2 n) at worst. The top halves are split over threadCount threads, 0 means
+    // std::thread::hardware_concurrency(); the pair does not depend on it.
+    PointPair ClosestPair_DivideAndConquer(const SortedPoints& sorted, int threadCount = 0);
+
+    // Groups of input points linked by distances <= epsilon, for each input point the first
+    // one of its group. Swept like ClosestPair_Sweep(), O(n log n + the pairs within epsilon).
+    std::vector<int> GetNearDuplicates(const SortedPoints& sorted, double epsilon);
+
+    // For each input point the nearest other one, of equally near ones the first, -1 for a
+    // single point. The nearest points are neighbours in DelaunayTriangulation() of the
+    // distinct points, ones on a line neighbours in the sorted order. Coordinates up to about
+    // 1e75, where InCircle() overflows.
+    std::vector<int> GetAllNearestNeighbours(const SortedPoints& sorted);
+}
+
+#endif
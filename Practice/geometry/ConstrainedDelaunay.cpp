@@ -0,0 +1,453 @@
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <numeric>
+
+#include "ConstrainedDelaunay.h"
+
+namespace geometry
+{
+    namespace
+    {
+        void Link(std::vector<int>& halfedges, int e, int f)
+        {
+            halfedges[e] = f;
+            if (f != -1)
+            {
+                halfedges[f] = e;
+            }
+        }
+
+        // Replaces the half-edge a (and its twin) with the other diagonal of the quad around it.
+        // Afterwards a starts at the vertex opposite of its twin and the new diagonal is PrevHalfEdge(a).
+        void Flip(Triangulation& mesh, int a)
+        {
+            GEOMETRY_COUNT(Flips);
+            std::vector<int>& triangles = mesh.triangles;
+            std::vector<int>& halfedges = mesh.halfedges;
+
+            int b = halfedges[a];
+            int ar = PrevHalfEdge(a);
+            int bl = PrevHalfEdge(b);
+            int hbl = halfedges[bl];
+            int har = halfedges[ar];
+
+            triangles[a] = triangles[bl];
+            triangles[b] = triangles[ar];
+            Link(halfedges, a, hbl);
+            Link(halfedges, b, har);
+            Link(halfedges, ar, bl);
+        }
+
+        bool IsSignChange(double a, double b)
+        {
+            return (a > 0.0 && b < 0.0) || (a < 0.0 && b > 0.0);
+        }
+
+        // Sloan's edge recovery: the edges crossing a missing constraint are flipped away one
+        // quad at a time, non-convex quads wait at the back of the queue
+        class ConstraintRecovery
+        {
+        public:
+            ConstraintRecovery(const std::vector<Point>& points, Triangulation& mesh)
+                : points(points), mesh(mesh), vertexEdge(points.size(), -1)
+            {
+                for (int e = 0; e < mesh.triangles.size(); e++)
+                {
+                    vertexEdge[mesh.triangles[e]] = e;
+                }
+            }
+
+            int FindHalfEdge(int u, int v)
+            {
+                GetOutgoing(u, outgoing);
+                for (int e : outgoing)
+                {
+                    if (mesh.triangles[NextHalfEdge(e)] == v)
+                    {
+                        return e;
+                    }
+                }
+                return -1;
+            }
+
+            void Recover(int a, int b)
+            {
+                if (FindHalfEdge(a, b) != -1 || FindHalfEdge(b, a) != -1)
+                {
+                    return;
+                }
+
+                const std::vector<int>& triangles = mesh.triangles;
+                Point A = points[a];
+                Point B = points[b];
+
+                // The triangle around a that AB leaves through, its far edge goes from the right of AB to the left
+                int e = -1;
+                GetOutgoing(a, outgoing);
+                for (int o : outgoing)
+                {
+                    if (Orient2D(A, B, points[triangles[NextHalfEdge(o)]]) < 0.0 && Orient2D(A, B, points[triangles[PrevHalfEdge(o)]]) > 0.0)
+                    {
+                        e = NextHalfEdge(o);
+                        break;
+                    }
+                }
+                if (e == -1)
+                {
+                    // AB passes through a vertex, the polygon is not simple
+                    return;
+                }
+
+                std::deque<std::pair<int, int>> crossing;
+                while (true)
+                {
+                    crossing.push_back({ triangles[e], triangles[NextHalfEdge(e)] });
+                    int f = mesh.halfedges[e];
+                    int y = triangles[PrevHalfEdge(f)];
+                    if (y == b)
+                    {
+                        break;
+                    }
+
+                    double side = Orient2D(A, B, points[y]);
+                    if (side == 0.0)
+                    {
+                        return;
+                    }
+                    e = side < 0.0 ? PrevHalfEdge(f) : NextHalfEdge(f);
+                }
+
+                while (!crossing.empty())
+                {
+                    std::pair<int, int> edge = crossing.front();
+                    crossing.pop_front();
+
+                    int e = FindHalfEdge(edge.first, edge.second);
+                    int p0 = triangles[PrevHalfEdge(e)];
+                    int p1 = triangles[PrevHalfEdge(mesh.halfedges[e])];
+                    Point P0 = points[p0];
+                    Point P1 = points[p1];
+                    if (!IsSignChange(Orient2D(P0, P1, points[edge.first]), Orient2D(P0, P1, points[edge.second])))
+                    {
+                        crossing.push_back(edge);
+                        continue;
+                    }
+
+                    FlipAndUpdate(e);
+                    if (IsSignChange(Orient2D(A, B, P0), Orient2D(A, B, P1)))
+                    {
+                        crossing.push_back({ p0, p1 });
+                    }
+                }
+            }
+
+        private:
+            void FlipAndUpdate(int a)
+            {
+                int b = mesh.halfedges[a];
+                Flip(mesh, a);
+                vertexEdge[mesh.triangles[a]] = a;
+                vertexEdge[mesh.triangles[NextHalfEdge(a)]] = NextHalfEdge(a);
+                vertexEdge[mesh.triangles[b]] = b;
+                vertexEdge[mesh.triangles[NextHalfEdge(b)]] = NextHalfEdge(b);
+            }
+
+            // All half-edges starting at u: counter-clockwise until the hull, then clockwise from the start
+            void GetOutgoing(int u, std::vector<int>& result) const
+            {
+                result.clear();
+                int start = vertexEdge[u];
+                if (start == -1)
+                {
+                    return;
+                }
+
+                int e = start;
+                while (true)
+                {
+                    result.push_back(e);
+                    e = mesh.halfedges[PrevHalfEdge(e)];
+                    if (e == start)
+                    {
+                        return;
+                    }
+                    if (e == -1)
+                    {
+                        break;
+                    }
+                }
+
+                e = start;
+                while (mesh.halfedges[e] != -1)
+                {
+                    e = NextHalfEdge(mesh.halfedges[e]);
+                    result.push_back(e);
+                }
+            }
+
+            const std::vector<Point>& points;
+            Triangulation& mesh;
+            std::vector<int> vertexEdge;
+            std::vector<int> outgoing;
+        };
+
+        bool IsLessByXThenByY(Point a, Point b)
+        {
+            return a.x < b.x || (a.x == b.x && a.y < b.y);
+        }
+
+        std::vector<int> SortByCoordinates(const std::vector<Point>& points)
+        {
+            std::vector<int> result(points.size());
+            std::iota(result.begin(), result.end(), 0);
+            std::sort(result.begin(), result.end(), [&](int a, int b) { return IsLessByXThenByY(points[a], points[b]); });
+            return result;
+        }
+
+        Triangulation KeepTriangles(const Triangulation& mesh, const std::vector<char>& keep)
+        {
+            int triangleCount = int(keep.size());
+            std::vector<int> index(triangleCount, -1);
+            int keptCount = 0;
+            for (int t = 0; t < triangleCount; t++)
+            {
+                if (keep[t])
+                {
+                    index[t] = keptCount++;
+                }
+            }
+
+            Triangulation result;
+            result.triangles.resize(3 * keptCount);
+            result.halfedges.resize(3 * keptCount);
+            for (int t = 0; t < triangleCount; t++)
+            {
+                if (index[t] == -1)
+                {
+                    continue;
+                }
+
+                for (int k = 0; k < 3; k++)
+                {
+                    int twin = mesh.halfedges[3 * t + k];
+                    bool isKept = twin != -1 && index[twin / 3] != -1;
+                    result.triangles[3 * index[t] + k] = mesh.triangles[3 * t + k];
+                    result.halfedges[3 * index[t] + k] = isKept ? 3 * index[twin / 3] + twin % 3 : -1;
+                }
+            }
+            return result;
+        }
+    }
+
+    int LegalizeTriangulation(const std::vector<Point>& points, Triangulation& triangulation)
+    {
+        const std::vector<int>& triangles = triangulation.triangles;
+        const std::vector<int>& halfedges = triangulation.halfedges;
+
+        std::vector<int> stack;
+        for (int e = 0; e < halfedges.size(); e++)
+        {
+            if (halfedges[e] > e)
+            {
+                stack.push_back(e);
+            }
+        }
+
+        int flips = 0;
+        while (!stack.empty())
+        {
+            int a = stack.back();
+            stack.pop_back();
+
+            int b = halfedges[a];
+            if (b == -1)
+            {
+                continue;
+            }
+
+            Point PR = points[triangles[a]];
+            Point PL = points[triangles[NextHalfEdge(a)]];
+            Point P0 = points[triangles[PrevHalfEdge(a)]];
+            Point P1 = points[triangles[PrevHalfEdge(b)]];
+            if (InCircle(PR, PL, P0, P1) <= 0.0)
+            {
+                continue;
+            }
+
+            Flip(triangulation, a);
+            flips++;
+            stack.push_back(a);
+            stack.push_back(NextHalfEdge(a));
+            stack.push_back(b);
+            stack.push_back(NextHalfEdge(b));
+        }
+        return flips;
+    }
+
+    Triangulation ConstrainedDelaunay(const std::vector<Point>& polygon)
+    {
+        GEOMETRY_STAGE(stage, "ConstrainedDelaunay/triangulate");
+        Triangulation mesh = DelaunayTriangulation(polygon);
+        mesh.hull.clear();
+        if (mesh.triangles.empty())
+        {
+            return mesh;
+        }
+
+        // Duplicated vertices are triangulated once, polygon edges go through that copy
+        int n = polygon.size();
+        std::vector<char> isUsed(n, 0);
+        for (int v : mesh.triangles)
+        {
+            isUsed[v] = 1;
+        }
+        std::vector<int> byCoordinates = SortByCoordinates(polygon);
+        std::vector<int> vertex(n);
+        for (int i = 0, j = 0; i < n; i = j)
+        {
+            int used = byCoordinates[i];
+            for (j = i; j < n && polygon[byCoordinates[j]] == polygon[byCoordinates[i]]; j++)
+            {
+                used = isUsed[byCoordinates[j]] ? byCoordinates[j] : used;
+            }
+            for (int k = i; k < j; k++)
+            {
+                vertex[byCoordinates[k]] = used;
+            }
+        }
+
+        GEOMETRY_NEXT_STAGE(stage, "ConstrainedDelaunay/recover");
+        ConstraintRecovery recovery(polygon, mesh);
+        for (int i = 0; i < n; i++)
+        {
+            if (vertex[i] != vertex[(i + 1) % n])
+            {
+                recovery.Recover(vertex[i], vertex[(i + 1) % n]);
+            }
+        }
+
+        GEOMETRY_NEXT_STAGE(stage, "ConstrainedDelaunay/flood");
+        double area = 0.0;
+        for (int i = 0; i < n; i++)
+        {
+            area += polygon[i] ^ polygon[(i + 1) % n];
+        }
+
+        // Interior half-edges of the polygon edges seed a flood fill that stops at constraints
+        std::vector<char> constrained(mesh.triangles.size(), 0);
+        std::vector<int> stack;
+        for (int i = 0; i < n; i++)
+        {
+            int u = vertex[area > 0.0 ? i : (i + 1) % n];
+            int v = vertex[area > 0.0 ? (i + 1) % n : i];
+            if (u == v)
+            {
+                continue;
+            }
+
+            int e = recovery.FindHalfEdge(u, v);
+            int twin = recovery.FindHalfEdge(v, u);
+            if (twin != -1)
+            {
+                constrained[twin] = 1;
+            }
+            if (e != -1)
+            {
+                constrained[e] = 1;
+                stack.push_back(e / 3);
+            }
+        }
+
+        std::vector<char> inside(mesh.triangles.size() / 3, 0);
+        for (int t : stack)
+        {
+            inside[t] = 1;
+        }
+        while (!stack.empty())
+        {
+            int t = stack.back();
+            stack.pop_back();
+            for (int e = 3 * t; e < 3 * t + 3; e++)
+            {
+                int twin = mesh.halfedges[e];
+                if (!constrained[e] && twin != -1 && !inside[twin / 3])
+                {
+                    inside[twin / 3] = 1;
+                    stack.push_back(twin / 3);
+                }
+            }
+        }
+
+        Triangulation result = KeepTriangles(mesh, inside);
+        GEOMETRY_NEXT_STAGE(stage, "ConstrainedDelaunay/legalize");
+        LegalizeTriangulation(polygon, result);
+        return result;
+    }
+
+    Triangulation ConstrainedDelaunay(const std::vector<Point>& polygon, const std::vector<Triangle>& triangles)
+    {
+        std::vector<int> byCoordinates = SortByCoordinates(polygon);
+        auto getIndex = [&](Point P)
+        {
+            auto it = std::lower_bound(byCoordinates.begin(), byCoordinates.end(), P, [&](int i, Point Q) { return IsLessByXThenByY(polygon[i], Q); });
+            return it != byCoordinates.end() && polygon[*it] == P ? *it : -1;
+        };
+
+        Triangulation mesh;
+        for (const Triangle& triangle : triangles)
+        {
+            int a = getIndex(triangle.A);
+            int b = getIndex(triangle.B);
+            int c = getIndex(triangle.C);
+            if (a == -1 || b == -1 || c == -1)
+            {
+                continue;
+            }
+
+            double area = Orient2D(polygon[a], polygon[b], polygon[c]);
+            if (area == 0.0)
+            {
+                continue;
+            }
+            if (area < 0.0)
+            {
+                std::swap(b, c);
+            }
+            mesh.triangles.insert(mesh.triangles.end(), { a, b, c });
+        }
+
+        // Twins share the same unordered pair of vertices
+        std::vector<std::pair<uint64_t, int>> edges(mesh.triangles.size());
+        for (int e = 0; e < mesh.triangles.size(); e++)
+        {
+            uint64_t u = mesh.triangles[e];
+            uint64_t v = mesh.triangles[NextHalfEdge(e)];
+            edges[e] = { std::min(u, v) << 32 | std::max(u, v), e };
+        }
+        std::sort(edges.begin(), edges.end());
+
+        mesh.halfedges.assign(mesh.triangles.size(), -1);
+        for (int i = 0; i + 1 < edges.size(); i++)
+        {
+            if (edges[i].first == edges[i + 1].first)
+            {
+                Link(mesh.halfedges, edges[i].second, edges[i + 1].second);
+                i++;
+            }
+        }
+
+        LegalizeTriangulation(polygon, mesh);
+        return mesh;
+    }
+
+    std::vector<Triangle> GetTriangles(const std::vector<Point>& points, const Triangulation& triangulation)
+    {
+        std::vector<Triangle> result(triangulation.triangles.size() / 3);
+        for (int t = 0; t < result.size(); t++)
+        {
+            result[t] = { points[triangulation.triangles[3 * t]], points[triangulation.triangles[3 * t + 1]], points[triangulation.triangles[3 * t + 2]] };
+        }
+        return result;
+    }
+}
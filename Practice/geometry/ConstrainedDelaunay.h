@@ -0,0 +1,27 @@
+#ifndef CONSTRAINED_DELAUNAY_H
+#define CONSTRAINED_DELAUNAY_H
+
+#include <vector>
+
+#include "Delaunay.h"
+
+namespace geometry
+{
+    // Triangulations of a simple polygon with vertex indices into the polygon. The polygon
+    // edges are exactly the half-edges without a twin, so flips never touch them.
+
+    // Delaunay triangulation of the vertices, polygon edges recovered by flipping and the
+    // triangles outside the polygon dropped
+    Triangulation ConstrainedDelaunay(const std::vector<Point>& polygon);
+
+    // Refines an existing triangulation of the polygon, e.g. the output of Earcut()
+    Triangulation ConstrainedDelaunay(const std::vector<Point>& polygon, const std::vector<Triangle>& triangles);
+
+    // Lawson flips driven by a stack until every edge with a twin is locally Delaunay.
+    // Returns the number of flips.
+    int LegalizeTriangulation(const std::vector<Point>& points, Triangulation& triangulation);
+
+    std::vector<Triangle> GetTriangles(const std::vector<Point>& points, const Triangulation& triangulation);
+}
+
+#endif
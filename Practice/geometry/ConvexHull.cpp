@@ -0,0 +1,215 @@
+#include <algorithm>
+
+#include "ConvexHull.h"
+#include "Hilbert.h"
+
+namespace geometry
+{
+    int GetLeftMostPoint(const std::vector<Point>& points)
+    {
+        int leftMostPointIndex = 0;
+        for (int i = 1; i < points.size(); i++)
+        {
+            Point L = points[leftMostPointIndex];
+            if (L.x > points[i].x || (L.x == points[i].x && L.y > points[i].y))
+            {
+                leftMostPointIndex = i;
+            }
+        }
+        return leftMostPointIndex;
+    }
+
+    std::vector<Point> GiftWrap_Jarvis(const std::vector<Point>& points)
+    {
+        std::vector<Point> convexHull;
+        if (points.empty())
+        {
+            return convexHull;
+        }
+
+        GEOMETRY_STAGE(stage, "Jarvis/wrap");
+        int leftMostPointIndex = GetLeftMostPoint(points);
+        int pointIndex = leftMostPointIndex;
+        do
+        {
+            convexHull.emplace_back(points[pointIndex]);
+
+            // Every point must be left of the next edge, of the collinear ones the farthest is taken
+            Point P = points[pointIndex];
+            int nextPointIndex = pointIndex;
+            for (int i = 0; i < points.size(); i++)
+            {
+                if (points[i] == P)
+                {
+                    continue;
+                }
+                Point N = points[nextPointIndex];
+                double area = Orient2D(P, N, points[i]);
+                if (N == P || area < 0.0 || (area == 0.0 && (points[i] - P) * (points[i] - P) > (N - P) * (N - P)))
+                {
+                    nextPointIndex = i;
+                }
+            }
+
+            pointIndex = nextPointIndex;
+
+        } while (points[pointIndex] != points[leftMostPointIndex]);
+
+        return convexHull;
+    }
+
+    std::vector<Point> GrahamScan_Graham(const std::vector<Point>& points)
+    {
+        std::vector<Point> convexHull;
+        if (points.empty())
+        {
+            return convexHull;
+        }
+
+        GEOMETRY_STAGE(stage, "Graham/sort");
+        int leftMostPointIndex = GetLeftMostPoint(points);
+        Point P = points[leftMostPointIndex];
+
+        // Every point is right of or above P, so the angles span less than a half turn
+        auto compareByAngle = [&](Point A, Point B)
+        {
+            Orientation orientation = GetOrientation(P, A, B);
+            if (orientation == Orientation::Colinear)
+            {
+                double APDist = std::abs(A.x - P.x) + std::abs(A.y - P.y);
+                double BPDist = std::abs(B.x - P.x) + std::abs(B.y - P.y);
+                return APDist < BPDist;
+            }
+            return orientation == Orientation::CounterClockWise;
+        };
+        std::vector<Point> sortedPointsByAngle = points;
+        std::swap(sortedPointsByAngle[0], sortedPointsByAngle[leftMostPointIndex]);
+        std::sort(sortedPointsByAngle.begin() + 1, sortedPointsByAngle.end(), compareByAngle);
+
+        GEOMETRY_NEXT_STAGE(stage, "Graham/scan");
+        convexHull.push_back(P);
+        for (Point Q : sortedPointsByAngle)
+        {
+            if (Q == P)
+            {
+                continue;
+            }
+            while (convexHull.size() > 1 && GetOrientation(convexHull[convexHull.size() - 2], convexHull[convexHull.size() - 1], Q) != Orientation::CounterClockWise)
+            {
+                GEOMETRY_COUNT(HullPops);
+                convexHull.pop_back();
+            }
+            convexHull.push_back(Q);
+        }
+
+        // The points on the last ray are nearest first, only the farthest is a vertex
+        while (convexHull.size() > 2 && GetOrientation(convexHull[convexHull.size() - 2], convexHull[convexHull.size() - 1], P) != Orientation::CounterClockWise)
+        {
+            GEOMETRY_COUNT(HullPops);
+            convexHull.pop_back();
+        }
+
+        return convexHull;
+    }
+
+    std::vector<Point> MonotoneChain_Andrews(const std::vector<Point>& points)
+    {
+        SortedPoints sorted;
+        {
+            GEOMETRY_STAGE(stage, "Andrew/sort");
+            sorted = SortByXThenByY(points);
+        }
+        return MonotoneChain_Andrews(sorted);
+    }
+
+    SortedPoints SortByXThenByY(const std::vector<Point>& points)
+    {
+        SortedPoints sorted;
+        std::vector<SpatialKey> keys(points.size());
+        for (int i = 0; i < points.size(); i++)
+        {
+            keys[i] = { GetSortKey(points[i].x), i };
+        }
+        RadixSort(keys);
+
+        sorted.points.reserve(points.size());
+        sorted.firsts.reserve(points.size());
+        sorted.ids.resize(points.size());
+        for (size_t begin = 0; begin < keys.size();)
+        {
+            size_t end = begin + 1;
+            while (end < keys.size() && keys[end].key == keys[begin].key)
+            {
+                end++;
+            }
+            if (end - begin > 1)
+            {
+                std::sort(keys.begin() + begin, keys.begin() + end, [&](const SpatialKey& a, const SpatialKey& b)
+                {
+                    double ay = points[a.index].y;
+                    double by = points[b.index].y;
+                    return ay < by || (ay == by && a.index < b.index);
+                });
+            }
+            for (size_t i = begin; i < end; i++)
+            {
+                Point P = points[keys[i].index];
+                if (i == begin || P.y != sorted.points.back().y)
+                {
+                    sorted.points.push_back(P);
+                    sorted.firsts.push_back(keys[i].index);
+                }
+                sorted.ids[keys[i].index] = int(sorted.points.size()) - 1;
+            }
+            begin = end;
+        }
+        return sorted;
+    }
+
+    std::vector<Point> MonotoneChain_Andrews(const SortedPoints& sorted)
+    {
+        const std::vector<Point>& sortedPoints = sorted.points;
+        if (sortedPoints.size() < 2)
+        {
+            return sortedPoints;
+        }
+
+        GEOMETRY_STAGE(stage, "Andrew/lower");
+        std::vector<Point> lowerChain;
+        for (Point P : sortedPoints)
+        {
+            while (lowerChain.size() > 1 && GetOrientation(lowerChain[lowerChain.size() - 2], lowerChain[lowerChain.size() - 1], P) != Orientation::CounterClockWise)
+            {
+                GEOMETRY_COUNT(HullPops);
+                lowerChain.pop_back();
+            }
+
+            lowerChain.push_back(P);
+        }
+
+        GEOMETRY_NEXT_STAGE(stage, "Andrew/upper");
+        std::vector<Point> upperChain;
+        for (int i = sortedPoints.size() - 1; i >= 0; i--)
+        {
+            Point P = sortedPoints[i];
+            while (upperChain.size() > 1 && GetOrientation(upperChain[upperChain.size() - 2], upperChain[upperChain.size() - 1], P) != Orientation::CounterClockWise)
+            {
+                GEOMETRY_COUNT(HullPops);
+                upperChain.pop_back();
+            }
+
+            upperChain.push_back(P);
+        }
+
+        lowerChain.pop_back();
+        upperChain.pop_back();
+
+        // Concatanate
+        for (Point P : upperChain)
+        {
+            lowerChain.push_back(P);
+        }
+
+        return lowerChain;
+    }
+}
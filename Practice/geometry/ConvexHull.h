@@ -0,0 +1,41 @@
+#ifndef CONVEX_HULL_H
+#define CONVEX_HULL_H
+
+#include <vector>
+
+#include "Geometry.h"
+
+namespace geometry
+{
+    // The lowest of the left most points
+    int GetLeftMostPoint(const std::vector<Point>& points);
+
+    // The hull vertices counter-clockwise without collinear ones, starting from GetLeftMostPoint().
+    // Collinear points give the two ends, equal points a single one.
+
+    std::vector<Point> GiftWrap_Jarvis(const std::vector<Point>& points);
+
+    std::vector<Point> GrahamScan_Graham(const std::vector<Point>& points);
+
+    std::vector<Point> MonotoneChain_Andrews(const std::vector<Point>& points);
+
+    // The distinct points by x then y, the order MonotoneChain_Andrews() scans them in, kept
+    // for the stages after the hull that need them sorted the same way
+    struct SortedPoints
+    {
+        std::vector<Point> points;
+
+        // The first input point equal to points[i]
+        std::vector<int> firsts;
+
+        // For each input point the index of the equal one in points
+        std::vector<int> ids;
+    };
+
+    // RadixSort() on x, runs of equal x sorted on y
+    SortedPoints SortByXThenByY(const std::vector<Point>& points);
+
+    std::vector<Point> MonotoneChain_Andrews(const SortedPoints& sorted);
+}
+
+#endif
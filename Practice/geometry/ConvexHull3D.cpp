@@ -0,0 +1,581 @@
+#include <algorithm>
+#include <cmath>
+
+#include "ConvexHull3D.h"
+#include "Parallel.h"
+
+namespace geometry
+{
+    namespace
+    {
+        // Fewer points than this are handed to the faces on the calling thread
+        const int ParallelBatch = 1 << 15;
+
+        // Above which |n . (P - A)| decides the side on its own: the normal of a face is worked
+        // out once, the rounding of it and of the product is bounded by 16e times the largest
+        // magnitude of the products in n times |P - A| in the 1-norm
+        const double PlaneErrorBound = 3.5527136788005009e-15;
+
+        // The starting polytope takes the extreme points both ways along each
+        const double Directions[7][3] = { { 1, 0, 0 }, { 0, 1, 0 }, { 0, 0, 1 }, { 1, 1, 1 }, { 1, 1, -1 }, { 1, -1, 1 }, { -1, 1, 1 } };
+
+        // Exactly, each projection on a coordinate plane is collinear
+        bool IsCollinear(const Point3D& a, const Point3D& b, const Point3D& c)
+        {
+            return Orient2D(Point(a.x, a.y), Point(b.x, b.y), Point(c.x, c.y)) == 0.0
+                && Orient2D(Point(a.y, a.z), Point(b.y, b.z), Point(c.y, c.z)) == 0.0
+                && Orient2D(Point(a.z, a.x), Point(b.z, b.x), Point(c.z, c.x)) == 0.0;
+        }
+
+        // The points above a face are kept as a list through next[], which holds one link per
+        // input point: a point is above at most one face at a time, so all lists share it.
+        class Quickhull
+        {
+        public:
+            Quickhull(const std::vector<Point3D>& points, int threadCount)
+                : points(points), threadCount(GetThreadCount(threadCount)), next(points.size(), -1), horizonFace(points.size(), -1)
+            {
+            }
+
+            Hull3D Run()
+            {
+                std::vector<int> extremes = GetExtremes();
+                if (!AddSimplex(extremes))
+                {
+                    return Hull3D();
+                }
+
+                // The hull of the extremes, every point inside it is dropped right away
+                for (int p : extremes)
+                {
+                    for (int f = 0; f < isDeleted.size(); f++)
+                    {
+                        if (!isDeleted[f] && GetHeight(f, p) > 0.0)
+                        {
+                            Insert(p, f);
+                            break;
+                        }
+                    }
+                }
+                std::vector<int> faces;
+                for (int f = 0; f < isDeleted.size(); f++)
+                {
+                    if (!isDeleted[f])
+                    {
+                        faces.push_back(f);
+                    }
+                }
+                // Most points are well inside, a ball within the faces takes them before any
+                // face is tested
+                Point3D center;
+                double radius2 = GetInnerBall(faces, center);
+                Assign(int(points.size()), [&](int i)
+                {
+                    Point3D d = points[i] - center;
+                    return d * d < radius2 ? -1 : i;
+                }, faces);
+
+                while (!pending.empty())
+                {
+                    int f = pending.back();
+                    pending.pop_back();
+                    if (!isDeleted[f] && conflicts[f] >= 0)
+                    {
+                        Insert(farthest[f], f);
+                    }
+                }
+                return GetHull();
+            }
+
+        private:
+            // Per face: the points above it, the farthest of them and how far
+            struct ConflictList
+            {
+                int head = -1;
+                int tail = -1;
+                int farthest = -1;
+                double height = 0.0;
+
+                void Add(std::vector<int>& next, int p, double pHeight)
+                {
+                    next[p] = -1;
+                    if (tail >= 0)
+                    {
+                        next[tail] = p;
+                    }
+                    else
+                    {
+                        head = p;
+                    }
+                    tail = p;
+                    // Ties go to the first point so the hull is the same on any number of threads
+                    if (pHeight > height || (pHeight == height && p < farthest))
+                    {
+                        height = pHeight;
+                        farthest = p;
+                    }
+                }
+            };
+
+            // The plane of face ABC for the filter in GetHeight(), normal = AB x AC
+            struct Plane
+            {
+                Point3D normal;
+                // The largest sum of the magnitudes of the two products in a coordinate of it
+                double permanent;
+            };
+
+            // Six times the volume of the face and P, positive above it. Orient3D() only
+            // where the plane of the face is too close to call.
+            double GetHeight(int f, int p) const
+            {
+                const Plane& plane = planes[f];
+                Point3D d = points[p] - points[triangles[3 * f]];
+                double height = plane.normal * d;
+                double bound = PlaneErrorBound * plane.permanent * (std::abs(d.x) + std::abs(d.y) + std::abs(d.z));
+                if (height > bound || -height > bound)
+                {
+                    return height;
+                }
+                return Orient3D(points[triangles[3 * f]], points[triangles[3 * f + 1]], points[triangles[3 * f + 2]], points[p]);
+            }
+
+            std::vector<int> GetExtremes() const
+            {
+                struct Extremes
+                {
+                    int index[14];
+                    double value[14];
+                };
+                int n = int(points.size());
+                std::vector<Extremes> chunks(threadCount);
+                for (Extremes& extremes : chunks)
+                {
+                    std::fill(extremes.index, extremes.index + 14, -1);
+                }
+                ParallelFor(n, n >= ParallelBatch ? threadCount : 1, [&](int chunk, int begin, int end)
+                {
+                    Extremes& extremes = chunks[chunk];
+                    for (int i = begin; i < end; i++)
+                    {
+                        const Point3D& P = points[i];
+                        for (int d = 0; d < 14; d++)
+                        {
+                            const double* direction = Directions[d / 2];
+                            double value = (direction[0] * P.x + direction[1] * P.y + direction[2] * P.z) * (d % 2 ? -1.0 : 1.0);
+                            if (extremes.index[d] < 0 || value > extremes.value[d])
+                            {
+                                extremes.index[d] = i;
+                                extremes.value[d] = value;
+                            }
+                        }
+                    }
+                });
+
+                // Chunks cover increasing ranges, the first of equal values stays
+                std::vector<int> result;
+                for (int d = 0; d < 14; d++)
+                {
+                    int best = -1;
+                    double value = 0.0;
+                    for (const Extremes& extremes : chunks)
+                    {
+                        if (extremes.index[d] >= 0 && (best < 0 || extremes.value[d] > value))
+                        {
+                            best = extremes.index[d];
+                            value = extremes.value[d];
+                        }
+                    }
+                    if (best >= 0 && std::find(result.begin(), result.end(), best) == result.end())
+                    {
+                        result.push_back(best);
+                    }
+                }
+                return result;
+            }
+
+            // The farthest pair of extremes, then the extreme farthest from their line and the
+            // one farthest from the plane of the three. Only when the extremes are all on a
+            // line or a plane are all points searched. False when there is no tetrahedron.
+            bool AddSimplex(const std::vector<int>& extremes)
+            {
+                int a = -1;
+                int b = -1;
+                double distance2 = 0.0;
+                for (int i : extremes)
+                {
+                    for (int j : extremes)
+                    {
+                        Point3D d = points[j] - points[i];
+                        if (d * d > distance2)
+                        {
+                            distance2 = d * d;
+                            a = i;
+                            b = j;
+                        }
+                    }
+                }
+                if (a < 0)
+                {
+                    return false;
+                }
+
+                // Rounded measures pick the candidate, the exact predicates make sure of it
+                Point3D A = points[a];
+                Point3D AB = points[b] - A;
+                auto findOffLine = [&](int count, auto getPoint)
+                {
+                    int best = -1;
+                    double area2 = 0.0;
+                    for (int k = 0; k < count; k++)
+                    {
+                        Point3D normal = AB ^ (points[getPoint(k)] - A);
+                        if (normal * normal > area2 || best < 0)
+                        {
+                            area2 = normal * normal;
+                            best = getPoint(k);
+                        }
+                    }
+                    if (best >= 0 && !IsCollinear(A, points[b], points[best]))
+                    {
+                        return best;
+                    }
+                    for (int k = 0; k < count; k++)
+                    {
+                        if (!IsCollinear(A, points[b], points[getPoint(k)]))
+                        {
+                            return getPoint(k);
+                        }
+                    }
+                    return -1;
+                };
+                int n = int(points.size());
+                int c = findOffLine(int(extremes.size()), [&](int k) { return extremes[k]; });
+                c = c >= 0 ? c : findOffLine(n, [](int k) { return k; });
+                if (c < 0)
+                {
+                    return false;
+                }
+
+                Point3D normal = AB ^ (points[c] - A);
+                auto findOffPlane = [&](int count, auto getPoint)
+                {
+                    int best = -1;
+                    double volume = 0.0;
+                    for (int k = 0; k < count; k++)
+                    {
+                        double v = std::abs(normal * (points[getPoint(k)] - A));
+                        if (v > volume || best < 0)
+                        {
+                            volume = v;
+                            best = getPoint(k);
+                        }
+                    }
+                    if (best >= 0 && Orient3D(A, points[b], points[c], points[best]) != 0.0)
+                    {
+                        return best;
+                    }
+                    for (int k = 0; k < count; k++)
+                    {
+                        if (Orient3D(A, points[b], points[c], points[getPoint(k)]) != 0.0)
+                        {
+                            return getPoint(k);
+                        }
+                    }
+                    return -1;
+                };
+                int d = findOffPlane(int(extremes.size()), [&](int k) { return extremes[k]; });
+                d = d >= 0 ? d : findOffPlane(n, [](int k) { return k; });
+                if (d < 0)
+                {
+                    return false;
+                }
+
+                // D below ABC, then every face has the outside on its counter-clockwise side
+                if (Orient3D(A, points[b], points[c], points[d]) > 0.0)
+                {
+                    std::swap(b, c);
+                }
+                AddFace(a, b, c);
+                AddFace(b, a, d);
+                AddFace(c, b, d);
+                AddFace(a, c, d);
+                for (int e = 0; e < 12; e++)
+                {
+                    for (int g = 0; g < 12; g++)
+                    {
+                        if (triangles[e] == triangles[NextHalfEdge(g)] && triangles[NextHalfEdge(e)] == triangles[g])
+                        {
+                            halfedges[e] = g;
+                        }
+                    }
+                }
+                return true;
+            }
+
+            int AddFace(int a, int b, int c)
+            {
+                int f;
+                if (freeFaces.empty())
+                {
+                    f = int(isDeleted.size());
+                    triangles.resize(3 * f + 3);
+                    halfedges.resize(3 * f + 3);
+                    planes.emplace_back();
+                    isDeleted.push_back(false);
+                    conflicts.push_back(-1);
+                    farthest.push_back(-1);
+                    visited.push_back(0);
+                    isVisible.push_back(false);
+                }
+                else
+                {
+                    f = freeFaces.back();
+                    freeFaces.pop_back();
+                    isDeleted[f] = false;
+                    conflicts[f] = -1;
+                    farthest[f] = -1;
+                }
+                triangles[3 * f] = a;
+                triangles[3 * f + 1] = b;
+                triangles[3 * f + 2] = c;
+
+                Point3D A = points[a];
+                Point3D AB = points[b] - A;
+                Point3D AC = points[c] - A;
+                planes[f].normal = AB ^ AC;
+                planes[f].permanent = std::max({ std::abs(AB.y * AC.z) + std::abs(AB.z * AC.y), std::abs(AB.z * AC.x) + std::abs(AB.x * AC.z), std::abs(AB.x * AC.y) + std::abs(AB.y * AC.x) });
+                return f;
+            }
+
+            // A ball around the mean of the vertices, inside every face by a margin well above
+            // the rounding. Returns its squared radius, 0 when the mean is too close to a face.
+            double GetInnerBall(const std::vector<int>& faces, Point3D& center) const
+            {
+                center = Point3D();
+                for (int f : faces)
+                {
+                    center += points[triangles[3 * f]];
+                }
+                center /= double(faces.size());
+
+                double radius = HUGE_VAL;
+                double reach = 0.0;
+                for (int f : faces)
+                {
+                    const Plane& plane = planes[f];
+                    Point3D d = center - points[triangles[3 * f]];
+                    radius = std::min(radius, -(plane.normal * d) / vecta::len(plane.normal));
+                    reach = std::max(reach, vecta::len(d));
+                }
+                radius = radius * (1.0 - std::ldexp(1.0, -20)) - std::ldexp(reach, -40);
+                return radius > 0.0 ? radius * radius : 0.0;
+            }
+
+            // P is above face f. The faces P sees go, a fan of new ones joins P to the horizon
+            // around them and their points move to the new faces.
+            void Insert(int p, int f)
+            {
+                stamp++;
+                visited[f] = stamp;
+                isVisible[f] = true;
+                visible.assign(1, f);
+                horizon.clear();
+                for (int i = 0; i < visible.size(); i++)
+                {
+                    for (int e = 3 * visible[i]; e < 3 * visible[i] + 3; e++)
+                    {
+                        int g = halfedges[e];
+                        int h = g / 3;
+                        if (visited[h] != stamp)
+                        {
+                            visited[h] = stamp;
+                            isVisible[h] = GetHeight(h, p) > 0.0;
+                            if (isVisible[h])
+                            {
+                                visible.push_back(h);
+                            }
+                        }
+                        if (!isVisible[h])
+                        {
+                            horizon.push_back({ triangles[e], triangles[NextHalfEdge(e)], g });
+                        }
+                    }
+                }
+
+                gathered.clear();
+                for (int v : visible)
+                {
+                    for (int q = conflicts[v]; q >= 0; q = next[q])
+                    {
+                        if (q != p)
+                        {
+                            gathered.push_back(q);
+                        }
+                    }
+                    isDeleted[v] = true;
+                    freeFaces.push_back(v);
+                }
+
+                // The horizon is one loop, each of its vertices starts one edge of it
+                newFaces.clear();
+                for (const HorizonEdge& edge : horizon)
+                {
+                    int g = AddFace(edge.from, edge.to, p);
+                    halfedges[3 * g] = edge.twin;
+                    halfedges[edge.twin] = 3 * g;
+                    horizonFace[edge.from] = g;
+                    newFaces.push_back(g);
+                }
+                for (int g : newFaces)
+                {
+                    int h = horizonFace[triangles[3 * g + 1]];
+                    halfedges[3 * g + 1] = 3 * h + 2;
+                    halfedges[3 * h + 2] = 3 * g + 1;
+                }
+                for (const HorizonEdge& edge : horizon)
+                {
+                    horizonFace[edge.from] = -1;
+                }
+
+                Assign(int(gathered.size()), [this](int i) { return gathered[i]; }, newFaces);
+            }
+
+            // Point getPoint(i) for i < count goes to the first of faces it is above, or is
+            // dropped, like any that getPoint() gives as -1. Each thread fills lists of its own over a chunk, chunk by chunk they
+            // are joined after.
+            template <typename GetPoint>
+            void Assign(int count, GetPoint getPoint, const std::vector<int>& faces)
+            {
+                int m = int(faces.size());
+                int chunkCount = count >= ParallelBatch ? threadCount : 1;
+                lists.assign(size_t(chunkCount) * m, ConflictList());
+                ParallelFor(count, chunkCount, [&](int chunk, int begin, int end)
+                {
+                    ConflictList* chunkLists = lists.data() + size_t(chunk) * m;
+                    for (int i = begin; i < end; i++)
+                    {
+                        int p = getPoint(i);
+                        for (int k = 0; k < m && p >= 0; k++)
+                        {
+                            double height = GetHeight(faces[k], p);
+                            if (height > 0.0)
+                            {
+                                chunkLists[k].Add(next, p, height);
+                                break;
+                            }
+                        }
+                    }
+                });
+
+                for (int k = 0; k < m; k++)
+                {
+                    ConflictList joined;
+                    for (int chunk = 0; chunk < chunkCount; chunk++)
+                    {
+                        const ConflictList& list = lists[size_t(chunk) * m + k];
+                        if (list.head < 0)
+                        {
+                            continue;
+                        }
+                        if (joined.tail >= 0)
+                        {
+                            next[joined.tail] = list.head;
+                        }
+                        else
+                        {
+                            joined.head = list.head;
+                        }
+                        joined.tail = list.tail;
+                        if (list.height > joined.height || (list.height == joined.height && list.farthest < joined.farthest))
+                        {
+                            joined.height = list.height;
+                            joined.farthest = list.farthest;
+                        }
+                    }
+                    conflicts[faces[k]] = joined.head;
+                    farthest[faces[k]] = joined.farthest;
+                    if (joined.head >= 0)
+                    {
+                        pending.push_back(faces[k]);
+                    }
+                }
+            }
+
+            Hull3D GetHull() const
+            {
+                std::vector<int> index(isDeleted.size(), -1);
+                int faceCount = 0;
+                for (int f = 0; f < isDeleted.size(); f++)
+                {
+                    if (!isDeleted[f])
+                    {
+                        index[f] = faceCount++;
+                    }
+                }
+
+                Hull3D hull;
+                hull.triangles.resize(3 * faceCount);
+                hull.halfedges.resize(3 * faceCount);
+                for (int f = 0; f < isDeleted.size(); f++)
+                {
+                    if (isDeleted[f])
+                    {
+                        continue;
+                    }
+                    for (int k = 0; k < 3; k++)
+                    {
+                        int g = halfedges[3 * f + k];
+                        hull.triangles[3 * index[f] + k] = triangles[3 * f + k];
+                        hull.halfedges[3 * index[f] + k] = 3 * index[g / 3] + g % 3;
+                    }
+                }
+                return hull;
+            }
+
+            struct HorizonEdge
+            {
+                int from;
+                int to;
+                // The half-edge on the face that stays
+                int twin;
+            };
+
+            const std::vector<Point3D>& points;
+            int threadCount;
+
+            std::vector<int> triangles;
+            std::vector<int> halfedges;
+            std::vector<Plane> planes;
+            std::vector<char> isDeleted;
+            std::vector<int> freeFaces;
+            // First point of the list above each face and the farthest of them
+            std::vector<int> conflicts;
+            std::vector<int> farthest;
+            std::vector<int> next;
+            // Faces with points above them, some may be gone since
+            std::vector<int> pending;
+
+            // Insert() state, kept to reuse the storage
+            int stamp = 0;
+            std::vector<int> visited;
+            std::vector<char> isVisible;
+            std::vector<int> visible;
+            std::vector<HorizonEdge> horizon;
+            std::vector<int> newFaces;
+            std::vector<int> horizonFace;
+            std::vector<int> gathered;
+            std::vector<ConflictList> lists;
+        };
+    }
+
+    Hull3D Quickhull3D_Barber(const std::vector<Point3D>& points, int threadCount)
+    {
+        GEOMETRY_STAGE(stage, "Quickhull3D");
+        if (points.size() < 4)
+        {
+            return Hull3D();
+        }
+        return Quickhull(points, threadCount).Run();
+    }
+}
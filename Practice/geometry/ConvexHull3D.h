@@ -0,0 +1,30 @@
+#ifndef CONVEX_HULL_3D_H
+#define CONVEX_HULL_3D_H
+
+#include <vector>
+
+#include "Delaunay.h"
+#include "Geometry.h"
+
+namespace geometry
+{
+    // A closed triangle mesh in the layout of Triangulation: half-edge e belongs to face
+    // e / 3 and starts at vertex triangles[e], halfedges[e] is the opposite half-edge in the
+    // neighbouring face. Faces are counter-clockwise seen from outside.
+    struct Hull3D
+    {
+        std::vector<int> triangles;
+        std::vector<int> halfedges;
+    };
+
+    // Quickhull with the exact Orient3D: a point goes to the first face it is strictly above
+    // and each face adds its farthest point. Points inside the hull of the extreme points
+    // along the axes and the cube diagonals are dropped in the first pass (Akl-Toussaint).
+    // Flat parts of the boundary stay triangulated and may keep vertices inside them, but no
+    // face is degenerate. Empty when all points are coplanar.
+    // Large batches of points are handed to the faces on threadCount threads, 0 means
+    // std::thread::hardware_concurrency(); the hull does not depend on it.
+    Hull3D Quickhull3D_Barber(const std::vector<Point3D>& points, int threadCount = 0);
+}
+
+#endif
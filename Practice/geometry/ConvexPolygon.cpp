@@ -0,0 +1,510 @@
+#include <algorithm>
+
+#include "ConvexPolygon.h"
+#include "PointLocation.h"
+
+namespace geometry
+{
+    namespace
+    {
+        bool IsLess(Point a, Point b)
+        {
+            return a.x < b.x || (a.x == b.x && a.y < b.y);
+        }
+
+        // Both chains from left to right. The lower one runs from the lowest to the lowest of
+        // the left and right most vertices, the upper one between the highest, so neither has
+        // a vertical edge.
+        void GetChains(const std::vector<Point>& polygon, std::vector<Point>& lower, std::vector<Point>& upper)
+        {
+            int n = int(polygon.size());
+            int start = int(std::min_element(polygon.begin(), polygon.end(), IsLess) - polygon.begin());
+            double minX = polygon[start].x;
+            double maxX = std::max_element(polygon.begin(), polygon.end(), IsLess)->x;
+
+            // Counter-clockwise the bottom comes first
+            int k = 0;
+            lower.clear();
+            lower.reserve(n);
+            for (; k < n; k++)
+            {
+                lower.push_back(polygon[(start + k) % n]);
+                if (lower.back().x == maxX)
+                {
+                    break;
+                }
+            }
+            while (k + 1 < n && polygon[(start + k + 1) % n].x == maxX)
+            {
+                k++;
+            }
+            upper.clear();
+            upper.reserve(n + 1);
+            for (; k <= n; k++)
+            {
+                upper.push_back(polygon[(start + k) % n]);
+                if (k > 0 && upper.back().x == minX)
+                {
+                    break;
+                }
+            }
+            std::reverse(upper.begin(), upper.end());
+        }
+
+        // A chain as a function of x, read at increasing x
+        class ChainCursor
+        {
+        public:
+            explicit ChainCursor(const std::vector<Point>& chain)
+                : chain(chain)
+            {
+            }
+
+            // Also tells whether x is the x of a vertex, the y is then exactly its y
+            double GetY(double x, bool& isVertex)
+            {
+                while (next + 1 < chain.size() && chain[next].x <= x)
+                {
+                    next++;
+                }
+                Point A = chain[next - 1];
+                Point B = chain[next];
+                isVertex = x == A.x || x == B.x;
+                if (x <= A.x)
+                {
+                    return A.y;
+                }
+                if (x >= B.x)
+                {
+                    return B.y;
+                }
+                return A.y + (x - A.x) * (B.y - A.y) / (B.x - A.x);
+            }
+
+        private:
+            const std::vector<Point>& chain;
+            size_t next = 1;
+        };
+
+        // The four chains at one x of the sweep
+        struct Sample
+        {
+            double x;
+            double lowerA;
+            double lowerB;
+            double upperA;
+            double upperB;
+            // The lower or upper envelope bends here
+            bool isLowerBend;
+            bool isUpperBend;
+
+            double GetLower() const
+            {
+                return std::max(lowerA, lowerB);
+            }
+
+            double GetUpper() const
+            {
+                return std::min(upperA, upperB);
+            }
+
+            double GetHeight() const
+            {
+                return GetUpper() - GetLower();
+            }
+        };
+
+        // Everything is linear between two samples
+        Sample Interpolate(const Sample& s, const Sample& t, double f)
+        {
+            auto mix = [f](double a, double b) { return a + f * (b - a); };
+            return { mix(s.x, t.x), mix(s.lowerA, t.lowerA), mix(s.lowerB, t.lowerB), mix(s.upperA, t.upperA), mix(s.upperB, t.upperB), false, false };
+        }
+
+        // Where a - b changes sign strictly between s and t, as a fraction
+        template <typename GetDifference>
+        bool GetCrossing(const Sample& s, const Sample& t, GetDifference difference, double& f)
+        {
+            double d0 = difference(s);
+            double d1 = difference(t);
+            if ((d0 < 0.0 && d1 > 0.0) || (d0 > 0.0 && d1 < 0.0))
+            {
+                f = d0 / (d0 - d1);
+                return true;
+            }
+            return false;
+        }
+
+        void PushPoint(std::vector<Point>& points, Point P)
+        {
+            if (points.empty() || points.back() != P)
+            {
+                points.push_back(P);
+            }
+        }
+
+        double GetEdgeTurn(Point u, Point v)
+        {
+            return Orient2D(Point(0.0, 0.0), u, v);
+        }
+    }
+
+    std::vector<Point> IntersectConvex(const std::vector<Point>& a, const std::vector<Point>& b)
+    {
+        if (a.size() < 3 || b.size() < 3)
+        {
+            return {};
+        }
+
+        GEOMETRY_STAGE(stage, "IntersectConvex/chains");
+        std::vector<Point> chains[4];
+        GetChains(a, chains[0], chains[2]);
+        GetChains(b, chains[1], chains[3]);
+        for (const std::vector<Point>& chain : chains)
+        {
+            if (chain.size() < 2)
+            {
+                // No area
+                return {};
+            }
+        }
+        double lo = std::max(chains[0].front().x, chains[1].front().x);
+        double hi = std::min(chains[0].back().x, chains[1].back().x);
+        if (lo > hi)
+        {
+            return {};
+        }
+
+        // The x of every vertex in [lo, hi], merged in linear time
+        GEOMETRY_NEXT_STAGE(stage, "IntersectConvex/sweep");
+        std::vector<double> xs;
+        std::vector<double> merged;
+        xs.reserve(a.size() + b.size() + 4);
+        merged.reserve(xs.capacity());
+        for (const std::vector<Point>& chain : chains)
+        {
+            size_t size = xs.size();
+            for (Point P : chain)
+            {
+                if (lo <= P.x && P.x <= hi)
+                {
+                    xs.push_back(P.x);
+                }
+            }
+            merged.resize(xs.size());
+            std::merge(xs.begin(), xs.begin() + size, xs.begin() + size, xs.end(), merged.begin());
+            xs.swap(merged);
+        }
+        xs.erase(std::unique(xs.begin(), xs.end()), xs.end());
+
+        ChainCursor cursors[4] = { ChainCursor(chains[0]), ChainCursor(chains[1]), ChainCursor(chains[2]), ChainCursor(chains[3]) };
+        std::vector<Sample> samples;
+        samples.reserve(2 * xs.size());
+        for (double x : xs)
+        {
+            bool isVertex[4];
+            Sample sample;
+            sample.x = x;
+            sample.lowerA = cursors[0].GetY(x, isVertex[0]);
+            sample.lowerB = cursors[1].GetY(x, isVertex[1]);
+            sample.upperA = cursors[2].GetY(x, isVertex[2]);
+            sample.upperB = cursors[3].GetY(x, isVertex[3]);
+            // Chains meeting right at the x of a sample can cross there
+            sample.isLowerBend = (isVertex[0] && sample.lowerA >= sample.lowerB) || (isVertex[1] && sample.lowerB >= sample.lowerA) || sample.lowerA == sample.lowerB;
+            sample.isUpperBend = (isVertex[2] && sample.upperA <= sample.upperB) || (isVertex[3] && sample.upperB <= sample.upperA) || sample.upperA == sample.upperB;
+
+            // Where the chains of a and b cross the envelopes bend too
+            if (!samples.empty())
+            {
+                Sample previous = samples.back();
+                double lowerF = 2.0;
+                double upperF = 2.0;
+                bool isLowerCrossing = GetCrossing(previous, sample, [](const Sample& s) { return s.lowerA - s.lowerB; }, lowerF);
+                bool isUpperCrossing = GetCrossing(previous, sample, [](const Sample& s) { return s.upperA - s.upperB; }, upperF);
+                for (int k = 0; k < 2; k++)
+                {
+                    // The nearer one first
+                    bool isLower = (k == 0) == (lowerF <= upperF);
+                    if (isLower ? isLowerCrossing : isUpperCrossing)
+                    {
+                        Sample crossing = Interpolate(previous, sample, isLower ? lowerF : upperF);
+                        crossing.isLowerBend = isLower;
+                        crossing.isUpperBend = !isLower;
+                        samples.push_back(crossing);
+                    }
+                }
+            }
+            samples.push_back(sample);
+        }
+
+        // The upper envelope minus the lower one is concave, it is not negative on one run
+        GEOMETRY_NEXT_STAGE(stage, "IntersectConvex/clip");
+        int first = 0;
+        while (first < samples.size() && samples[first].GetHeight() < 0.0)
+        {
+            first++;
+        }
+        if (first == samples.size())
+        {
+            return {};
+        }
+        int last = first;
+        while (last + 1 < samples.size() && samples[last + 1].GetHeight() >= 0.0)
+        {
+            last++;
+        }
+
+        std::vector<Point> lower;
+        std::vector<Point> upper;
+        lower.reserve(last - first + 3);
+        upper.reserve(last - first + 3);
+        auto addEnd = [&](const Sample& s)
+        {
+            PushPoint(lower, Point(s.x, s.GetLower()));
+            PushPoint(upper, Point(s.x, s.GetUpper()));
+        };
+        auto getHeight = [](const Sample& s) { return s.GetHeight(); };
+
+        double f;
+        if (first > 0 && GetCrossing(samples[first - 1], samples[first], getHeight, f))
+        {
+            Sample entry = Interpolate(samples[first - 1], samples[first], f);
+            Point P(entry.x, (entry.GetLower() + entry.GetUpper()) / 2.0);
+            lower.push_back(P);
+            upper.push_back(P);
+        }
+        for (int i = first; i <= last; i++)
+        {
+            const Sample& s = samples[i];
+            if (i == first || i == last)
+            {
+                addEnd(s);
+                continue;
+            }
+            if (s.isLowerBend)
+            {
+                PushPoint(lower, Point(s.x, s.GetLower()));
+            }
+            if (s.isUpperBend)
+            {
+                PushPoint(upper, Point(s.x, s.GetUpper()));
+            }
+        }
+        if (last + 1 < samples.size() && GetCrossing(samples[last], samples[last + 1], getHeight, f))
+        {
+            Sample exit = Interpolate(samples[last], samples[last + 1], f);
+            Point P(exit.x, (exit.GetLower() + exit.GetUpper()) / 2.0);
+            PushPoint(lower, P);
+            PushPoint(upper, P);
+        }
+
+        // Counter-clockwise: the lower chain and back along the upper one
+        std::vector<Point> result;
+        result.reserve(lower.size() + upper.size());
+        result = lower;
+        for (int i = int(upper.size()) - 1; i >= 0; i--)
+        {
+            PushPoint(result, upper[i]);
+        }
+        while (result.size() > 1 && result.back() == result.front())
+        {
+            result.pop_back();
+        }
+        return result;
+    }
+
+    std::vector<Point> GetMinkowskiSum(const std::vector<Point>& a, const std::vector<Point>& b)
+    {
+        if (a.empty() || b.empty())
+        {
+            return {};
+        }
+
+        // Both start at the lowest vertex, the one with the smallest x among them
+        auto isLower = [](Point p, Point q) { return p.y < q.y || (p.y == q.y && p.x < q.x); };
+        int n = int(a.size());
+        int m = int(b.size());
+        int i0 = int(std::min_element(a.begin(), a.end(), isLower) - a.begin());
+        int j0 = int(std::min_element(b.begin(), b.end(), isLower) - b.begin());
+
+        GEOMETRY_STAGE(stage, "MinkowskiSum/merge");
+        std::vector<Point> sum;
+        sum.reserve(n + m);
+        int i = 0;
+        int j = 0;
+        while (i < n || j < m)
+        {
+            Point A = a[(i0 + i) % n];
+            Point B = b[(j0 + j) % m];
+            sum.push_back(A + B);
+            if (i == n)
+            {
+                j++;
+                continue;
+            }
+            if (j == m)
+            {
+                i++;
+                continue;
+            }
+            // The sums themselves decide, they are what the hull of all sums is made of
+            double turn = Orient2D(A + B, a[(i0 + i + 1) % n] + B, A + b[(j0 + j + 1) % m]);
+            // Parallel edges go one after the other, the vertex between them is pushed too
+            // since it can be a corner once the sums are rounded
+            i += turn >= 0.0;
+            j += turn < 0.0;
+        }
+
+        // Parallel edges leave a vertex on a line
+        GEOMETRY_NEXT_STAGE(stage, "MinkowskiSum/clean");
+        std::vector<Point> result;
+        result.reserve(sum.size());
+        for (Point P : sum)
+        {
+            while (result.size() >= 2 && Orient2D(result[result.size() - 2], result.back(), P) <= 0.0)
+            {
+                result.pop_back();
+            }
+            if (result.empty() || result.back() != P)
+            {
+                result.push_back(P);
+            }
+        }
+        while (result.size() >= 3 && Orient2D(result[result.size() - 2], result.back(), result[0]) <= 0.0)
+        {
+            result.pop_back();
+        }
+        return result;
+    }
+
+    int GetExtremeVertex(const std::vector<Point>& polygon, Point direction)
+    {
+        int n = int(polygon.size());
+        if (n < 3)
+        {
+            int best = 0;
+            for (int i = 1; i < n; i++)
+            {
+                if (polygon[i] * direction > polygon[best] * direction)
+                {
+                    best = i;
+                }
+            }
+            return best;
+        }
+
+        // The edges turn left all the way round. Angles are measured from the first edge, the
+        // extreme vertex starts the first edge at or past the left normal of the direction.
+        Point base = polygon[1] - polygon[0];
+        auto getHalf = [&](Point u)
+        {
+            double turn = GetEdgeTurn(base, u);
+            return turn > 0.0 || (turn == 0.0 && base * u > 0.0) ? 0 : 1;
+        };
+        auto isBefore = [&](Point u, Point v)
+        {
+            int halfU = getHalf(u);
+            int halfV = getHalf(v);
+            return halfU != halfV ? halfU < halfV : GetEdgeTurn(u, v) > 0.0;
+        };
+
+        Point normal = ~direction;
+        int lo = 0;
+        int hi = n;
+        while (lo < hi)
+        {
+            int mid = lo + (hi - lo) / 2;
+            if (isBefore(polygon[(mid + 1) % n] - polygon[mid], normal))
+            {
+                lo = mid + 1;
+            }
+            else
+            {
+                hi = mid;
+            }
+        }
+        return lo % n;
+    }
+
+    bool GetTangents(const std::vector<Point>& polygon, Point P, int& first, int& second)
+    {
+        int n = int(polygon.size());
+        if (n < 3)
+        {
+            return false;
+        }
+        auto isVisible = [&](int i)
+        {
+            i %= n;
+            return Orient2D(polygon[i], polygon[(i + 1) % n], P) < 0.0;
+        };
+
+        // An edge P sees: the far edge of the fan triangle that has P in its angle, or one of
+        // the edges at the first vertex when P is outside the angle
+        int visible = -1;
+        if (Orient2D(polygon[0], polygon[1], P) > 0.0 && Orient2D(polygon[0], polygon[n - 1], P) < 0.0)
+        {
+            int i = GetFanIndex(polygon, 1.0, P);
+            if (isVisible(i))
+            {
+                visible = i;
+            }
+        }
+        else
+        {
+            for (int i : { n - 2, n - 1, 0, 1 })
+            {
+                if (isVisible(i))
+                {
+                    visible = i;
+                    break;
+                }
+            }
+        }
+        if (visible < 0)
+        {
+            return false;
+        }
+
+        // One it does not: an edge at the vertex furthest away from P as seen from the first
+        int hidden = GetExtremeVertex(polygon, polygon[0] - P);
+        if (isVisible(hidden))
+        {
+            hidden = (hidden + n - 1) % n;
+        }
+
+        // The seen edges are consecutive, one binary search for each end
+        int lo = 0;
+        int hi = (hidden - visible + n) % n;
+        while (hi - lo > 1)
+        {
+            int mid = lo + (hi - lo) / 2;
+            if (isVisible(visible + mid))
+            {
+                lo = mid;
+            }
+            else
+            {
+                hi = mid;
+            }
+        }
+        second = (visible + hi) % n;
+
+        lo = 0;
+        hi = (visible - hidden + n) % n;
+        while (hi - lo > 1)
+        {
+            int mid = lo + (hi - lo) / 2;
+            if (isVisible(hidden + mid))
+            {
+                hi = mid;
+            }
+            else
+            {
+                lo = mid;
+            }
+        }
+        first = (hidden + hi) % n;
+        return true;
+    }
+}
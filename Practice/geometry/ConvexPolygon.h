@@ -0,0 +1,31 @@
+#ifndef CONVEX_POLYGON_H
+#define CONVEX_POLYGON_H
+
+#include <vector>
+
+#include "Geometry.h"
+
+namespace geometry
+{
+    // Operations on strictly convex counter-clockwise polygons, the hulls MonotoneChain_Andrews()
+    // returns. Any vertex may come first.
+
+    // The common part, in linear time: both are cut into lower and upper chains and swept
+    // left to right together. Starts at the lowest of the left most vertices like the hulls.
+    // Empty when they do not meet, a point or a segment when they only touch.
+    std::vector<Point> IntersectConvex(const std::vector<Point>& a, const std::vector<Point>& b);
+
+    // All sums of a point of a and a point of b, in linear time by merging the edges by angle.
+    // Starts at the lowest vertex.
+    std::vector<Point> GetMinkowskiSum(const std::vector<Point>& a, const std::vector<Point>& b);
+
+    // The vertex furthest in the direction, O(log n) by a binary search over the angles of
+    // the edges. The first one when an edge is perpendicular to the direction.
+    int GetExtremeVertex(const std::vector<Point>& polygon, Point direction);
+
+    // The vertices where the lines from P touch the polygon, O(log n). Going counter-clockwise
+    // from first to second are the edges P sees. False when P is inside or on the boundary.
+    bool GetTangents(const std::vector<Point>& polygon, Point P, int& first, int& second);
+}
+
+#endif
@@ -0,0 +1,456 @@
+#include <algorithm>
+#include <cstdint>
+#include <random>
+
+#include "Delaunay.h"
+#include "Hilbert.h"
+
+namespace geometry
+{
+    namespace
+    {
+        const int MaxRound = 24;
+
+        // BRIO: every point lands in a round with probability 1/2, 1/4, 1/8 ... of being
+        // in the last, second to last ... round. Rounds go from the smallest to the largest
+        // and each one is walked along a Hilbert curve.
+        std::vector<int> GetInsertionOrder(const std::vector<Point>& points)
+        {
+            Point min = points[0];
+            Point max = points[0];
+            for (const Point& P : points)
+            {
+                min = Point(std::min(min.x, P.x), std::min(min.y, P.y));
+                max = Point(std::max(max.x, P.x), std::max(max.y, P.y));
+            }
+
+            const double cells = double((1u << HilbertOrder) - 1);
+            double scaleX = max.x > min.x ? cells / (max.x - min.x) : 0.0;
+            double scaleY = max.y > min.y ? cells / (max.y - min.y) : 0.0;
+
+            std::mt19937_64 random(0x5eed);
+            std::vector<SpatialKey> keys(points.size());
+            for (int i = 0; i < points.size(); i++)
+            {
+                uint64_t bits = random();
+                int round = 0;
+                while (round < MaxRound && (bits & 1))
+                {
+                    bits >>= 1;
+                    round++;
+                }
+
+                uint32_t x = uint32_t((points[i].x - min.x) * scaleX);
+                uint32_t y = uint32_t((points[i].y - min.y) * scaleY);
+                keys[i] = { (uint64_t(MaxRound - round) << 32) | GetHilbertKey(x, y), i };
+            }
+            RadixSort(keys);
+
+            std::vector<int> order(points.size());
+            for (int i = 0; i < keys.size(); i++)
+            {
+                order[i] = keys[i].index;
+            }
+            return order;
+        }
+
+        struct BoundaryEdge
+        {
+            int u;
+            int v;
+            int outer;
+        };
+
+        // Triangles are kept closed over the plane with "ghost" triangles: every hull edge
+        // a -> b has a ghost triangle (b, a, ghost), so every half-edge has a twin and points
+        // outside the hull are inserted the same way as points inside.
+        // Internally vertices are numbered in insertion order, so neighbours in the mesh are
+        // also neighbours in memory.
+        class DelaunayBuilder
+        {
+        public:
+            explicit DelaunayBuilder(const std::vector<Point>& points)
+                : points(points), ghost(int(points.size())), edgeFromVertex(points.size() + 1)
+            {
+                if (!points.empty())
+                {
+                    order = GetInsertionOrder(points);
+                }
+
+                vertices.reserve(points.size());
+                for (int i : order)
+                {
+                    vertices.push_back(points[i]);
+                }
+
+                triangles.reserve(6 * points.size() + 12);
+                halfedges.reserve(6 * points.size() + 12);
+                marks.reserve(2 * points.size() + 4);
+            }
+
+            Triangulation Build()
+            {
+                Triangulation result;
+                if (points.empty())
+                {
+                    return result;
+                }
+
+                int a = 0;
+                int b = -1;
+                int c = -1;
+                for (int i = 1; i < vertices.size(); i++)
+                {
+                    if (b == -1 && vertices[i] != vertices[a])
+                    {
+                        b = i;
+                    }
+                    else if (b != -1 && Orient2D(vertices[a], vertices[b], vertices[i]) != 0.0)
+                    {
+                        c = i;
+                        break;
+                    }
+                }
+
+                if (c == -1)
+                {
+                    result.hull = GetColinearHull();
+                    return result;
+                }
+
+                if (Orient2D(vertices[a], vertices[b], vertices[c]) < 0.0)
+                {
+                    std::swap(b, c);
+                }
+                CreateFirstTriangle(a, b, c);
+
+                for (int i = 1; i < vertices.size(); i++)
+                {
+                    if (i != b && i != c)
+                    {
+                        Insert(i);
+                    }
+                }
+
+                Extract(result);
+                return result;
+            }
+
+        private:
+            bool IsGhost(int t) const
+            {
+                return triangles[3 * t + 2] == ghost;
+            }
+
+            int AddTriangle()
+            {
+                int t = int(marks.size());
+                triangles.resize(3 * t + 3);
+                halfedges.resize(3 * t + 3);
+                marks.push_back(0);
+                return t;
+            }
+
+            void Link(int e, int f)
+            {
+                halfedges[e] = f;
+                halfedges[f] = e;
+            }
+
+            // Writes the triangle (u, v, p) rotated so a ghost vertex ends up last.
+            // Returns the rotation, the half-edge u -> v is 3 * t + rotation.
+            int SetTriangle(int t, int u, int v, int p)
+            {
+                int rotation = v == ghost ? 1 : (u == ghost ? 2 : 0);
+                triangles[3 * t + rotation] = u;
+                triangles[3 * t + (rotation + 1) % 3] = v;
+                triangles[3 * t + (rotation + 2) % 3] = p;
+                return rotation;
+            }
+
+            void CreateFirstTriangle(int a, int b, int c)
+            {
+                int t = AddTriangle();
+                int ab = AddTriangle();
+                int bc = AddTriangle();
+                int ca = AddTriangle();
+                SetTriangle(t, a, b, c);
+                SetTriangle(ab, b, a, ghost);
+                SetTriangle(bc, c, b, ghost);
+                SetTriangle(ca, a, c, ghost);
+
+                Link(3 * t, 3 * ab);
+                Link(3 * t + 1, 3 * bc);
+                Link(3 * t + 2, 3 * ca);
+                Link(3 * ab + 1, 3 * ca + 2);
+                Link(3 * ab + 2, 3 * bc + 1);
+                Link(3 * bc + 2, 3 * ca + 1);
+                hint = t;
+            }
+
+            uint32_t NextRandom()
+            {
+                random ^= random << 13;
+                random ^= random >> 17;
+                random ^= random << 5;
+                return random;
+            }
+
+            // Stochastic visibility walk from the last created triangle. Stops at a real triangle
+            // containing P or at the ghost triangle of a hull edge that P sees from outside.
+            int Locate(Point P)
+            {
+                int t = hint;
+                int from = -1;
+                while (!IsGhost(t))
+                {
+                    int start = NextRandom() % 3;
+                    int next = -1;
+                    for (int k = 0; k < 3; k++)
+                    {
+                        int e = 3 * t + (start + k) % 3;
+                        if (e == from)
+                        {
+                            continue;
+                        }
+
+                        Point A = vertices[triangles[e]];
+                        Point B = vertices[triangles[NextHalfEdge(e)]];
+                        if (Orient2D(A, B, P) < 0.0)
+                        {
+                            next = halfedges[e];
+                            break;
+                        }
+                    }
+
+                    if (next == -1)
+                    {
+                        return t;
+                    }
+                    from = next;
+                    t = next / 3;
+                }
+                return t;
+            }
+
+            bool IsInConflict(int t, Point P) const
+            {
+                Point A = vertices[triangles[3 * t]];
+                Point B = vertices[triangles[3 * t + 1]];
+                if (IsGhost(t))
+                {
+                    double area = Orient2D(A, B, P);
+                    if (area != 0.0)
+                    {
+                        return area > 0.0;
+                    }
+                    // P is on the hull line, it conflicts only when it splits the hull edge
+                    return (P - A) * (B - A) > 0.0 && (P - B) * (A - B) > 0.0;
+                }
+
+                Point C = vertices[triangles[3 * t + 2]];
+                return InCircle(A, B, C, P) > 0.0;
+            }
+
+            void Insert(int i)
+            {
+                Point P = vertices[i];
+                int t = Locate(P);
+                if (!IsGhost(t))
+                {
+                    for (int k = 0; k < 3; k++)
+                    {
+                        if (vertices[triangles[3 * t + k]] == P)
+                        {
+                            return;
+                        }
+                    }
+                }
+
+                stamp += 2;
+                cavity.clear();
+                boundary.clear();
+                cavity.push_back(t);
+                marks[t] = stamp;
+                for (int k = 0; k < cavity.size(); k++)
+                {
+                    int c = cavity[k];
+                    for (int e = 3 * c; e < 3 * c + 3; e++)
+                    {
+                        int outer = halfedges[e];
+                        int n = outer / 3;
+                        if (marks[n] == stamp)
+                        {
+                            continue;
+                        }
+
+                        if (marks[n] != stamp + 1 && IsInConflict(n, P))
+                        {
+                            marks[n] = stamp;
+                            cavity.push_back(n);
+                        }
+                        else
+                        {
+                            marks[n] = stamp + 1;
+                            boundary.push_back({ triangles[e], triangles[NextHalfEdge(e)], outer });
+                        }
+                    }
+                }
+
+                // The cavity is a disk around P, so its boundary has two more edges than it has triangles
+                while (cavity.size() < boundary.size())
+                {
+                    cavity.push_back(AddTriangle());
+                }
+
+                for (int k = 0; k < boundary.size(); k++)
+                {
+                    const BoundaryEdge& edge = boundary[k];
+                    int t = cavity[k];
+                    int rotation = SetTriangle(t, edge.u, edge.v, i);
+                    Link(3 * t + rotation, edge.outer);
+                    edgeFromVertex[edge.u] = 3 * t + (rotation + 2) % 3;
+                    marks[t] = 0;
+                    if (edge.u != ghost && edge.v != ghost)
+                    {
+                        hint = t;
+                    }
+                }
+
+                for (int k = 0; k < boundary.size(); k++)
+                {
+                    const BoundaryEdge& edge = boundary[k];
+                    int pu = edgeFromVertex[edge.u];
+                    Link(PrevHalfEdge(pu), edgeFromVertex[edge.v]);
+                }
+            }
+
+            std::vector<int> GetColinearHull() const
+            {
+                auto compareByXThenByY = [&](int a, int b)
+                {
+                    if (points[a].x == points[b].x)
+                    {
+                        return points[a].y < points[b].y;
+                    }
+                    return points[a].x < points[b].x;
+                };
+
+                std::vector<int> hull;
+                int first = 0;
+                int last = 0;
+                for (int i = 1; i < points.size(); i++)
+                {
+                    if (compareByXThenByY(i, first))
+                    {
+                        first = i;
+                    }
+                    if (compareByXThenByY(last, i))
+                    {
+                        last = i;
+                    }
+                }
+
+                hull.push_back(first);
+                if (points[first] != points[last])
+                {
+                    hull.push_back(last);
+                }
+                return hull;
+            }
+
+            void Extract(Triangulation& result) const
+            {
+                int triangleCount = int(marks.size());
+                std::vector<int> index(triangleCount, -1);
+                int realCount = 0;
+                int firstGhost = -1;
+                for (int t = 0; t < triangleCount; t++)
+                {
+                    if (IsGhost(t))
+                    {
+                        firstGhost = t;
+                    }
+                    else
+                    {
+                        index[t] = realCount++;
+                    }
+                }
+
+                result.triangles.resize(3 * realCount);
+                result.halfedges.resize(3 * realCount);
+                for (int t = 0; t < triangleCount; t++)
+                {
+                    if (index[t] == -1)
+                    {
+                        continue;
+                    }
+
+                    for (int k = 0; k < 3; k++)
+                    {
+                        int twin = halfedges[3 * t + k];
+                        result.triangles[3 * index[t] + k] = order[triangles[3 * t + k]];
+                        result.halfedges[3 * index[t] + k] = index[twin / 3] == -1 ? -1 : 3 * index[twin / 3] + twin % 3;
+                    }
+                }
+
+                // Ghost (b, a, ghost) stands for the hull edge a -> b, and its last half-edge
+                // leads to the ghost of the following hull edge
+                std::vector<int> boundaryVertices;
+                int t = firstGhost;
+                do
+                {
+                    boundaryVertices.push_back(triangles[3 * t + 1]);
+                    t = halfedges[3 * t + 2] / 3;
+                } while (t != firstGhost);
+
+                int size = int(boundaryVertices.size());
+                for (int i = 0; i < size; i++)
+                {
+                    Point L = vertices[boundaryVertices[(i + size - 1) % size]];
+                    Point B = vertices[boundaryVertices[i]];
+                    Point R = vertices[boundaryVertices[(i + 1) % size]];
+                    if (Orient2D(L, B, R) != 0.0)
+                    {
+                        result.hull.push_back(order[boundaryVertices[i]]);
+                    }
+                }
+
+                auto compareByXThenByY = [&](int a, int b)
+                {
+                    if (points[a].x == points[b].x)
+                    {
+                        return points[a].y < points[b].y;
+                    }
+                    return points[a].x < points[b].x;
+                };
+                std::rotate(result.hull.begin(), std::min_element(result.hull.begin(), result.hull.end(), compareByXThenByY), result.hull.end());
+            }
+
+            const std::vector<Point>& points;
+            const int ghost;
+            std::vector<int> order;
+            std::vector<Point> vertices;
+
+            std::vector<int> triangles;
+            std::vector<int> halfedges;
+            std::vector<uint32_t> marks;
+            uint32_t stamp = 0;
+
+            std::vector<int> cavity;
+            std::vector<BoundaryEdge> boundary;
+            std::vector<int> edgeFromVertex;
+
+            int hint = 0;
+            uint32_t random = 2463534242u;
+        };
+    }
+
+    Triangulation DelaunayTriangulation(const std::vector<Point>& points)
+    {
+        GEOMETRY_STAGE(stage, "Delaunay/order");
+        DelaunayBuilder builder(points);
+        GEOMETRY_NEXT_STAGE(stage, "Delaunay/insert");
+        return builder.Build();
+    }
+}
@@ -0,0 +1,37 @@
+#ifndef DELAUNAY_H
+#define DELAUNAY_H
+
+#include <vector>
+
+#include "Geometry.h"
+
+namespace geometry
+{
+    // Half-edge e belongs to triangle e / 3 and starts at vertex triangles[e].
+    // halfedges[e] is the opposite half-edge in the neighbouring triangle, or -1 on the hull.
+    // Triangles are counter-clockwise.
+    struct Triangulation
+    {
+        std::vector<int> triangles;
+        std::vector<int> halfedges;
+
+        // Convex hull without colinear vertices, counter-clockwise from the lowest x then y,
+        // the same order as MonotoneChain_Andrews
+        std::vector<int> hull;
+    };
+
+    inline int NextHalfEdge(int e)
+    {
+        return e % 3 == 2 ? e - 2 : e + 1;
+    }
+
+    inline int PrevHalfEdge(int e)
+    {
+        return e % 3 == 0 ? e + 2 : e - 1;
+    }
+
+    // Bowyer-Watson insertion in biased randomized Hilbert order. Duplicate points are skipped.
+    Triangulation DelaunayTriangulation(const std::vector<Point>& points);
+}
+
+#endif
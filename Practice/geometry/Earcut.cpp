@@ -0,0 +1,92 @@
+#include "Earcut.h"
+
+namespace geometry
+{
+    namespace
+    {
+        bool IsInsideTriangle(Point A, Point B, Point C, Point P)
+        {
+            Orientation ABP = GetOrientation(A, B, P);
+            Orientation BCP = GetOrientation(B, C, P);
+            Orientation CAP = GetOrientation(C, A, P);
+            bool hasClockwise = ABP == Orientation::Clockwise || BCP == Orientation::Clockwise || CAP == Orientation::Clockwise;
+            bool hasCounterClockwise = ABP == Orientation::CounterClockWise || BCP == Orientation::CounterClockWise || CAP == Orientation::CounterClockWise;
+            return !(hasClockwise && hasCounterClockwise);
+        }
+
+        // An ear must not have any other vertex of the polygon inside or on it
+        bool IsEmptyEar(const std::vector<Point>& polygon, int i)
+        {
+            int n = polygon.size();
+            Point A = polygon[i ? i - 1 : n - 1];
+            Point B = polygon[i];
+            Point C = polygon[(i + 1) % n];
+            for (int j = (i + 2) % n; j != (i ? i - 1 : n - 1); j = (j + 1) % n)
+            {
+                Point P = polygon[j];
+                if (P != A && P != B && P != C && IsInsideTriangle(A, B, C, P))
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+    }
+
+    std::vector<Triangle> Earcut(std::vector<Point> polygon)
+    {
+        GEOMETRY_STAGE(stage, "Earcut/orientation");
+        double orientation = 0.0;
+        for (int i = 0; i < polygon.size(); i++)
+        {
+            Point a = polygon[i];
+            Point b = polygon[(i + 1) % polygon.size()];
+            orientation += (a.x * b.y) - (a.y * b.x);
+        }
+
+        GEOMETRY_NEXT_STAGE(stage, "Earcut/clip");
+        std::vector<Triangle> triangles;
+        int i = 1;
+        int tested = 0;
+        while (polygon.size() > 3)
+        {
+            i %= polygon.size();
+            Point A = polygon[i ? i - 1 : polygon.size() - 1];
+            Point B = polygon[i];
+            Point C = polygon[(i + 1) % polygon.size()];
+            GEOMETRY_COUNT(EarsTested);
+            bool isEar = Orient2D(A, B, C) * orientation > 0 && IsEmptyEar(polygon, i);
+
+            if (A == B || B == C)
+            {
+                GEOMETRY_COUNT_ADD(EarcutMoves, polygon.size() - i - 1);
+                polygon.erase(polygon.begin() + i);
+                tested = 0;
+            }
+            else if (isEar)
+            {
+                GEOMETRY_COUNT(EarsClipped);
+                GEOMETRY_COUNT_ADD(EarcutMoves, polygon.size() - i - 1);
+                triangles.push_back({ A, B, C });
+                polygon.erase(polygon.begin() + i);
+                // Only the neighbours of the clipped vertex can have become ears
+                i = i ? i - 1 : 0;
+                tested = 0;
+            }
+            else if (++tested > polygon.size())
+            {
+                // A full lap without an ear, the polygon is not simple
+                return triangles;
+            }
+            else
+            {
+                i++;
+            }
+        }
+        if (polygon.size() == 3)
+        {
+            triangles.push_back({ polygon[2], polygon[0], polygon[1] });
+        }
+        return triangles;
+    }
+}
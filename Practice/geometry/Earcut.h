@@ -0,0 +1,14 @@
+#ifndef EARCUT_H
+#define EARCUT_H
+
+#include <vector>
+
+#include "Geometry.h"
+
+namespace geometry
+{
+    // Ear clipping of a simple polygon in either orientation, n - 2 triangles
+    std::vector<Triangle> Earcut(std::vector<Point> polygon);
+}
+
+#endif
@@ -0,0 +1,255 @@
+#include <algorithm>
+#include <random>
+
+#include "EnclosingCircle.h"
+#include "Parallel.h"
+
+namespace geometry
+{
+    namespace
+    {
+        // Fewer points than this are culled on the calling thread
+        const int ParallelBatch = 1 << 15;
+
+        // The points a circle goes through, three of them counter-clockwise
+        struct Support
+        {
+            Point points[3];
+            int size;
+        };
+
+        // Three points decide in doubles: within their rounding a point counts as on the
+        // circle, cocircular points would otherwise all go to exact arithmetic for a center
+        // that is rounded anyway
+        bool IsOutside(const Support& support, Point P)
+        {
+            const Point* S = support.points;
+            switch (support.size)
+            {
+            case 1: return P != S[0];
+            case 2: return InDiametralCircle(S[0], S[1], P) < 0.0;
+            default: return InCircleFiltered(S[0], S[1], S[2], P) < 0.0;
+            }
+        }
+
+        // No circle goes through three points on one line, the two farthest apart hold the third
+        Support GetSupport(Point A, Point B, Point C)
+        {
+            double area = Orient2D(A, B, C);
+            if (area == 0.0)
+            {
+                double ab = vecta::len(B - A);
+                double ac = vecta::len(C - A);
+                double bc = vecta::len(C - B);
+                if (ab >= ac && ab >= bc)
+                {
+                    return { { A, B }, 2 };
+                }
+                return ac >= bc ? Support{ { A, C }, 2 } : Support{ { B, C }, 2 };
+            }
+            return area > 0.0 ? Support{ { A, B, C }, 3 } : Support{ { A, C, B }, 3 };
+        }
+
+        Circle GetCircle(const Support& support)
+        {
+            const Point* S = support.points;
+            Point center = S[0];
+            if (support.size == 2)
+            {
+                center = (S[0] + S[1]) / 2.0;
+            }
+            else if (support.size == 3)
+            {
+                // The circumcenter from A
+                Point AB = S[1] - S[0];
+                Point AC = S[2] - S[0];
+                double ab2 = AB * AB;
+                double ac2 = AC * AC;
+                double d = 2.0 * (AB ^ AC);
+                center = S[0] + Point(AC.y * ab2 - AB.y * ac2, AB.x * ac2 - AC.x * ab2) / d;
+            }
+            double radius = 0.0;
+            for (int i = 0; i < support.size; i++)
+            {
+                radius = std::max(radius, vecta::len(S[i] - center));
+            }
+            return { center, radius };
+        }
+
+        // Points in random order. Each loop keeps the circle of the points so far with the
+        // points of the loops outside it on the boundary.
+        Circle GetWelzlCircle(const std::vector<Point>& points)
+        {
+            int n = int(points.size());
+            if (n == 0)
+            {
+                return { Point(0.0, 0.0), -1.0 };
+            }
+            Support support = { { points[0] }, 1 };
+            for (int i = 1; i < n; i++)
+            {
+                if (!IsOutside(support, points[i]))
+                {
+                    continue;
+                }
+                support = { { points[i] }, 1 };
+                for (int j = 0; j < i; j++)
+                {
+                    if (!IsOutside(support, points[j]))
+                    {
+                        continue;
+                    }
+                    support = { { points[i], points[j] }, 2 };
+                    for (int k = 0; k < j; k++)
+                    {
+                        if (IsOutside(support, points[k]))
+                        {
+                            support = GetSupport(points[i], points[j], points[k]);
+                        }
+                    }
+                }
+            }
+            return GetCircle(support);
+        }
+
+        // Counter-clockwise from the right most point, the directions an octagon of extreme
+        // points is taken along
+        const double Directions[8][2] = { { 1, 0 }, { 1, 1 }, { 0, 1 }, { -1, 1 }, { -1, 0 }, { -1, -1 }, { 0, -1 }, { 1, -1 } };
+
+        std::vector<Point> GetOctagon(const Point* points, int n, int threadCount)
+        {
+            struct Extremes
+            {
+                int index[8];
+                double value[8];
+            };
+            std::vector<Extremes> chunks(threadCount);
+            for (Extremes& extremes : chunks)
+            {
+                std::fill(extremes.index, extremes.index + 8, -1);
+            }
+            ParallelFor(n, n >= ParallelBatch ? threadCount : 1, [&](int chunk, int begin, int end)
+            {
+                Extremes& extremes = chunks[chunk];
+                for (int i = begin; i < end; i++)
+                {
+                    for (int d = 0; d < 8; d++)
+                    {
+                        double value = Directions[d][0] * points[i].x + Directions[d][1] * points[i].y;
+                        if (extremes.index[d] < 0 || value > extremes.value[d])
+                        {
+                            extremes.index[d] = i;
+                            extremes.value[d] = value;
+                        }
+                    }
+                }
+            });
+
+            std::vector<Point> octagon;
+            for (int d = 0; d < 8; d++)
+            {
+                int best = -1;
+                double value = 0.0;
+                for (const Extremes& extremes : chunks)
+                {
+                    if (extremes.index[d] >= 0 && (best < 0 || extremes.value[d] > value))
+                    {
+                        best = extremes.index[d];
+                        value = extremes.value[d];
+                    }
+                }
+                if (best >= 0 && (octagon.empty() || points[best] != octagon.back()))
+                {
+                    octagon.push_back(points[best]);
+                }
+            }
+            while (octagon.size() > 1 && octagon.back() == octagon.front())
+            {
+                octagon.pop_back();
+            }
+
+            // The directions are rounded, culling is only safe when the octagon is convex
+            for (int i = 0; i < octagon.size(); i++)
+            {
+                if (octagon.size() < 3 || Orient2D(octagon[i], octagon[(i + 1) % octagon.size()], octagon[(i + 2) % octagon.size()]) < 0.0)
+                {
+                    return std::vector<Point>();
+                }
+            }
+            return octagon;
+        }
+
+        Circle GetMinimumEnclosingCircle(const Point* points, int n, int threadCount)
+        {
+            GEOMETRY_STAGE(stage, "Circle/cull");
+            std::vector<Point> octagon = GetOctagon(points, n, threadCount);
+            int m = int(octagon.size());
+            std::vector<std::vector<Point>> chunks(threadCount);
+            ParallelFor(n, n >= ParallelBatch ? threadCount : 1, [&](int chunk, int begin, int end)
+            {
+                std::vector<Point>& kept = chunks[chunk];
+                for (int i = begin; i < end; i++)
+                {
+                    bool isInside = m > 0;
+                    for (int j = 0; j < m && isInside; j++)
+                    {
+                        isInside = Orient2D(octagon[j], octagon[j + 1 < m ? j + 1 : 0], points[i]) > 0.0;
+                    }
+                    if (!isInside)
+                    {
+                        kept.push_back(points[i]);
+                    }
+                }
+            });
+            std::vector<Point> kept;
+            for (const std::vector<Point>& chunk : chunks)
+            {
+                kept.insert(kept.end(), chunk.begin(), chunk.end());
+            }
+
+            GEOMETRY_NEXT_STAGE(stage, "Circle/welzl");
+            std::mt19937_64 random(1);
+            std::shuffle(kept.begin(), kept.end(), random);
+            return GetWelzlCircle(kept);
+        }
+    }
+
+    Circle Welzl(const std::vector<Point>& points, uint64_t seed)
+    {
+        GEOMETRY_STAGE(stage, "Welzl");
+        std::vector<Point> shuffled = points;
+        std::mt19937_64 random(seed);
+        std::shuffle(shuffled.begin(), shuffled.end(), random);
+        return GetWelzlCircle(shuffled);
+    }
+
+    Circle GetMinimumEnclosingCircle(const std::vector<Point>& points, int threadCount)
+    {
+        return GetMinimumEnclosingCircle(points.data(), int(points.size()), GetThreadCount(threadCount));
+    }
+
+    void GetMinimumEnclosingCircles(const std::vector<Point>& points, const std::vector<int>& offsets, std::vector<Circle>& circles, int threadCount)
+    {
+        GEOMETRY_STAGE(stage, "Circle/batch");
+        int count = offsets.empty() ? 0 : int(offsets.size()) - 1;
+        circles.resize(count);
+        ParallelFor(count, GetThreadCount(threadCount), [&](int, int begin, int end)
+        {
+            // Small clusters go to Welzl() as they are, through one buffer
+            std::vector<Point> cluster;
+            std::mt19937_64 random(1);
+            for (int i = begin; i < end; i++)
+            {
+                int n = offsets[i + 1] - offsets[i];
+                if (n >= ParallelBatch)
+                {
+                    circles[i] = GetMinimumEnclosingCircle(points.data() + offsets[i], n, 1);
+                    continue;
+                }
+                cluster.assign(points.begin() + offsets[i], points.begin() + offsets[i + 1]);
+                std::shuffle(cluster.begin(), cluster.end(), random);
+                circles[i] = GetWelzlCircle(cluster);
+            }
+        });
+    }
+}
@@ -0,0 +1,39 @@
+#ifndef ENCLOSING_CIRCLE_H
+#define ENCLOSING_CIRCLE_H
+
+#include <cstdint>
+#include <vector>
+
+#include "Geometry.h"
+
+namespace geometry
+{
+    // Radius -1 when there are no points
+    struct Circle
+    {
+        Point center;
+        double radius;
+    };
+
+    // The smallest circle around the points: Welzl's algorithm as three nested loops over the
+    // points in random order instead of recursion, O(n) expected. Whether a point is outside
+    // the circle of the two points holding it is decided exactly with InDiametralCircle(), of
+    // three with InCircleFiltered(): a point within its rounding counts as on the circle.
+    // Three points on one line go to the diameter of the two outer ones with Orient2D().
+    // InCircle is of degree four, coordinates up to about 1e75. The hull from
+    // MonotoneChain_Andrews() gives the same circle with fewer points.
+    Circle Welzl(const std::vector<Point>& points, uint64_t seed = 1);
+
+    // The same circle: only hull vertices can be on it, so points inside the octagon of the
+    // extreme points along the axes and diagonals are dropped in one pass (Akl-Toussaint)
+    // and Welzl() takes the rest. The pass is split over threadCount threads for large sets,
+    // 0 means std::thread::hardware_concurrency(); the circle does not depend on it.
+    Circle GetMinimumEnclosingCircle(const std::vector<Point>& points, int threadCount = 0);
+
+    // One circle per cluster: cluster i is points[offsets[i]] .. points[offsets[i + 1] - 1].
+    // Clusters are split over threadCount threads, 0 means std::thread::hardware_concurrency().
+    // Below 32768 points a cluster goes to Welzl() without culling.
+    void GetMinimumEnclosingCircles(const std::vector<Point>& points, const std::vector<int>& offsets, std::vector<Circle>& circles, int threadCount = 0);
+}
+
+#endif
@@ -0,0 +1,267 @@
+#include <algorithm>
+#include <random>
+
+#include "Generators.h"
+
+namespace geometry
+{
+    namespace
+    {
+        const double Pi = std::acos(-1.0);
+
+        // Sorted angles in [0, 2 Pi), one per vertex
+        std::vector<double> GetSortedAngles(int n, std::mt19937_64& random)
+        {
+            std::uniform_real_distribution<double> angle(0.0, 2.0 * Pi);
+            std::vector<double> angles(n);
+            for (double& a : angles)
+            {
+                a = angle(random);
+            }
+            std::sort(angles.begin(), angles.end());
+            angles.erase(std::unique(angles.begin(), angles.end()), angles.end());
+            return angles;
+        }
+    }
+
+    const char* ToString(PointDistribution distribution)
+    {
+        switch (distribution)
+        {
+        case PointDistribution::Uniform: return "uniform";
+        case PointDistribution::Disk: return "disk";
+        case PointDistribution::Circle: return "circle";
+        case PointDistribution::Gaussian: return "gaussian";
+        case PointDistribution::Clustered: return "clustered";
+        default: return "";
+        }
+    }
+
+    std::vector<Point> GetRandomPoints(PointDistribution distribution, int n, uint64_t seed)
+    {
+        std::mt19937_64 random(seed);
+        std::uniform_real_distribution<double> unit(0.0, 1.0);
+        std::uniform_real_distribution<double> coordinate(-1.0, 1.0);
+        std::uniform_real_distribution<double> angle(0.0, 2.0 * Pi);
+
+        std::vector<Point> points(n);
+        switch (distribution)
+        {
+        case PointDistribution::Uniform:
+            for (Point& p : points)
+            {
+                p = Point(coordinate(random), coordinate(random));
+            }
+            break;
+        case PointDistribution::Disk:
+            for (Point& p : points)
+            {
+                p = vecta::polar(std::sqrt(unit(random)), angle(random));
+            }
+            break;
+        case PointDistribution::Circle:
+            for (Point& p : points)
+            {
+                p = vecta::polar(1.0, angle(random));
+            }
+            break;
+        case PointDistribution::Gaussian:
+        {
+            std::normal_distribution<double> normal(0.0, 0.25);
+            for (Point& p : points)
+            {
+                p = Point(std::clamp(normal(random), -1.0, 1.0), std::clamp(normal(random), -1.0, 1.0));
+            }
+            break;
+        }
+        case PointDistribution::Clustered:
+        {
+            const int clusterCount = 32;
+            std::uniform_real_distribution<double> center(-0.9, 0.9);
+            std::vector<Point> centers(clusterCount);
+            for (Point& c : centers)
+            {
+                c = Point(center(random), center(random));
+            }
+
+            std::normal_distribution<double> normal(0.0, 0.02);
+            std::uniform_int_distribution<int> cluster(0, clusterCount - 1);
+            for (Point& p : points)
+            {
+                Point c = centers[cluster(random)];
+                p = Point(std::clamp(c.x + normal(random), -1.0, 1.0), std::clamp(c.y + normal(random), -1.0, 1.0));
+            }
+            break;
+        }
+        }
+        return points;
+    }
+
+    std::vector<Point3D> GetRandomPoints3D(PointDistribution distribution, int n, uint64_t seed)
+    {
+        std::mt19937_64 random(seed);
+        std::uniform_real_distribution<double> unit(0.0, 1.0);
+        std::uniform_real_distribution<double> coordinate(-1.0, 1.0);
+        std::normal_distribution<double> direction(0.0, 1.0);
+        auto getDirection = [&]()
+        {
+            Point3D d;
+            while (d == Point3D())
+            {
+                d = Point3D(direction(random), direction(random), direction(random));
+            }
+            return d / vecta::len(d);
+        };
+        auto clamp = [](const Point3D& p)
+        {
+            return Point3D(std::clamp(p.x, -1.0, 1.0), std::clamp(p.y, -1.0, 1.0), std::clamp(p.z, -1.0, 1.0));
+        };
+
+        std::vector<Point3D> points(n);
+        switch (distribution)
+        {
+        case PointDistribution::Uniform:
+            for (Point3D& p : points)
+            {
+                p = Point3D(coordinate(random), coordinate(random), coordinate(random));
+            }
+            break;
+        case PointDistribution::Disk:
+            for (Point3D& p : points)
+            {
+                p = getDirection() * std::cbrt(unit(random));
+            }
+            break;
+        case PointDistribution::Circle:
+            for (Point3D& p : points)
+            {
+                p = getDirection();
+            }
+            break;
+        case PointDistribution::Gaussian:
+        {
+            std::normal_distribution<double> normal(0.0, 0.25);
+            for (Point3D& p : points)
+            {
+                p = clamp(Point3D(normal(random), normal(random), normal(random)));
+            }
+            break;
+        }
+        case PointDistribution::Clustered:
+        {
+            const int clusterCount = 32;
+            std::uniform_real_distribution<double> center(-0.9, 0.9);
+            std::vector<Point3D> centers(clusterCount);
+            for (Point3D& c : centers)
+            {
+                c = Point3D(center(random), center(random), center(random));
+            }
+
+            std::normal_distribution<double> normal(0.0, 0.02);
+            std::uniform_int_distribution<int> cluster(0, clusterCount - 1);
+            for (Point3D& p : points)
+            {
+                p = clamp(centers[cluster(random)] + Point3D(normal(random), normal(random), normal(random)));
+            }
+            break;
+        }
+        }
+        return points;
+    }
+
+    std::vector<Point> GetConvexPolygon(int n, uint64_t seed)
+    {
+        std::mt19937_64 random(seed);
+        std::vector<Point> polygon;
+        for (double a : GetSortedAngles(n, random))
+        {
+            polygon.push_back(vecta::polar(1.0, a));
+        }
+        return polygon;
+    }
+
+    std::vector<Point> GetStarPolygon(int n, uint64_t seed)
+    {
+        std::mt19937_64 random(seed);
+        std::uniform_real_distribution<double> radius(0.2, 1.0);
+        std::vector<Point> polygon;
+        for (double a : GetSortedAngles(n, random))
+        {
+            polygon.push_back(vecta::polar(radius(random), a));
+        }
+        return polygon;
+    }
+
+    std::vector<Point> GetCombPolygon(int n, uint64_t seed)
+    {
+        std::mt19937_64 random(seed);
+        std::uniform_real_distribution<double> tip(0.5, 1.0);
+        std::uniform_real_distribution<double> gap(-0.9, -0.5);
+
+        std::vector<Point> polygon = { Point(-1.0, -1.0), Point(1.0, -1.0) };
+        int top = std::max(n - 2, 1);
+        for (int i = top - 1; i >= 0; i--)
+        {
+            double x = -1.0 + 2.0 * (i + 1) / (top + 1);
+            polygon.push_back(Point(x, i % 2 ? gap(random) : tip(random)));
+        }
+        return polygon;
+    }
+
+    std::vector<Point> GetOversampledPolygon(const std::vector<Point>& polygon, int factor, double noise, uint64_t seed)
+    {
+        std::mt19937_64 random(seed);
+        std::uniform_real_distribution<double> offset(-noise, noise);
+        std::vector<Point> result;
+        result.reserve(polygon.size() * factor);
+        for (int i = 0; i < polygon.size(); i++)
+        {
+            Point A = polygon[i];
+            Point B = polygon[(i + 1) % polygon.size()];
+            Point normal = ~(B - A);
+            result.push_back(A);
+            for (int j = 1; j < factor; j++)
+            {
+                double t = double(j) / factor;
+                result.push_back(A + t * (B - A) + offset(random) * normal);
+            }
+        }
+        return result;
+    }
+
+    void GetCombChains(const std::vector<Point>& comb, std::vector<Point>& upperChain, std::vector<Point>& lowerChain)
+    {
+        upperChain.assign(comb.rbegin(), comb.rend() - 2);
+        lowerChain.assign(comb.begin(), comb.begin() + 2);
+    }
+
+    std::vector<std::vector<Point>> GetParcels(int n, double jitter, uint64_t seed)
+    {
+        std::mt19937_64 random(seed);
+        int side = std::max(1, int(std::ceil(std::sqrt(double(n)))));
+        double size = 2.0 / side;
+        std::uniform_real_distribution<double> offset(-jitter * size, jitter * size);
+        std::vector<Point> grid((side + 1) * (side + 1));
+        for (int i = 0; i <= side; i++)
+        {
+            for (int j = 0; j <= side; j++)
+            {
+                // The border stays on the square
+                double dx = i > 0 && i < side ? offset(random) : 0.0;
+                double dy = j > 0 && j < side ? offset(random) : 0.0;
+                grid[i * (side + 1) + j] = Point(-1.0 + i * size + dx, -1.0 + j * size + dy);
+            }
+        }
+
+        std::vector<std::vector<Point>> parcels;
+        parcels.reserve(n);
+        for (int cell = 0; cell < side * side && cell < n; cell++)
+        {
+            int i = cell / side;
+            int j = cell % side;
+            int corner = i * (side + 1) + j;
+            parcels.push_back({ grid[corner], grid[corner + side + 1], grid[corner + side + 2], grid[corner + 1] });
+        }
+        return parcels;
+    }
+}
@@ -0,0 +1,54 @@
+#ifndef GENERATORS_H
+#define GENERATORS_H
+
+#include <cstdint>
+#include <vector>
+
+#include "Geometry.h"
+
+namespace geometry
+{
+    // Seeded test inputs, the same seed always gives the same points on every platform
+    // that has the same std::mt19937_64 and libm. Everything fits in [-1, 1] x [-1, 1].
+
+    enum class PointDistribution
+    {
+        Uniform,    // the square
+        Disk,       // uniform in the unit disk
+        Circle,     // on the unit circle, every point is on the hull
+        Gaussian,   // sigma 0.25 around the origin
+        Clustered,  // 32 small gaussian clusters
+    };
+
+    const char* ToString(PointDistribution distribution);
+
+    std::vector<Point> GetRandomPoints(PointDistribution distribution, int n, uint64_t seed);
+
+    // The same distributions in the cube [-1, 1]^3: the disk becomes the ball and the circle
+    // the sphere
+    std::vector<Point3D> GetRandomPoints3D(PointDistribution distribution, int n, uint64_t seed);
+
+    // Counter-clockwise convex polygon with n vertices on the unit circle
+    std::vector<Point> GetConvexPolygon(int n, uint64_t seed);
+
+    // Counter-clockwise polygon with n vertices visible from the origin, radii in [0.2, 1]
+    std::vector<Point> GetStarPolygon(int n, uint64_t seed);
+
+    // Counter-clockwise x-monotone comb: the base from (-1, -1) to (1, -1) and n - 2 vertices
+    // alternating between the tips of the teeth and the gaps between them
+    std::vector<Point> GetCombPolygon(int n, uint64_t seed);
+
+    // Every edge split into factor edges, the new vertices moved off it by up to noise times
+    // its length: the near-collinear oversampling Simplify_Visvalingam() removes
+    std::vector<Point> GetOversampledPolygon(const std::vector<Point>& polygon, int factor, double noise, uint64_t seed);
+
+    // The upper and lower chains of GetCombPolygon() for GetPointLocationMonotone()
+    void GetCombChains(const std::vector<Point>& comb, std::vector<Point>& upperChain, std::vector<Point>& lowerChain);
+
+    // Counter-clockwise quadrilaterals of a grid over the square sharing their edges, the first
+    // n cells. The inner grid points move by up to jitter times the cell size, below
+    // 0.25 the cells stay simple; 0 keeps the edges vertical and horizontal.
+    std::vector<std::vector<Point>> GetParcels(int n, double jitter, uint64_t seed);
+}
+
+#endif
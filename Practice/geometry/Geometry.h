@@ -0,0 +1,168 @@
+#ifndef GEOMETRY_H
+#define GEOMETRY_H
+
+#include <cmath>
+
+#include "Instrumentation.h"
+#include "vecta.h"
+
+namespace geometry
+{
+    typedef vecta::vec2d<double> Point;
+    typedef vecta::vec3d<double> Point3D;
+
+    struct Triangle
+    {
+        Point A;
+        Point B;
+        Point C;
+    };
+
+    enum class Orientation
+    {
+        Colinear,
+        Clockwise,
+        CounterClockWise,
+    };
+
+    // [ABP] = AB x AP
+    inline double GetAreaFromPoints(Point a, Point b, Point p)
+    {
+        GEOMETRY_COUNT(AreaFromPoints);
+        Point AB = b - a;
+        Point AP = p - a;
+        return AB ^ AP;
+    }
+
+    double Orient2DExact(Point a, Point b, Point p);
+    double InCircleExact(Point a, Point b, Point c, Point d);
+    double Orient3DExact(const Point3D& a, const Point3D& b, const Point3D& c, const Point3D& d);
+    double InDiametralCircleExact(Point a, Point b, Point p);
+
+    // Same sign as [ABP], but exact: positive when P is left of AB.
+    // Plain doubles decide unless the result is within the rounding error, then it is
+    // recomputed with exact expansion arithmetic.
+    inline double Orient2D(Point a, Point b, Point p)
+    {
+        GEOMETRY_COUNT(Orient2D);
+        const double errorBound = 3.3306690738754716e-16; // (3 + 16e) e, e = 2^-53
+        double detLeft = (a.x - p.x) * (b.y - p.y);
+        double detRight = (a.y - p.y) * (b.x - p.x);
+        double det = detLeft - detRight;
+        double detSum = std::abs(detLeft) + std::abs(detRight);
+        if (det > errorBound * detSum || -det > errorBound * detSum)
+        {
+            return det;
+        }
+        GEOMETRY_COUNT(Orient2DExact);
+        return Orient2DExact(a, b, p);
+    }
+
+    // InCircle() in plain doubles only: 0 when D is within the rounding error of the circle
+    inline double InCircleFiltered(Point a, Point b, Point c, Point d)
+    {
+        GEOMETRY_COUNT(InCircle);
+        const double errorBound = 1.1102230246251577e-15; // (10 + 96e) e
+        double adx = a.x - d.x;
+        double bdx = b.x - d.x;
+        double cdx = c.x - d.x;
+        double ady = a.y - d.y;
+        double bdy = b.y - d.y;
+        double cdy = c.y - d.y;
+
+        double bdxcdy = bdx * cdy;
+        double cdxbdy = cdx * bdy;
+        double aLift = adx * adx + ady * ady;
+
+        double cdxady = cdx * ady;
+        double adxcdy = adx * cdy;
+        double bLift = bdx * bdx + bdy * bdy;
+
+        double adxbdy = adx * bdy;
+        double bdxady = bdx * ady;
+        double cLift = cdx * cdx + cdy * cdy;
+
+        double det = aLift * (bdxcdy - cdxbdy) + bLift * (cdxady - adxcdy) + cLift * (adxbdy - bdxady);
+        double permanent = (std::abs(bdxcdy) + std::abs(cdxbdy)) * aLift
+                         + (std::abs(cdxady) + std::abs(adxcdy)) * bLift
+                         + (std::abs(adxbdy) + std::abs(bdxady)) * cLift;
+        return det > errorBound * permanent || -det > errorBound * permanent ? det : 0.0;
+    }
+
+    // Positive when D is inside the circle through the counter-clockwise triangle ABC
+    inline double InCircle(Point a, Point b, Point c, Point d)
+    {
+        double det = InCircleFiltered(a, b, c, d);
+        if (det != 0.0)
+        {
+            return det;
+        }
+        GEOMETRY_COUNT(InCircleExact);
+        return InCircleExact(a, b, c, d);
+    }
+
+    // Positive when D is above the plane through ABC, on the side ABC is counter-clockwise
+    // from: six times the volume of ABCD
+    inline double Orient3D(const Point3D& a, const Point3D& b, const Point3D& c, const Point3D& d)
+    {
+        GEOMETRY_COUNT(Orient3D);
+        const double errorBound = 7.7715611723761027e-16; // (7 + 56e) e
+        double adx = a.x - d.x;
+        double bdx = b.x - d.x;
+        double cdx = c.x - d.x;
+        double ady = a.y - d.y;
+        double bdy = b.y - d.y;
+        double cdy = c.y - d.y;
+        double adz = a.z - d.z;
+        double bdz = b.z - d.z;
+        double cdz = c.z - d.z;
+
+        double bdxcdy = bdx * cdy;
+        double cdxbdy = cdx * bdy;
+        double cdxady = cdx * ady;
+        double adxcdy = adx * cdy;
+        double adxbdy = adx * bdy;
+        double bdxady = bdx * ady;
+
+        double det = -(adz * (bdxcdy - cdxbdy) + bdz * (cdxady - adxcdy) + cdz * (adxbdy - bdxady));
+        double permanent = (std::abs(bdxcdy) + std::abs(cdxbdy)) * std::abs(adz)
+                         + (std::abs(cdxady) + std::abs(adxcdy)) * std::abs(bdz)
+                         + (std::abs(adxbdy) + std::abs(bdxady)) * std::abs(cdz);
+        if (det > errorBound * permanent || -det > errorBound * permanent)
+        {
+            return det;
+        }
+        GEOMETRY_COUNT(Orient3DExact);
+        return Orient3DExact(a, b, c, d);
+    }
+
+    // Positive when P is inside the circle with diameter AB: -(A - P) . (B - P), the angle
+    // APB is obtuse
+    inline double InDiametralCircle(Point a, Point b, Point p)
+    {
+        GEOMETRY_COUNT(InDiametralCircle);
+        const double errorBound = 3.3306690738754716e-16; // As Orient2D, two products of differences
+        double detX = (a.x - p.x) * (b.x - p.x);
+        double detY = (a.y - p.y) * (b.y - p.y);
+        double det = -(detX + detY);
+        double detSum = std::abs(detX) + std::abs(detY);
+        if (det > errorBound * detSum || -det > errorBound * detSum)
+        {
+            return det;
+        }
+        GEOMETRY_COUNT(InDiametralCircleExact);
+        return InDiametralCircleExact(a, b, p);
+    }
+
+    inline Orientation GetOrientation(Point a, Point b, Point p)
+    {
+        double area = Orient2D(a, b, p);
+        if (area == 0.0)
+        {
+            return Orientation::Colinear;
+        }
+        return area < 0.0 ? Orientation::Clockwise : Orientation::CounterClockWise;
+    }
+}
+
+#endif
@@ -0,0 +1,133 @@
+#include <algorithm>
+
+#include "Hilbert.h"
+
+namespace geometry
+{
+    namespace
+    {
+        // Below this a 2^16 bucket histogram costs more than comparing
+        const int RadixSortMin = 1 << 12;
+
+        template <typename GetPoint>
+        std::vector<int> GetSpatialOrder(int n, GetPoint getPoint, Point min, Point max, SpatialCurve curve)
+        {
+            std::vector<SpatialKey> keys(n);
+            if (curve == SpatialCurve::Hilbert)
+            {
+                for (int i = 0; i < n; i++)
+                {
+                    keys[i] = { GetHilbertKey(getPoint(i), min, max), i };
+                }
+            }
+            else
+            {
+                for (int i = 0; i < n; i++)
+                {
+                    keys[i] = { GetMortonKey(getPoint(i), min, max), i };
+                }
+            }
+            RadixSort(keys);
+
+            std::vector<int> order(n);
+            for (int i = 0; i < n; i++)
+            {
+                order[i] = keys[i].index;
+            }
+            return order;
+        }
+
+        template <typename GetPoint>
+        void GetBounds(int n, GetPoint getPoint, Point& min, Point& max)
+        {
+            min = n > 0 ? getPoint(0) : Point(0.0, 0.0);
+            max = min;
+            for (int i = 0; i < n; i++)
+            {
+                Point P = getPoint(i);
+                min = Point(std::min(min.x, P.x), std::min(min.y, P.y));
+                max = Point(std::max(max.x, P.x), std::max(max.y, P.y));
+            }
+        }
+    }
+
+    void RadixSort(std::vector<SpatialKey>& keys)
+    {
+        if (keys.size() < RadixSortMin)
+        {
+            std::sort(keys.begin(), keys.end(), [](const SpatialKey& a, const SpatialKey& b)
+            {
+                return a.key < b.key || (a.key == b.key && a.index < b.index);
+            });
+            return;
+        }
+
+        uint64_t maxKey = 0;
+        for (const SpatialKey& key : keys)
+        {
+            maxKey = std::max(maxKey, key.key);
+        }
+
+        std::vector<SpatialKey> buffer(keys.size());
+        std::vector<int> offsets(1 << 16);
+        for (int shift = 0; shift < 64 && (maxKey >> shift) != 0; shift += 16)
+        {
+            std::fill(offsets.begin(), offsets.end(), 0);
+            for (const SpatialKey& key : keys)
+            {
+                offsets[(key.key >> shift) & 0xffff]++;
+            }
+            if (offsets[(keys[0].key >> shift) & 0xffff] == keys.size())
+            {
+                continue;
+            }
+
+            int sum = 0;
+            for (int& offset : offsets)
+            {
+                int count = offset;
+                offset = sum;
+                sum += count;
+            }
+
+            for (const SpatialKey& key : keys)
+            {
+                buffer[offsets[(key.key >> shift) & 0xffff]++] = key;
+            }
+            keys.swap(buffer);
+        }
+    }
+
+    const char* ToString(SpatialCurve curve)
+    {
+        switch (curve)
+        {
+        case SpatialCurve::Hilbert: return "hilbert";
+        case SpatialCurve::Morton: return "morton";
+        default: return "";
+        }
+    }
+
+    std::vector<int> GetSpatialOrder(const std::vector<Point>& points, Point min, Point max, SpatialCurve curve)
+    {
+        return GetSpatialOrder(int(points.size()), [&](int i) { return points[i]; }, min, max, curve);
+    }
+
+    std::vector<int> GetSpatialOrder(const std::vector<Point>& points, SpatialCurve curve)
+    {
+        auto getPoint = [&](int i) { return points[i]; };
+        Point min;
+        Point max;
+        GetBounds(int(points.size()), getPoint, min, max);
+        return GetSpatialOrder(int(points.size()), getPoint, min, max, curve);
+    }
+
+    std::vector<int> GetSpatialOrder(const std::vector<double>& x, const std::vector<double>& y, SpatialCurve curve)
+    {
+        auto getPoint = [&](int i) { return Point(x[i], y[i]); };
+        Point min;
+        Point max;
+        GetBounds(int(x.size()), getPoint, min, max);
+        return GetSpatialOrder(int(x.size()), getPoint, min, max, curve);
+    }
+}
@@ -0,0 +1,149 @@
+#ifndef HILBERT_H
+#define HILBERT_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "Geometry.h"
+
+namespace geometry
+{
+    const int HilbertOrder = 16;
+
+    // The low 16 bits of x on the even bits of the result
+    inline uint32_t SpreadBits16(uint32_t x)
+    {
+        x = (x | (x << 8)) & 0x00ff00ffu;
+        x = (x | (x << 4)) & 0x0f0f0f0fu;
+        x = (x | (x << 2)) & 0x33333333u;
+        x = (x | (x << 1)) & 0x55555555u;
+        return x;
+    }
+
+    // Position of the cell (x, y) along a Hilbert curve over a 2^16 x 2^16 grid.
+    // The quadrant rotations of all levels are composed with a prefix scan over the bits,
+    // in log2(16) rounds of shifts and masks instead of a loop over the levels.
+    inline uint32_t GetHilbertKey(uint32_t x, uint32_t y)
+    {
+        // Four bit planes, each bit position the transform its level hands down; round k
+        // composes the transforms of 2^k consecutive levels
+        uint32_t A;
+        uint32_t B;
+        uint32_t C;
+        uint32_t D;
+        {
+            uint32_t a = x ^ y;
+            uint32_t b = 0xffff ^ a;
+            uint32_t c = 0xffff ^ (x | y);
+            uint32_t d = x & (y ^ 0xffff);
+            A = a | (b >> 1);
+            B = (a >> 1) ^ a;
+            C = ((c >> 1) ^ (b & (d >> 1))) ^ c;
+            D = ((a & (c >> 1)) ^ (d >> 1)) ^ d;
+        }
+        for (int shift = 2; shift < HilbertOrder; shift *= 2)
+        {
+            uint32_t a = A;
+            uint32_t b = B;
+            uint32_t c = C;
+            uint32_t d = D;
+            A = (a & (a >> shift)) ^ (b & (b >> shift));
+            B = (a & (b >> shift)) ^ (b & ((a ^ b) >> shift));
+            C ^= (a & (c >> shift)) ^ (b & (d >> shift));
+            D ^= (b & (c >> shift)) ^ ((a ^ b) & (d >> shift));
+        }
+
+        uint32_t a = C ^ (C >> 1);
+        uint32_t b = D ^ (D >> 1);
+        uint32_t low = x ^ y;
+        uint32_t high = b | (0xffff ^ (low | a));
+        return (SpreadBits16(high) << 1) | SpreadBits16(low);
+    }
+
+    // Same, with the grid stretched over [min, max]. Points outside are clamped to it.
+    inline uint32_t GetHilbertKey(Point P, Point min, Point max)
+    {
+        const double cells = double((1u << HilbertOrder) - 1);
+        double x = max.x > min.x ? (P.x - min.x) * (cells / (max.x - min.x)) : 0.0;
+        double y = max.y > min.y ? (P.y - min.y) * (cells / (max.y - min.y)) : 0.0;
+        return GetHilbertKey(uint32_t(std::min(std::max(x, 0.0), cells)), uint32_t(std::min(std::max(y, 0.0), cells)));
+    }
+
+    const int MortonOrder = 32;
+
+    // The bits of x on the even bits of the result
+    inline uint64_t SpreadBits(uint32_t x)
+    {
+        uint64_t v = x;
+        v = (v | (v << 16)) & 0x0000ffff0000ffffull;
+        v = (v | (v << 8)) & 0x00ff00ff00ff00ffull;
+        v = (v | (v << 4)) & 0x0f0f0f0f0f0f0f0full;
+        v = (v | (v << 2)) & 0x3333333333333333ull;
+        v = (v | (v << 1)) & 0x5555555555555555ull;
+        return v;
+    }
+
+    // Position of the cell (x, y) along a Z-order curve over a 2^32 x 2^32 grid: the bits of x
+    // and y interleaved
+    inline uint64_t GetMortonKey(uint32_t x, uint32_t y)
+    {
+        return SpreadBits(x) | (SpreadBits(y) << 1);
+    }
+
+    inline uint64_t GetMortonKey(Point P, Point min, Point max)
+    {
+        const double cells = 4294967295.0; // 2^32 - 1
+        double x = max.x > min.x ? (P.x - min.x) * (cells / (max.x - min.x)) : 0.0;
+        double y = max.y > min.y ? (P.y - min.y) * (cells / (max.y - min.y)) : 0.0;
+        return GetMortonKey(uint32_t(std::min(std::max(x, 0.0), cells)), uint32_t(std::min(std::max(y, 0.0), cells)));
+    }
+
+    struct SpatialKey
+    {
+        uint64_t key;
+        int index;
+    };
+
+    // A key in the order of the doubles: the bits with negatives flipped and positives above
+    // them, -0 the same as 0
+    inline uint64_t GetSortKey(double value)
+    {
+        value += 0.0;
+        uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return bits >> 63 ? ~bits : bits | (uint64_t(1) << 63);
+    }
+
+    // Stable: LSD radix sort over 16-bit digits, only as many passes as the largest key
+    // needs and none for a digit all keys share. Small inputs go to std::sort.
+    void RadixSort(std::vector<SpatialKey>& keys);
+
+    // Hilbert keeps neighbours on the curve closer in the plane, Morton keys are cheaper
+    enum class SpatialCurve
+    {
+        Hilbert,
+        Morton,
+    };
+
+    const char* ToString(SpatialCurve curve);
+
+    // Indices of the points in the order a curve over [min, max] visits them: order[i] is
+    // the point that comes i-th. Batches of queries walked in this order reuse each other's
+    // cache lines.
+    std::vector<int> GetSpatialOrder(const std::vector<Point>& points, Point min, Point max, SpatialCurve curve = SpatialCurve::Hilbert);
+
+    // Over the bounds of the points
+    std::vector<int> GetSpatialOrder(const std::vector<Point>& points, SpatialCurve curve = SpatialCurve::Hilbert);
+
+    // The same with the coordinates in two arrays
+    std::vector<int> GetSpatialOrder(const std::vector<double>& x, const std::vector<double>& y, SpatialCurve curve = SpatialCurve::Hilbert);
+
+    inline std::vector<int> GetHilbertOrder(const std::vector<Point>& points, Point min, Point max)
+    {
+        return GetSpatialOrder(points, min, max, SpatialCurve::Hilbert);
+    }
+}
+
+#endif
@@ -0,0 +1,81 @@
+#include <cstdint>
+#include <numeric>
+
+#include "Hilbert.h"
+#include "HilbertRTree.h"
+
+namespace geometry
+{
+    Box GetBoundingBox(const std::vector<Point>& points)
+    {
+        Box box = { points[0], points[0] };
+        for (const Point& P : points)
+        {
+            box.min = Point(std::min(box.min.x, P.x), std::min(box.min.y, P.y));
+            box.max = Point(std::max(box.max.x, P.x), std::max(box.max.y, P.y));
+        }
+        return box;
+    }
+
+    HilbertRTree::HilbertRTree(const std::vector<Box>& boxes, int nodeSize)
+        : nodeSize(std::max(nodeSize, 2)), itemCount(int(boxes.size()))
+    {
+        if (boxes.empty())
+        {
+            return;
+        }
+
+        Box bounds = boxes[0];
+        for (const Box& box : boxes)
+        {
+            bounds.min = Point(std::min(bounds.min.x, box.min.x), std::min(bounds.min.y, box.min.y));
+            bounds.max = Point(std::max(bounds.max.x, box.max.x), std::max(bounds.max.y, box.max.y));
+        }
+
+        std::vector<SpatialKey> keys(boxes.size());
+        for (int i = 0; i < boxes.size(); i++)
+        {
+            keys[i] = { GetHilbertKey(0.5 * (boxes[i].min + boxes[i].max), bounds.min, bounds.max), i };
+        }
+        RadixSort(keys);
+
+        int count = itemCount;
+        int total = count;
+        do
+        {
+            count = (count + this->nodeSize - 1) / this->nodeSize;
+            total += count;
+        } while (count > 1);
+        nodes.reserve(total);
+
+        for (const SpatialKey& key : keys)
+        {
+            nodes.push_back({ boxes[key.index], key.index });
+        }
+        levelBounds.push_back(itemCount);
+
+        // Every pass packs the level that was just finished into its parents
+        int levelBegin = 0;
+        do
+        {
+            int levelEnd = int(nodes.size());
+            for (int first = levelBegin; first < levelEnd; first += this->nodeSize)
+            {
+                Box box = nodes[first].box;
+                for (int child = first + 1; child < std::min(first + this->nodeSize, levelEnd); child++)
+                {
+                    box.min = Point(std::min(box.min.x, nodes[child].box.min.x), std::min(box.min.y, nodes[child].box.min.y));
+                    box.max = Point(std::max(box.max.x, nodes[child].box.max.x), std::max(box.max.y, nodes[child].box.max.y));
+                }
+                nodes.push_back({ box, first });
+            }
+            levelBounds.push_back(int(nodes.size()));
+            levelBegin = levelEnd;
+        } while (nodes.size() - levelBegin > 1);
+    }
+
+    Box HilbertRTree::GetBounds() const
+    {
+        return nodes.empty() ? Box() : nodes.back().box;
+    }
+}
@@ -0,0 +1,161 @@
+#ifndef HILBERT_R_TREE_H
+#define HILBERT_R_TREE_H
+
+#include <algorithm>
+#include <vector>
+
+#include "Hilbert.h"
+
+namespace geometry
+{
+    struct Box
+    {
+        Point min;
+        Point max;
+
+        bool Contains(Point P) const
+        {
+            return min.x <= P.x && P.x <= max.x && min.y <= P.y && P.y <= max.y;
+        }
+    };
+
+    Box GetBoundingBox(const std::vector<Point>& points);
+
+    // Static packed R-tree. The boxes are sorted along a Hilbert curve through their centres
+    // and packed bottom-up, nodeSize children per node, into one array: the sorted boxes
+    // first, then every level above them, the root last.
+    class HilbertRTree
+    {
+    public:
+        explicit HilbertRTree(const std::vector<Box>& boxes, int nodeSize = 16);
+
+        // Calls visit(item) for every box that contains P
+        template <typename Visit>
+        void Search(Point P, Visit visit) const;
+
+        // Calls visit(query, item) for every box that contains queries[query]. The queries
+        // are walked in Hilbert order in batches that go down the tree together, so nodes
+        // near each other are visited once per batch instead of once per query.
+        template <typename Visit>
+        void Search(const std::vector<Point>& queries, Visit visit) const;
+
+        Box GetBounds() const;
+
+    private:
+        // Leaves hold the item, nodes above hold the position of their first child
+        struct Node
+        {
+            Box box;
+            int index;
+        };
+
+        int GetChildrenEnd(int first) const
+        {
+            return std::min(first + nodeSize, *std::upper_bound(levelBounds.begin(), levelBounds.end(), first));
+        }
+
+        static const int BatchSize = 64;
+
+        int nodeSize;
+        int itemCount;
+        std::vector<Node> nodes;
+        std::vector<int> levelBounds;
+    };
+
+    template <typename Visit>
+    void HilbertRTree::Search(Point P, Visit visit) const
+    {
+        if (nodes.empty())
+        {
+            return;
+        }
+
+        std::vector<int> stack = { int(nodes.size()) - 1 };
+        while (!stack.empty())
+        {
+            int node = stack.back();
+            stack.pop_back();
+
+            int first = nodes[node].index;
+            for (int child = first, end = GetChildrenEnd(first); child < end; child++)
+            {
+                if (!nodes[child].box.Contains(P))
+                {
+                    continue;
+                }
+
+                if (child < itemCount)
+                {
+                    visit(nodes[child].index);
+                }
+                else
+                {
+                    stack.push_back(child);
+                }
+            }
+        }
+    }
+
+    template <typename Visit>
+    void HilbertRTree::Search(const std::vector<Point>& queries, Visit visit) const
+    {
+        if (nodes.empty())
+        {
+            return;
+        }
+
+        struct Frame
+        {
+            int node;
+            int begin;
+            int end;
+        };
+
+        // Every frame owns the queries in active[begin, end) that are inside its box. Frames
+        // higher on the stack own later ranges, so popping one frees everything after it.
+        Box bounds = GetBounds();
+        std::vector<int> order = GetHilbertOrder(queries, bounds.min, bounds.max);
+        std::vector<int> active;
+        std::vector<Frame> stack;
+        for (int start = 0; start < order.size(); start += BatchSize)
+        {
+            active.assign(order.begin() + start, order.begin() + std::min(start + BatchSize, int(order.size())));
+            stack.push_back({ int(nodes.size()) - 1, 0, int(active.size()) });
+            while (!stack.empty())
+            {
+                Frame frame = stack.back();
+                stack.pop_back();
+                active.resize(frame.end);
+
+                int first = nodes[frame.node].index;
+                for (int child = first, end = GetChildrenEnd(first); child < end; child++)
+                {
+                    const Box& box = nodes[child].box;
+                    int begin = int(active.size());
+                    for (int i = frame.begin; i < frame.end; i++)
+                    {
+                        if (box.Contains(queries[active[i]]))
+                        {
+                            active.push_back(active[i]);
+                        }
+                    }
+
+                    if (child < itemCount)
+                    {
+                        for (int i = begin; i < active.size(); i++)
+                        {
+                            visit(active[i], nodes[child].index);
+                        }
+                        active.resize(begin);
+                    }
+                    else if (begin < active.size())
+                    {
+                        stack.push_back({ child, begin, int(active.size()) });
+                    }
+                }
+            }
+        }
+    }
+}
+
+#endif
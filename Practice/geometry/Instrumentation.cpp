@@ -0,0 +1,154 @@
+#ifdef GEOMETRY_INSTRUMENTATION
+
+#include <cstdlib>
+#include <map>
+#include <new>
+#include <string>
+
+#include "Instrumentation.h"
+
+namespace geometry
+{
+    namespace instrumentation
+    {
+        thread_local int64_t counters[int(Counter::Count)];
+
+        namespace
+        {
+            thread_local std::vector<StageEvent> stages;
+
+            const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+        }
+
+        const char* ToString(Counter counter)
+        {
+            switch (counter)
+            {
+            case Counter::Orient2D: return "orient2d";
+            case Counter::Orient2DExact: return "orient2d_exact";
+            case Counter::InCircle: return "incircle";
+            case Counter::InCircleExact: return "incircle_exact";
+            case Counter::Orient3D: return "orient3d";
+            case Counter::Orient3DExact: return "orient3d_exact";
+            case Counter::InDiametralCircle: return "indiametral";
+            case Counter::InDiametralCircleExact: return "indiametral_exact";
+            case Counter::AreaFromPoints: return "area_from_points";
+            case Counter::EarsTested: return "ears_tested";
+            case Counter::EarsClipped: return "ears_clipped";
+            case Counter::EarcutMoves: return "earcut_moves";
+            case Counter::MonotoneDiagonals: return "monotone_diagonals";
+            case Counter::HullPops: return "hull_pops";
+            case Counter::Flips: return "flips";
+            case Counter::Allocations: return "allocations";
+            case Counter::AllocatedBytes: return "allocated_bytes";
+            default: return "";
+            }
+        }
+
+        int64_t GetNanoseconds()
+        {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count();
+        }
+
+        void AddStage(const char* name, int64_t start, int64_t duration)
+        {
+            stages.push_back({ name, start, duration });
+        }
+
+        void Reset()
+        {
+            for (int64_t& counter : counters)
+            {
+                counter = 0;
+            }
+            stages.clear();
+            // Keeps the stages' own allocations out of the counters of most calls
+            stages.reserve(256);
+        }
+
+        const std::vector<StageEvent>& GetStages()
+        {
+            return stages;
+        }
+
+        void WriteReport(FILE* file, const char* call)
+        {
+            // Stage totals by name, in the order they first ran
+            std::vector<std::string> order;
+            std::map<std::string, std::pair<int64_t, int64_t>> totals;
+            for (const StageEvent& event : stages)
+            {
+                std::pair<int64_t, int64_t>& total = totals[event.name];
+                if (total.first == 0)
+                {
+                    order.push_back(event.name);
+                }
+                total.first++;
+                total.second += event.duration;
+            }
+
+            fprintf(file, "{\"call\": \"%s\", \"counters\": {", call);
+            for (int i = 0; i < int(Counter::Count); i++)
+            {
+                fprintf(file, "%s\"%s\": %lld", i ? ", " : "", ToString(Counter(i)), (long long)counters[i]);
+            }
+            fprintf(file, "}, \"stages\": [");
+            for (int i = 0; i < order.size(); i++)
+            {
+                const std::pair<int64_t, int64_t>& total = totals[order[i]];
+                fprintf(file, "%s{\"name\": \"%s\", \"count\": %lld, \"total_ns\": %lld}", i ? ", " : "", order[i].c_str(), (long long)total.first, (long long)total.second);
+            }
+            fprintf(file, "]}");
+        }
+
+        bool WriteTraceEvents(FILE* file, bool isFirst)
+        {
+            for (const StageEvent& event : stages)
+            {
+                fprintf(file, "%s\n{\"name\": \"%s\", \"ph\": \"X\", \"ts\": %.3f, \"dur\": %.3f, \"pid\": 1, \"tid\": 1}",
+                    isFirst ? "" : ",", event.name, event.start / 1000.0, event.duration / 1000.0);
+                isFirst = false;
+            }
+            return isFirst;
+        }
+    }
+}
+
+// Allocations of every thread land in that thread's counters
+void* operator new(size_t size)
+{
+    geometry::instrumentation::Count(geometry::instrumentation::Counter::Allocations);
+    geometry::instrumentation::Count(geometry::instrumentation::Counter::AllocatedBytes, int64_t(size));
+    if (void* p = std::malloc(size ? size : 1))
+    {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void* p, size_t) noexcept
+{
+    std::free(p);
+}
+
+#endif
@@ -0,0 +1,128 @@
+#ifndef INSTRUMENTATION_H
+#define INSTRUMENTATION_H
+
+// Counters and stage timers for the hot paths, compiled in with GEOMETRY_INSTRUMENTATION.
+// Without it the macros expand to nothing.
+//
+//     GEOMETRY_COUNT(EarsTested);
+//     GEOMETRY_STAGE(stage, "Graham/sort");
+//     ...
+//     GEOMETRY_NEXT_STAGE(stage, "Graham/scan");
+//
+// Counters and stages are per thread, a report covers the calls on the calling thread since Reset().
+
+#ifdef GEOMETRY_INSTRUMENTATION
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+namespace geometry
+{
+    namespace instrumentation
+    {
+        enum class Counter
+        {
+            Orient2D,
+            Orient2DExact,
+            InCircle,
+            InCircleExact,
+            Orient3D,
+            Orient3DExact,
+            InDiametralCircle,
+            InDiametralCircleExact,
+            AreaFromPoints,
+            EarsTested,
+            EarsClipped,
+            // Vertices shifted by polygon.erase() in Earcut
+            EarcutMoves,
+            // Diagonals cutting a polygon into monotone pieces
+            MonotoneDiagonals,
+            HullPops,
+            Flips,
+            Allocations,
+            AllocatedBytes,
+            Count,
+        };
+
+        const char* ToString(Counter counter);
+
+        struct StageEvent
+        {
+            const char* name;
+            // Nanoseconds since the first stage of the process
+            int64_t start;
+            int64_t duration;
+        };
+
+        extern thread_local int64_t counters[int(Counter::Count)];
+
+        inline void Count(Counter counter, int64_t value = 1)
+        {
+            counters[int(counter)] += value;
+        }
+
+        int64_t GetNanoseconds();
+
+        void AddStage(const char* name, int64_t start, int64_t duration);
+
+        // Times from construction, or the last Next(), to destruction
+        class Stage
+        {
+        public:
+            explicit Stage(const char* name)
+                : name(name), start(GetNanoseconds())
+            {
+            }
+
+            ~Stage()
+            {
+                AddStage(name, start, GetNanoseconds() - start);
+            }
+
+            void Next(const char* nextName)
+            {
+                int64_t now = GetNanoseconds();
+                AddStage(name, start, now - start);
+                name = nextName;
+                start = now;
+            }
+
+            Stage(const Stage&) = delete;
+            Stage& operator=(const Stage&) = delete;
+
+        private:
+            const char* name;
+            int64_t start;
+        };
+
+        void Reset();
+
+        const std::vector<StageEvent>& GetStages();
+
+        // One JSON object: the counters and the total time of every stage
+        void WriteReport(FILE* file, const char* call);
+
+        // Chrome trace events ("ph": "X") for chrome://tracing or Perfetto, comma separated,
+        // the caller writes {"traceEvents": [ ... ]} around them. Returns whether the next
+        // event written is still the first.
+        bool WriteTraceEvents(FILE* file, bool isFirst);
+    }
+}
+
+#define GEOMETRY_COUNT(counter) geometry::instrumentation::Count(geometry::instrumentation::Counter::counter)
+#define GEOMETRY_COUNT_ADD(counter, value) geometry::instrumentation::Count(geometry::instrumentation::Counter::counter, value)
+#define GEOMETRY_STAGE(stage, name) geometry::instrumentation::Stage stage(name)
+#define GEOMETRY_NEXT_STAGE(stage, name) stage.Next(name)
+
+#else
+
+#define GEOMETRY_COUNT(counter) ((void)0)
+#define GEOMETRY_COUNT_ADD(counter, value) ((void)0)
+#define GEOMETRY_STAGE(stage, name) ((void)0)
+#define GEOMETRY_NEXT_STAGE(stage, name) ((void)0)
+
+#endif
+
+#endif
@@ -0,0 +1,240 @@
+#include <algorithm>
+#include <cstdint>
+#include <thread>
+
+#include "Hilbert.h"
+#include "KdTree.h"
+#include "Parallel.h"
+
+namespace geometry
+{
+    namespace
+    {
+        struct Item
+        {
+            Point P;
+            int id;
+        };
+
+        const int LeafSize = 32;
+
+        void Partition(std::vector<Item>& items, int begin, int end, int axis, int parallelDepth)
+        {
+            if (end - begin <= LeafSize)
+            {
+                return;
+            }
+
+            int mid = (begin + end) / 2;
+            std::nth_element(items.begin() + begin, items.begin() + mid, items.begin() + end, [axis](const Item& a, const Item& b)
+            {
+                return axis == 0 ? a.P.x < b.P.x : a.P.y < b.P.y;
+            });
+
+            if (parallelDepth > 0)
+            {
+                std::thread left(Partition, std::ref(items), begin, mid, 1 - axis, parallelDepth - 1);
+                Partition(items, mid + 1, end, 1 - axis, parallelDepth - 1);
+                left.join();
+            }
+            else
+            {
+                Partition(items, begin, mid, 1 - axis, 0);
+                Partition(items, mid + 1, end, 1 - axis, 0);
+            }
+        }
+    }
+
+    KdTree::KdTree(const std::vector<Point>& points, int threadCount)
+        : xs(points.size()), ys(points.size()), ids(points.size()), min(points.empty() ? Point() : points[0]), max(min)
+    {
+        this->threadCount = GetThreadCount(threadCount);
+
+        std::vector<Item> items(points.size());
+        for (int i = 0; i < points.size(); i++)
+        {
+            items[i] = { points[i], i };
+            min = Point(std::min(min.x, points[i].x), std::min(min.y, points[i].y));
+            max = Point(std::max(max.x, points[i].x), std::max(max.y, points[i].y));
+        }
+
+        int parallelDepth = 0;
+        while ((1 << parallelDepth) < this->threadCount)
+        {
+            parallelDepth++;
+        }
+        Partition(items, 0, int(items.size()), 0, parallelDepth);
+
+        for (int i = 0; i < items.size(); i++)
+        {
+            xs[i] = items[i].P.x;
+            ys[i] = items[i].P.y;
+            ids[i] = items[i].id;
+        }
+    }
+
+    std::vector<int> KdTree::GetNearest(Point P, int k) const
+    {
+        std::vector<Candidate> heap;
+        heap.reserve(k);
+        if (k > 0)
+        {
+            SearchNearest(0, Size(), 0, P, k, heap);
+        }
+        std::sort_heap(heap.begin(), heap.end());
+
+        std::vector<int> result(heap.size());
+        for (int i = 0; i < heap.size(); i++)
+        {
+            result[i] = heap[i].index;
+        }
+        return result;
+    }
+
+    std::vector<int> KdTree::GetInRadius(Point P, double radius) const
+    {
+        std::vector<int> result;
+        SearchInRadius(0, Size(), 0, P, radius * radius, result);
+        return result;
+    }
+
+    void KdTree::GetNearest(const std::vector<Point>& queries, int k, std::vector<int>& result) const
+    {
+        int count = std::max(0, std::min(k, Size()));
+        result.resize(queries.size() * count);
+        if (count == 0)
+        {
+            return;
+        }
+
+        std::vector<int> order = GetHilbertOrder(queries, min, max);
+        ParallelFor(int(queries.size()), threadCount, [&](int, int begin, int end)
+        {
+            std::vector<Candidate> heap;
+            heap.reserve(count);
+            for (int i = begin; i < end; i++)
+            {
+                int query = order[i];
+                heap.clear();
+                SearchNearest(0, Size(), 0, queries[query], count, heap);
+                std::sort_heap(heap.begin(), heap.end());
+                for (int j = 0; j < count; j++)
+                {
+                    result[query * count + j] = heap[j].index;
+                }
+            }
+        });
+    }
+
+    void KdTree::GetInRadius(const std::vector<Point>& queries, double radius, std::vector<int>& offsets, std::vector<int>& items) const
+    {
+        // Every chunk collects its own items in Hilbert order, they are moved to their queries afterwards
+        std::vector<int> order = GetHilbertOrder(queries, min, max);
+        std::vector<std::vector<int>> chunkItems(threadCount);
+        offsets.assign(queries.size() + 1, 0);
+        ParallelFor(int(queries.size()), threadCount, [&](int chunk, int begin, int end)
+        {
+            std::vector<int>& found = chunkItems[chunk];
+            for (int i = begin; i < end; i++)
+            {
+                int before = int(found.size());
+                SearchInRadius(0, Size(), 0, queries[order[i]], radius * radius, found);
+                offsets[order[i] + 1] = int(found.size()) - before;
+            }
+        });
+
+        for (int i = 0; i < queries.size(); i++)
+        {
+            offsets[i + 1] += offsets[i];
+        }
+
+        items.resize(offsets.back());
+        int i = 0;
+        for (const std::vector<int>& found : chunkItems)
+        {
+            for (int j = 0; j < found.size(); i++)
+            {
+                int query = order[i];
+                int count = offsets[query + 1] - offsets[query];
+                std::copy(found.begin() + j, found.begin() + j + count, items.begin() + offsets[query]);
+                j += count;
+            }
+        }
+    }
+
+    void KdTree::SearchNearest(int begin, int end, int axis, Point P, int k, std::vector<Candidate>& heap) const
+    {
+        if (end - begin <= LeafSize)
+        {
+            double distances[LeafSize];
+            GetLeafDistances(begin, end, P, distances);
+            for (int i = 0; i < end - begin; i++)
+            {
+                AddCandidate({ distances[i], ids[begin + i] }, k, heap);
+            }
+            return;
+        }
+
+        // The middle point splits the node: everything before it is <= on this axis, everything after it >=
+        int mid = (begin + end) / 2;
+        Point M(xs[mid], ys[mid]);
+        AddCandidate({ (M - P) * (M - P), ids[mid] }, k, heap);
+
+        double delta = axis == 0 ? P.x - M.x : P.y - M.y;
+        int nearBegin = delta < 0.0 ? begin : mid + 1;
+        int nearEnd = delta < 0.0 ? mid : end;
+        int farBegin = delta < 0.0 ? mid + 1 : begin;
+        int farEnd = delta < 0.0 ? end : mid;
+        SearchNearest(nearBegin, nearEnd, 1 - axis, P, k, heap);
+        if (heap.size() < k || delta * delta < heap.front().distance)
+        {
+            SearchNearest(farBegin, farEnd, 1 - axis, P, k, heap);
+        }
+    }
+
+    void KdTree::SearchInRadius(int begin, int end, int axis, Point P, double radiusSquared, std::vector<int>& result) const
+    {
+        if (end - begin <= LeafSize)
+        {
+            double distances[LeafSize];
+            GetLeafDistances(begin, end, P, distances);
+            for (int i = 0; i < end - begin; i++)
+            {
+                if (distances[i] <= radiusSquared)
+                {
+                    result.push_back(ids[begin + i]);
+                }
+            }
+            return;
+        }
+
+        int mid = (begin + end) / 2;
+        Point M(xs[mid], ys[mid]);
+        if ((M - P) * (M - P) <= radiusSquared)
+        {
+            result.push_back(ids[mid]);
+        }
+
+        double delta = axis == 0 ? P.x - M.x : P.y - M.y;
+        if (delta <= 0.0 || delta * delta <= radiusSquared)
+        {
+            SearchInRadius(begin, mid, 1 - axis, P, radiusSquared, result);
+        }
+        if (delta >= 0.0 || delta * delta <= radiusSquared)
+        {
+            SearchInRadius(mid + 1, end, 1 - axis, P, radiusSquared, result);
+        }
+    }
+
+    void KdTree::GetLeafDistances(int begin, int end, Point P, double* distances) const
+    {
+        const double* x = xs.data() + begin;
+        const double* y = ys.data() + begin;
+        for (int i = 0; i < end - begin; i++)
+        {
+            double dx = x[i] - P.x;
+            double dy = y[i] - P.y;
+            distances[i] = dx * dx + dy * dy;
+        }
+    }
+}
@@ -0,0 +1,82 @@
+#ifndef KD_TREE_H
+#define KD_TREE_H
+
+#include <algorithm>
+#include <vector>
+
+#include "Geometry.h"
+
+namespace geometry
+{
+    // Implicit k-d tree: the points are reordered so that every node is a range of one array,
+    // split at its middle element on x and y in turns. Nothing is stored per node, leaves are
+    // the ranges of at most LeafSize points and are scanned linearly.
+    // Query results are indices into the points the tree was built from.
+    class KdTree
+    {
+    public:
+        // The top of the tree is partitioned on up to threadCount threads,
+        // 0 means std::thread::hardware_concurrency()
+        explicit KdTree(const std::vector<Point>& points, int threadCount = 0);
+
+        // The k nearest points, the closest first
+        std::vector<int> GetNearest(Point P, int k) const;
+
+        // Every point at distance <= radius, in no particular order
+        std::vector<int> GetInRadius(Point P, double radius) const;
+
+        // min(k, size) neighbours per query, the ones of queries[i] start at result[i * min(k, size)]
+        void GetNearest(const std::vector<Point>& queries, int k, std::vector<int>& result) const;
+
+        // The points near queries[i] are items[offsets[i]] .. items[offsets[i + 1] - 1]
+        void GetInRadius(const std::vector<Point>& queries, double radius, std::vector<int>& offsets, std::vector<int>& items) const;
+
+        int Size() const
+        {
+            return int(ids.size());
+        }
+
+    private:
+        struct Candidate
+        {
+            double distance;
+            int index;
+
+            bool operator<(const Candidate& other) const
+            {
+                return distance < other.distance;
+            }
+        };
+
+        // Keeps the k closest candidates in a max-heap on distance
+        static void AddCandidate(Candidate candidate, int k, std::vector<Candidate>& heap)
+        {
+            if (heap.size() < k)
+            {
+                heap.push_back(candidate);
+                std::push_heap(heap.begin(), heap.end());
+            }
+            else if (candidate.distance < heap.front().distance)
+            {
+                std::pop_heap(heap.begin(), heap.end());
+                heap.back() = candidate;
+                std::push_heap(heap.begin(), heap.end());
+            }
+        }
+
+        void SearchNearest(int begin, int end, int axis, Point P, int k, std::vector<Candidate>& heap) const;
+        void SearchInRadius(int begin, int end, int axis, Point P, double radiusSquared, std::vector<int>& result) const;
+
+        // Squared distances from P to the points of a leaf, written so that the compiler vectorizes it
+        void GetLeafDistances(int begin, int end, Point P, double* distances) const;
+
+        std::vector<double> xs;
+        std::vector<double> ys;
+        std::vector<int> ids;
+        Point min;
+        Point max;
+        int threadCount;
+    };
+}
+
+#endif
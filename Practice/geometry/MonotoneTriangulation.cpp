@@ -0,0 +1,446 @@
+#include <algorithm>
+#include <iterator>
+#include <set>
+
+#include "MonotoneTriangulation.h"
+
+namespace geometry
+{
+    namespace
+    {
+        bool IsLess(Point a, Point b)
+        {
+            return a.x < b.x || (a.x == b.x && a.y < b.y);
+        }
+
+        // Consecutive copies of a vertex count once, the ring is made counter-clockwise
+        std::vector<Point> GetRing(const std::vector<Point>& polygon, bool& isClockwise)
+        {
+            std::vector<Point> ring;
+            ring.reserve(polygon.size());
+            for (Point P : polygon)
+            {
+                if (ring.empty() || ring.back() != P)
+                {
+                    ring.push_back(P);
+                }
+            }
+            while (ring.size() > 1 && ring.back() == ring.front())
+            {
+                ring.pop_back();
+            }
+
+            double orientation = 0.0;
+            for (int i = 0; i < ring.size(); i++)
+            {
+                Point a = ring[i];
+                Point b = ring[(i + 1) % ring.size()];
+                orientation += (a.x * b.y) - (a.y * b.x);
+            }
+            isClockwise = orientation < 0.0;
+            if (isClockwise)
+            {
+                std::reverse(ring.begin(), ring.end());
+            }
+            return ring;
+        }
+
+        struct Chains
+        {
+            std::vector<int> order;
+            std::vector<bool> isUpper;
+            std::vector<int> stack;
+        };
+
+        // Stack triangulation of a counter-clockwise monotone piece given by its vertices in
+        // ring, chains keeps its buffers from one piece to the next
+        void AddMonotoneTriangles(const std::vector<Point>& ring, const std::vector<int>& piece, bool isClockwise, Chains& chains, std::vector<Triangle>& triangles)
+        {
+            int n = int(piece.size());
+            if (n < 3)
+            {
+                return;
+            }
+            auto addTriangle = [&](int a, int b, int c)
+            {
+                Point A = ring[a];
+                Point B = ring[b];
+                Point C = ring[c];
+                if ((Orient2D(A, B, C) < 0.0) != isClockwise)
+                {
+                    std::swap(B, C);
+                }
+                triangles.push_back({ A, B, C });
+            };
+
+            // Counter-clockwise the lower chain runs from the left most to the right most vertex
+            int first = 0;
+            int last = 0;
+            for (int i = 1; i < n; i++)
+            {
+                first = IsLess(ring[piece[i]], ring[piece[first]]) ? i : first;
+                last = IsLess(ring[piece[last]], ring[piece[i]]) ? i : last;
+            }
+            std::vector<int>& order = chains.order;
+            std::vector<bool>& isUpper = chains.isUpper;
+            order.clear();
+            isUpper.clear();
+            int lower = first;
+            int upper = first ? first - 1 : n - 1;
+            order.push_back(piece[first]);
+            isUpper.push_back(false);
+            while (order.size() < n)
+            {
+                bool takeLower = upper == last || (lower != last && IsLess(ring[piece[(lower + 1) % n]], ring[piece[upper]]));
+                if (takeLower)
+                {
+                    lower = (lower + 1) % n;
+                    order.push_back(piece[lower]);
+                    isUpper.push_back(false);
+                }
+                else
+                {
+                    order.push_back(piece[upper]);
+                    isUpper.push_back(true);
+                    upper = upper ? upper - 1 : n - 1;
+                }
+            }
+
+            std::vector<int>& stack = chains.stack;
+            stack.assign({ 0, 1 });
+            for (int j = 2; j < n - 1; j++)
+            {
+                if (isUpper[j] != isUpper[stack.back()])
+                {
+                    // Everything on the stack sees the new vertex across the piece
+                    for (int k = int(stack.size()) - 1; k > 0; k--)
+                    {
+                        addTriangle(order[j], order[stack[k]], order[stack[k - 1]]);
+                    }
+                    stack.assign({ j - 1, j });
+                    continue;
+                }
+
+                // Same chain: cut off the vertices that make a convex corner with it
+                int top = stack.back();
+                stack.pop_back();
+                while (!stack.empty())
+                {
+                    double turn = Orient2D(ring[order[stack.back()]], ring[order[top]], ring[order[j]]);
+                    if (isUpper[j] ? turn >= 0.0 : turn <= 0.0)
+                    {
+                        break;
+                    }
+                    addTriangle(order[j], order[top], order[stack.back()]);
+                    top = stack.back();
+                    stack.pop_back();
+                }
+                stack.push_back(top);
+                stack.push_back(j);
+            }
+            for (int k = int(stack.size()) - 1; k > 0; k--)
+            {
+                addTriangle(order[n - 1], order[stack[k]], order[stack[k - 1]]);
+            }
+        }
+
+        class MonotonePartition
+        {
+        public:
+            explicit MonotonePartition(const std::vector<Point>& ring)
+                : ring(ring), helpers(ring.size(), -1), positions(ring.size()), status(EdgeCompare{ this })
+            {
+            }
+
+            // Vertices of the pieces in ring, each counter-clockwise
+            std::vector<std::vector<int>> Run()
+            {
+                int n = int(ring.size());
+                GEOMETRY_STAGE(stage, "MonotonePartition/sort");
+                std::vector<std::pair<Point, int>> events(n);
+                for (int i = 0; i < n; i++)
+                {
+                    events[i] = { ring[i], i };
+                }
+                std::sort(events.begin(), events.end(), [](const std::pair<Point, int>& a, const std::pair<Point, int>& b)
+                {
+                    return IsLess(a.first, b.first);
+                });
+
+                GEOMETRY_NEXT_STAGE(stage, "MonotonePartition/sweep");
+                for (const std::pair<Point, int>& event : events)
+                {
+                    int v = event.second;
+                    int previous = v ? v - 1 : n - 1;
+                    int next = (v + 1) % n;
+                    bool isPreviousLeft = IsLess(ring[previous], ring[v]);
+                    bool isNextLeft = IsLess(ring[next], ring[v]);
+                    bool isConvex = Orient2D(ring[previous], ring[v], ring[next]) > 0.0;
+                    if (!isPreviousLeft && !isNextLeft)
+                    {
+                        if (!isConvex)
+                        {
+                            // Split vertex
+                            int below = GetEdgeBelow(v);
+                            AddDiagonal(v, helpers[below]);
+                            helpers[below] = v;
+                        }
+                        Insert(v);
+                    }
+                    else if (isPreviousLeft && isNextLeft)
+                    {
+                        Remove(previous);
+                        if (!isConvex)
+                        {
+                            // Merge vertex
+                            int below = GetEdgeBelow(v);
+                            ResolveMerge(v, below);
+                            helpers[below] = v;
+                        }
+                    }
+                    else if (isPreviousLeft)
+                    {
+                        // On a lower chain, the inside is above
+                        Remove(previous);
+                        Insert(v);
+                    }
+                    else
+                    {
+                        int below = GetEdgeBelow(v);
+                        ResolveMerge(v, below);
+                        helpers[below] = v;
+                    }
+                }
+
+                GEOMETRY_NEXT_STAGE(stage, "MonotonePartition/pieces");
+                return GetPieces();
+            }
+
+        private:
+            struct EdgeCompare
+            {
+                const MonotonePartition* partition;
+
+                bool operator()(int a, int b) const
+                {
+                    return partition->IsBelow(a, b);
+                }
+            };
+
+            // Edge i runs from vertex i to vertex i + 1, only the ones going right are in the
+            // status and the inside of the polygon is above them. Edges there never cross, only
+            // the edge being inserted or the probe vertex is ever compared.
+            bool IsBelow(int a, int b) const
+            {
+                if (a == inserting || a == probe)
+                {
+                    return Orient2D(ring[b], ring[(b + 1) % ring.size()], ring[a]) < 0.0;
+                }
+                if (b == inserting || b == probe)
+                {
+                    return Orient2D(ring[a], ring[(a + 1) % ring.size()], ring[b]) > 0.0;
+                }
+                return a < b;
+            }
+
+            void Insert(int edge)
+            {
+                inserting = edge;
+                positions[edge] = status.insert(edge).first;
+                inserting = -1;
+                helpers[edge] = edge;
+            }
+
+            // The helper of an edge leaving is only joined when it was a merge vertex
+            void Remove(int edge)
+            {
+                ResolveMerge((edge + 1) % ring.size(), edge);
+                status.erase(positions[edge]);
+            }
+
+            void ResolveMerge(int v, int edge)
+            {
+                int helper = helpers[edge];
+                int n = int(ring.size());
+                int previous = helper ? helper - 1 : n - 1;
+                int next = (helper + 1) % n;
+                bool isMerge = IsLess(ring[previous], ring[helper]) && IsLess(ring[next], ring[helper]) && Orient2D(ring[previous], ring[helper], ring[next]) <= 0.0;
+                if (isMerge)
+                {
+                    AddDiagonal(v, helper);
+                }
+            }
+
+            int GetEdgeBelow(int v)
+            {
+                probe = v;
+                std::set<int, EdgeCompare>::iterator position = status.lower_bound(v);
+                probe = -1;
+                return *std::prev(position);
+            }
+
+            void AddDiagonal(int a, int b)
+            {
+                GEOMETRY_COUNT(MonotoneDiagonals);
+                diagonals.push_back({ a, b });
+                diagonals.push_back({ b, a });
+            }
+
+            // Faces of the ring and the diagonals, walking each half-edge once with the inside on
+            // its left: at a vertex the walk goes on along the next edge clockwise.
+            std::vector<std::vector<int>> GetPieces() const
+            {
+                int n = int(ring.size());
+                std::vector<std::vector<int>> pieces;
+                if (diagonals.empty())
+                {
+                    std::vector<int> piece(n);
+                    for (int i = 0; i < n; i++)
+                    {
+                        piece[i] = i;
+                    }
+                    pieces.push_back(std::move(piece));
+                    return pieces;
+                }
+
+                // The half-edges leaving each vertex, counter-clockwise from the ring edge. All of
+                // them lie in the inside angle, which ends at the edge back to the previous vertex.
+                std::vector<int> offsets(n + 1, 0);
+                for (const std::pair<int, int>& diagonal : diagonals)
+                {
+                    offsets[diagonal.first + 1]++;
+                }
+                for (int i = 0; i < n; i++)
+                {
+                    offsets[i + 1] += offsets[i] + 1;
+                }
+                std::vector<int> targets(offsets[n]);
+                std::vector<int> filled(n, 1);
+                for (int i = 0; i < n; i++)
+                {
+                    targets[offsets[i]] = (i + 1) % n;
+                }
+                for (const std::pair<int, int>& diagonal : diagonals)
+                {
+                    targets[offsets[diagonal.first] + filled[diagonal.first]++] = diagonal.second;
+                }
+                for (int i = 0; i < n; i++)
+                {
+                    // The inside angle can be reflex, so first the side of the ring edge
+                    Point V = ring[i];
+                    Point next = ring[(i + 1) % n];
+                    auto getHalf = [&](int a)
+                    {
+                        double side = Orient2D(V, next, ring[a]);
+                        return side > 0.0 ? 0 : (side == 0.0 ? 1 : 2);
+                    };
+                    std::sort(targets.begin() + offsets[i] + 1, targets.begin() + offsets[i + 1], [&](int a, int b)
+                    {
+                        int halfA = getHalf(a);
+                        int halfB = getHalf(b);
+                        return halfA != halfB ? halfA < halfB : Orient2D(V, ring[a], ring[b]) > 0.0;
+                    });
+                }
+
+                std::vector<bool> isVisited(targets.size(), false);
+                for (int start = 0; start < targets.size(); start++)
+                {
+                    if (isVisited[start])
+                    {
+                        continue;
+                    }
+                    std::vector<int> piece;
+                    int from = int(std::upper_bound(offsets.begin(), offsets.end(), start) - offsets.begin()) - 1;
+                    int edge = start;
+                    while (!isVisited[edge])
+                    {
+                        isVisited[edge] = true;
+                        piece.push_back(from);
+                        int to = targets[edge];
+                        // Clockwise from the way back, which closes the inside angle when it is
+                        // the ring edge
+                        int k = offsets[to + 1];
+                        if (to != (from + 1) % n)
+                        {
+                            while (targets[--k] != from)
+                            {
+                            }
+                        }
+                        edge = k - 1;
+                        from = to;
+                    }
+                    pieces.push_back(std::move(piece));
+                }
+                return pieces;
+            }
+
+            const std::vector<Point>& ring;
+            std::vector<int> helpers;
+            std::vector<std::set<int, EdgeCompare>::iterator> positions;
+            std::set<int, EdgeCompare> status;
+            std::vector<std::pair<int, int>> diagonals;
+            int inserting = -1;
+            int probe = -1;
+        };
+    }
+
+    std::vector<std::vector<Point>> GetMonotonePieces(const std::vector<Point>& polygon)
+    {
+        bool isClockwise = false;
+        std::vector<Point> ring = GetRing(polygon, isClockwise);
+        std::vector<std::vector<Point>> pieces;
+        if (ring.size() < 3)
+        {
+            return pieces;
+        }
+        for (const std::vector<int>& piece : MonotonePartition(ring).Run())
+        {
+            std::vector<Point> points;
+            points.reserve(piece.size());
+            for (int i : piece)
+            {
+                points.push_back(ring[i]);
+            }
+            pieces.push_back(std::move(points));
+        }
+        return pieces;
+    }
+
+    std::vector<Triangle> TriangulateMonotone(const std::vector<Point>& polygon)
+    {
+        GEOMETRY_STAGE(stage, "MonotoneTriangulation/stack");
+        bool isClockwise = false;
+        std::vector<Point> ring = GetRing(polygon, isClockwise);
+        std::vector<int> piece(ring.size());
+        for (int i = 0; i < ring.size(); i++)
+        {
+            piece[i] = i;
+        }
+        std::vector<Triangle> triangles;
+        triangles.reserve(ring.size());
+        Chains chains;
+        AddMonotoneTriangles(ring, piece, isClockwise, chains, triangles);
+        return triangles;
+    }
+
+    std::vector<Triangle> MonotoneTriangulation(const std::vector<Point>& polygon)
+    {
+        bool isClockwise = false;
+        std::vector<Point> ring = GetRing(polygon, isClockwise);
+        std::vector<Triangle> triangles;
+        if (ring.size() < 3)
+        {
+            return triangles;
+        }
+        std::vector<std::vector<int>> pieces = MonotonePartition(ring).Run();
+
+        GEOMETRY_STAGE(stage, "MonotoneTriangulation/stack");
+        triangles.reserve(ring.size());
+        Chains chains;
+        for (const std::vector<int>& piece : pieces)
+        {
+            AddMonotoneTriangles(ring, piece, isClockwise, chains, triangles);
+        }
+        return triangles;
+    }
+}
@@ -0,0 +1,28 @@
+#ifndef MONOTONE_TRIANGULATION_H
+#define MONOTONE_TRIANGULATION_H
+
+#include <vector>
+
+#include "Geometry.h"
+
+namespace geometry
+{
+    // Monotone in x then y: each piece is an upper and a lower chain from its left most to its
+    // right most vertex, like the chains GetPointLocationMonotone() takes.
+
+    // A simple polygon in either orientation cut along diagonals into monotone pieces,
+    // counter-clockwise. One sweep with the edges under the sweep line in a balanced tree,
+    // split and merge vertices get a diagonal to the helper of the edge below them.
+    // O(n log n).
+    std::vector<std::vector<Point>> GetMonotonePieces(const std::vector<Point>& polygon);
+
+    // A monotone polygon in either orientation, n - 2 triangles with a stack over the merged
+    // chains. O(n).
+    std::vector<Triangle> TriangulateMonotone(const std::vector<Point>& polygon);
+
+    // Both of the above, the same triangles as Earcut(): n - 2 in the orientation of the
+    // polygon. O(n log n).
+    std::vector<Triangle> MonotoneTriangulation(const std::vector<Point>& polygon);
+}
+
+#endif
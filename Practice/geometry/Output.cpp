@@ -0,0 +1,217 @@
+#include <cstdint>
+#include <cstring>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#endif
+
+#include "Output.h"
+
+namespace geometry
+{
+    bool ParseOutputFormat(int argc, char** argv, OutputFormat& format)
+    {
+        format = OutputFormat::Text;
+        for (int i = 1; i < argc; i++)
+        {
+            const char* arg = argv[i];
+            if (std::strcmp(arg, "--format=text") == 0)
+            {
+                format = OutputFormat::Text;
+            }
+            else if (std::strcmp(arg, "--format=sp") == 0)
+            {
+                format = OutputFormat::Sp;
+            }
+            else if (std::strcmp(arg, "--format=binary") == 0)
+            {
+                format = OutputFormat::Binary;
+            }
+            else
+            {
+                fprintf(stderr, "Unknown argument %s, expected --format=text|sp|binary\n", arg);
+                return false;
+            }
+        }
+        return true;
+    }
+
+    Output::Output(FILE* file, OutputFormat format)
+        : format(format), buffer(file)
+    {
+#ifdef _WIN32
+        if (format == OutputFormat::Binary)
+        {
+            _setmode(_fileno(file), _O_BINARY);
+        }
+#endif
+    }
+
+    Output& Output::operator<<(const char* text)
+    {
+        if (format == OutputFormat::Text)
+        {
+            buffer.Write(text);
+        }
+        return *this;
+    }
+
+    Output& Output::operator<<(char c)
+    {
+        if (format == OutputFormat::Text)
+        {
+            buffer.Write(c);
+        }
+        return *this;
+    }
+
+    Output& Output::operator<<(int value)
+    {
+        if (format == OutputFormat::Text)
+        {
+            buffer.Write(value);
+        }
+        return *this;
+    }
+
+    Output& Output::operator<<(double value)
+    {
+        if (format == OutputFormat::Text)
+        {
+            buffer.Write(value);
+        }
+        return *this;
+    }
+
+    void Output::Write(double value)
+    {
+        switch (format)
+        {
+        case OutputFormat::Text:
+            buffer.Write(value);
+            buffer.Write('\n');
+            break;
+        case OutputFormat::Sp:
+            buffer.Write("- ");
+            buffer.WriteExact(value);
+            buffer.Write('\n');
+            break;
+        case OutputFormat::Binary:
+            buffer.WriteBinary(value);
+            break;
+        }
+    }
+
+    void Output::Write(PointLocation location)
+    {
+        switch (format)
+        {
+        case OutputFormat::Text:
+            buffer.Write(ToString(location));
+            buffer.Write('\n');
+            break;
+        case OutputFormat::Sp:
+            buffer.Write("- ");
+            buffer.Write(ToString(location));
+            buffer.Write('\n');
+            break;
+        case OutputFormat::Binary:
+            buffer.WriteBinary(int32_t(location));
+            break;
+        }
+    }
+
+    void Output::Write(const std::vector<Point>& polygon)
+    {
+        switch (format)
+        {
+        case OutputFormat::Text:
+            for (Point P : polygon)
+            {
+                buffer.Write('[');
+                buffer.Write(P.x, 1);
+                buffer.Write(", ");
+                buffer.Write(P.y, 1);
+                buffer.Write("] ");
+            }
+            buffer.Write('\n');
+            break;
+        case OutputFormat::Sp:
+            buffer.Write("polygon\n");
+            for (Point P : polygon)
+            {
+                WritePoint(P);
+                buffer.Write('\n');
+            }
+            buffer.Write('\n');
+            break;
+        case OutputFormat::Binary:
+            buffer.WriteBinary(uint64_t(polygon.size()));
+            for (Point P : polygon)
+            {
+                buffer.WriteBinary(P.x);
+                buffer.WriteBinary(P.y);
+            }
+            break;
+        }
+    }
+
+    void Output::Write(const std::vector<Triangle>& triangles)
+    {
+        switch (format)
+        {
+        case OutputFormat::Text:
+            for (int i = 0; i < triangles.size(); i++)
+            {
+                const Triangle& triangle = triangles[i];
+                buffer.Write("Triangle ");
+                buffer.Write(i);
+                const char* names[] = { ": A(", " B(", " C(" };
+                const Point corners[] = { triangle.A, triangle.B, triangle.C };
+                for (int j = 0; j < 3; j++)
+                {
+                    buffer.Write(names[j]);
+                    buffer.Write(corners[j].x, 2);
+                    buffer.Write(", ");
+                    buffer.Write(corners[j].y, 2);
+                    buffer.Write(')');
+                }
+                buffer.Write('\n');
+            }
+            break;
+        case OutputFormat::Sp:
+            buffer.Write("lines\n");
+            for (const Triangle& triangle : triangles)
+            {
+                const Point corners[] = { triangle.A, triangle.B, triangle.C };
+                for (int j = 0; j < 3; j++)
+                {
+                    WritePoint(corners[j]);
+                    buffer.Write(' ');
+                    WritePoint(corners[(j + 1) % 3]);
+                    buffer.Write('\n');
+                }
+            }
+            break;
+        case OutputFormat::Binary:
+            buffer.WriteBinary(uint64_t(triangles.size()));
+            for (const Triangle& triangle : triangles)
+            {
+                for (Point P : { triangle.A, triangle.B, triangle.C })
+                {
+                    buffer.WriteBinary(P.x);
+                    buffer.WriteBinary(P.y);
+                }
+            }
+            break;
+        }
+    }
+
+    void Output::WritePoint(Point P)
+    {
+        buffer.WriteExact(P.x);
+        buffer.Write(' ');
+        buffer.WriteExact(P.y);
+    }
+}
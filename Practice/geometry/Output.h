@@ -0,0 +1,61 @@
+#ifndef OUTPUT_H
+#define OUTPUT_H
+
+#include <cstdio>
+#include <vector>
+
+#include "Geometry.h"
+#include "OutputBuffer.h"
+#include "PointLocation.h"
+
+namespace geometry
+{
+    enum class OutputFormat
+    {
+        Text,   // for people, what the drivers always printed
+        Sp,     // SP commands, pipe it into SvgRender
+        Binary, // native doubles, a count before every list
+    };
+
+    // Reads --format=text|sp|binary, false with a message on stderr for anything else
+    bool ParseOutputFormat(int argc, char** argv, OutputFormat& format);
+
+    // Results of the drivers in the chosen format, through one OutputBuffer
+    class Output
+    {
+    public:
+        Output(FILE* file, OutputFormat format);
+
+        OutputFormat GetFormat() const
+        {
+            return format;
+        }
+
+        // Only the text format has labels and messages, the others leave them out
+        Output& operator<<(const char* text);
+        Output& operator<<(char c);
+        Output& operator<<(int value);
+        Output& operator<<(double value);
+
+        // A number on its own line, a comment in SP
+        void Write(double value);
+        void Write(PointLocation location);
+        // Text lists the vertices, SP draws the closed polygon
+        void Write(const std::vector<Point>& polygon);
+        // Text lists the corners, SP draws the edges
+        void Write(const std::vector<Triangle>& triangles);
+
+        void Flush()
+        {
+            buffer.Flush();
+        }
+
+    private:
+        void WritePoint(Point P);
+
+        OutputFormat format;
+        OutputBuffer buffer;
+    };
+}
+
+#endif
@@ -0,0 +1,158 @@
+#ifndef OUTPUT_BUFFER_H
+#define OUTPUT_BUFFER_H
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace geometry
+{
+    // Formats into one large buffer with std::to_chars and hands it to the file descriptor in
+    // a single write() when full, instead of a formatted stdio call per value. Whatever stdio
+    // still holds for the file goes out first, so both can be mixed.
+    class OutputBuffer
+    {
+    public:
+        explicit OutputBuffer(FILE* file, size_t capacity = 1 << 20)
+            : file(file), buffer(capacity)
+        {
+        }
+
+        ~OutputBuffer()
+        {
+            Flush();
+        }
+
+        OutputBuffer(const OutputBuffer&) = delete;
+        OutputBuffer& operator=(const OutputBuffer&) = delete;
+
+        void Write(const char* text, size_t length)
+        {
+            if (length > buffer.size() - size)
+            {
+                Flush();
+                if (length > buffer.size())
+                {
+                    WriteAll(text, length);
+                    return;
+                }
+            }
+            std::memcpy(buffer.data() + size, text, length);
+            size += length;
+        }
+
+        void Write(const char* text)
+        {
+            Write(text, std::strlen(text));
+        }
+
+        void Write(char c)
+        {
+            Reserve(1);
+            buffer[size++] = c;
+        }
+
+        void Write(int64_t value)
+        {
+            Reserve(24);
+            size = std::to_chars(buffer.data() + size, buffer.data() + buffer.size(), value).ptr - buffer.data();
+        }
+
+        void Write(int value)
+        {
+            Write(int64_t(value));
+        }
+
+        // 6 significant digits, like printf("%g") and std::cout
+        void Write(double value)
+        {
+            Reserve(MaxDoubleLength);
+            size = std::to_chars(buffer.data() + size, buffer.data() + buffer.size(), value, std::chars_format::general, 6).ptr - buffer.data();
+        }
+
+        // The shortest text that reads back as the same double
+        void WriteExact(double value)
+        {
+            Reserve(MaxDoubleLength);
+            size = std::to_chars(buffer.data() + size, buffer.data() + buffer.size(), value).ptr - buffer.data();
+        }
+
+        // Fixed notation with the given number of decimals, like printf("%.*f")
+        void Write(double value, int precision)
+        {
+            Reserve(MaxDoubleLength);
+            std::to_chars_result result = std::to_chars(buffer.data() + size, buffer.data() + buffer.size(), value, std::chars_format::fixed, precision);
+            if (result.ec != std::errc())
+            {
+                // Too long in fixed notation, e.g. 1e300
+                result = std::to_chars(buffer.data() + size, buffer.data() + buffer.size(), value);
+            }
+            size = result.ptr - buffer.data();
+        }
+
+        // The raw bytes of a value, for binary output
+        template <typename T>
+        void WriteBinary(const T& value)
+        {
+            Write(reinterpret_cast<const char*>(&value), sizeof(T));
+        }
+
+        void Flush()
+        {
+            WriteAll(buffer.data(), size);
+            size = 0;
+        }
+
+    private:
+        // Up to 17 significant digits, 20 decimals and the sign
+        static const size_t MaxDoubleLength = 64;
+
+        void WriteAll(const char* data, size_t length)
+        {
+            std::fflush(file);
+            while (length > 0)
+            {
+#ifdef _WIN32
+                int written = _write(_fileno(file), data, unsigned(std::min<size_t>(length, 1u << 30)));
+#else
+                ssize_t written = ::write(fileno(file), data, length);
+                if (written < 0 && errno == EINTR)
+                {
+                    continue;
+                }
+#endif
+                if (written <= 0)
+                {
+                    // A closed pipe or a full disk, nothing more can go out
+                    return;
+                }
+                data += written;
+                length -= written;
+            }
+        }
+
+        void Reserve(size_t length)
+        {
+            if (length > buffer.size() - size)
+            {
+                Flush();
+            }
+        }
+
+        FILE* file;
+        std::vector<char> buffer;
+        size_t size = 0;
+    };
+}
+
+#endif
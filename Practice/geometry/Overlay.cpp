@@ -0,0 +1,637 @@
+#include <algorithm>
+#include <cmath>
+#include <memory_resource>
+#include <set>
+
+#include "Overlay.h"
+#include "SegmentIntersection.h"
+
+namespace geometry
+{
+    namespace
+    {
+        bool IsLess(Point a, Point b)
+        {
+            return a.x < b.x || (a.x == b.x && a.y < b.y);
+        }
+
+        // A piece of the boundaries, A before B in x then y order
+        struct Edge
+        {
+            Point A;
+            Point B;
+            // Bit k is set when input k has the piece an odd number of times
+            int parity;
+        };
+
+        struct Cut
+        {
+            int edge;
+            Point P;
+        };
+
+        // A crossing rounded off the lines can cross something else, the pieces are checked
+        // again; it settles after one more pass in practice
+        const int MaxSplitPasses = 16;
+
+        // How close an end has to be to an edge, relative to the largest coordinate, for a
+        // crossing to be moved onto it. Nearly collinear edges would otherwise cross again
+        // after every pass, each rounded crossing tilting the pieces into more.
+        const int SnapExponent = -40;
+
+        bool IsInside(const Edge& e, Point P)
+        {
+            return IsLess(e.A, P) && IsLess(P, e.B);
+        }
+
+        // Pieces meet at their ends, the orientation there is zero without the exact path
+        double GetOrientation(const Edge& e, Point P)
+        {
+            return P == e.A || P == e.B ? 0.0 : Orient2D(e.A, e.B, P);
+        }
+
+        // From the orientations of f's ends against e and of e's ends against f: each goes
+        // through the inside of the other
+        bool IsProper(double fA, double fB, double eA, double eB)
+        {
+            return ((fA < 0.0 && fB > 0.0) || (fA > 0.0 && fB < 0.0)) && ((eA < 0.0 && eB > 0.0) || (eA > 0.0 && eB < 0.0));
+        }
+
+        bool IsCrossing(const Edge& e, const Edge& f)
+        {
+            return IsProper(GetOrientation(e, f.A), GetOrientation(e, f.B), GetOrientation(f, e.A), GetOrientation(f, e.B));
+        }
+
+        void AddRings(const std::vector<std::vector<Point>>& rings, int input, std::vector<Edge>& edges)
+        {
+            for (const std::vector<Point>& ring : rings)
+            {
+                for (int i = 0; i < ring.size(); i++)
+                {
+                    Point A = ring[i];
+                    Point B = ring[(i + 1) % ring.size()];
+                    if (A != B)
+                    {
+                        edges.push_back(IsLess(A, B) ? Edge{ A, B, 1 << input } : Edge{ B, A, 1 << input });
+                    }
+                }
+            }
+        }
+
+        // Edges i and j meet. Where they touch or overlap the ends of one are exactly on the
+        // other, those cuts go to exact. A proper crossing is rounded, it goes to crossings;
+        // true when it is off the line of one of them.
+        bool AddCuts(const std::vector<Edge>& edges, int i, int j, double snap, std::vector<Cut>& exact, std::vector<Cut>& crossings)
+        {
+            const Edge& e = edges[i];
+            const Edge& f = edges[j];
+            double fA = GetOrientation(e, f.A);
+            double fB = GetOrientation(e, f.B);
+            double eA = GetOrientation(f, e.A);
+            double eB = GetOrientation(f, e.B);
+
+            if (fA == 0.0 && IsInside(e, f.A))
+            {
+                exact.push_back({ i, f.A });
+            }
+            if (fB == 0.0 && IsInside(e, f.B))
+            {
+                exact.push_back({ i, f.B });
+            }
+            if (eA == 0.0 && IsInside(f, e.A))
+            {
+                exact.push_back({ j, e.A });
+            }
+            if (eB == 0.0 && IsInside(f, e.B))
+            {
+                exact.push_back({ j, e.B });
+            }
+
+            if (!IsProper(fA, fB, eA, eB))
+            {
+                return false;
+            }
+
+            // From either edge, whichever rounds inside both. The one on a vertical edge keeps
+            // its x.
+            Point AB = e.B - e.A;
+            Point CD = f.B - f.A;
+            double denominator = AB ^ CD;
+            Point P = e.A + ((f.A - e.A) ^ CD) / denominator * AB;
+            if (!IsInside(e, P) || !IsInside(f, P))
+            {
+                Point Q = f.A + ((f.A - e.A) ^ AB) / denominator * CD;
+                if (IsInside(e, Q) && IsInside(f, Q))
+                {
+                    P = Q;
+                }
+            }
+
+            // Rounded beyond an end it becomes that end, the pieces stay in order
+            if (!IsInside(e, P))
+            {
+                P = IsLess(P, e.B) ? e.A : e.B;
+            }
+            if (!IsInside(f, P))
+            {
+                P = IsLess(P, f.B) ? f.A : f.B;
+            }
+            // Nearly parallel edges cross anywhere along each other. Where an end is that close
+            // to the other edge the cut goes there instead, no new vertex comes up.
+            double nearest = snap;
+            // Orient2D() only has the sign right, the distance is worked out again
+            auto snapTo = [&](Point end, const Edge& other)
+            {
+                Point direction = other.B - other.A;
+                double distance = std::abs(direction ^ (end - other.A)) / vecta::len(direction);
+                if (distance <= nearest && IsInside(other, end))
+                {
+                    nearest = distance;
+                    P = end;
+                }
+            };
+            snapTo(f.A, e);
+            snapTo(f.B, e);
+            snapTo(e.A, f);
+            snapTo(e.B, f);
+            if (IsInside(e, P))
+            {
+                crossings.push_back({ i, P });
+            }
+            if (IsInside(f, P))
+            {
+                crossings.push_back({ j, P });
+            }
+            return GetOrientation(e, P) != 0.0 || GetOrientation(f, P) != 0.0;
+        }
+
+        // Anywhere but at an end of both
+        bool IsMeeting(const Edge& e, const Edge& f)
+        {
+            double fA = GetOrientation(e, f.A);
+            double fB = GetOrientation(e, f.B);
+            double eA = GetOrientation(f, e.A);
+            double eB = GetOrientation(f, e.B);
+            if ((fA == 0.0 && IsInside(e, f.A)) || (fB == 0.0 && IsInside(e, f.B)) || (eA == 0.0 && IsInside(f, e.A)) || (eB == 0.0 && IsInside(f, e.B)))
+            {
+                return true;
+            }
+            return IsProper(fA, fB, eA, eB);
+        }
+
+        // Equal pieces become one, the ones every input has an even number of times go
+        void Merge(std::vector<Edge>& edges)
+        {
+            std::sort(edges.begin(), edges.end(), [](const Edge& a, const Edge& b)
+            {
+                return IsLess(a.A, b.A) || (a.A == b.A && IsLess(a.B, b.B));
+            });
+            int size = 0;
+            for (int i = 0; i < edges.size();)
+            {
+                Edge edge = edges[i];
+                for (i++; i < edges.size() && edges[i].A == edge.A && edges[i].B == edge.B; i++)
+                {
+                    edge.parity ^= edges[i].parity;
+                }
+                if (edge.parity != 0)
+                {
+                    edges[size++] = edge;
+                }
+            }
+            edges.resize(size);
+        }
+
+        void ApplyCuts(std::vector<Edge>& edges, std::vector<Cut>& cuts, std::vector<Edge>& pieces)
+        {
+            std::sort(cuts.begin(), cuts.end(), [](const Cut& a, const Cut& b)
+            {
+                return a.edge < b.edge || (a.edge == b.edge && IsLess(a.P, b.P));
+            });
+            pieces.clear();
+            pieces.reserve(edges.size() + cuts.size());
+            int next = 0;
+            for (int i = 0; i < edges.size(); i++)
+            {
+                Point A = edges[i].A;
+                for (; next < cuts.size() && cuts[next].edge == i; next++)
+                {
+                    if (cuts[next].P != A)
+                    {
+                        pieces.push_back({ A, cuts[next].P, edges[i].parity });
+                        A = cuts[next].P;
+                    }
+                }
+                pieces.push_back({ A, edges[i].B, edges[i].parity });
+            }
+            edges.swap(pieces);
+            Merge(edges);
+        }
+
+        double GetSnap(const std::vector<Edge>& edges)
+        {
+            double scale = 0.0;
+            for (const Edge& e : edges)
+            {
+                scale = std::max({ scale, std::abs(e.A.x), std::abs(e.A.y), std::abs(e.B.x), std::abs(e.B.y) });
+            }
+            return std::ldexp(scale, SnapExponent);
+        }
+
+        // Until the edges only meet at their ends, or until a pass rounds crossings: true then,
+        // the pieces may cross something else and Coverage checks. An edge cut exactly overlaps
+        // or touches another, its crossings wait for a pass over the merged pieces so that each
+        // crossing is computed once; the other crossings go in with the exact cuts.
+        bool Split(std::vector<Edge>& edges, double snap, int& pass)
+        {
+            std::vector<Segment> segments;
+            std::vector<SegmentIntersection> intersections;
+            std::vector<Cut> exact;
+            std::vector<Cut> crossings;
+            std::vector<Edge> pieces;
+            std::vector<char> isCut;
+            for (; pass < MaxSplitPasses; pass++)
+            {
+                segments.resize(edges.size());
+                for (int i = 0; i < edges.size(); i++)
+                {
+                    segments[i] = { edges[i].A, edges[i].B };
+                }
+
+                exact.clear();
+                crossings.clear();
+                bool isRounded = false;
+                intersections = GetIntersections(segments);
+                for (const SegmentIntersection& intersection : intersections)
+                {
+                    isRounded = AddCuts(edges, intersection.first, intersection.second, snap, exact, crossings) || isRounded;
+                }
+                if (crossings.empty())
+                {
+                    if (exact.empty())
+                    {
+                        return false;
+                    }
+                    ApplyCuts(edges, exact, pieces);
+                    continue;
+                }
+
+                bool isHeld = false;
+                if (!exact.empty())
+                {
+                    isCut.assign(edges.size(), false);
+                    for (const Cut& cut : exact)
+                    {
+                        isCut[cut.edge] = true;
+                    }
+                    crossings.clear();
+                    isRounded = false;
+                    for (const SegmentIntersection& intersection : intersections)
+                    {
+                        int i = intersection.first;
+                        int j = intersection.second;
+                        if (isCut[i] || isCut[j])
+                        {
+                            isHeld = isHeld || IsCrossing(edges[i], edges[j]);
+                        }
+                        else
+                        {
+                            isRounded = AddCuts(edges, i, j, snap, exact, crossings) || isRounded;
+                        }
+                    }
+                    crossings.insert(crossings.end(), exact.begin(), exact.end());
+                }
+                ApplyCuts(edges, crossings, pieces);
+                if (isHeld)
+                {
+                    continue;
+                }
+                pass++;
+                return isRounded;
+            }
+            return false;
+        }
+
+        // The inputs that are inside just below every edge. Below is right of A to B, for a
+        // vertical edge that is the side of larger x. The edges only meet at their ends, so
+        // the one under an edge when it starts stays under it.
+        // Checked, it finds out on the way whether that is so: every two edges that come next
+        // to each other are compared, and the first place where any meet is found before the
+        // sweep gets there (Shamos-Hoey).
+        class Coverage
+        {
+        public:
+            explicit Coverage(const std::vector<Edge>& edges)
+                : edges(edges), below(edges.size(), 0), positions(edges.size()), status(EdgeCompare{ this }, &nodes)
+            {
+            }
+
+            // False when checked and two edges meet
+            bool Run(bool isChecked, std::vector<int>& result)
+            {
+                struct Event
+                {
+                    Point P;
+                    int edge;
+                    bool isStart;
+                };
+                std::vector<Event> events;
+                events.reserve(2 * edges.size());
+                for (int i = 0; i < edges.size(); i++)
+                {
+                    events.push_back({ edges[i].A, i, true });
+                    events.push_back({ edges[i].B, i, false });
+                }
+                // At a point the edges ending there go first, then the ones starting there
+                // from the lowest up, each starts above the one before
+                std::sort(events.begin(), events.end(), [this](const Event& a, const Event& b)
+                {
+                    if (a.P != b.P)
+                    {
+                        return IsLess(a.P, b.P);
+                    }
+                    if (a.isStart != b.isStart)
+                    {
+                        return !a.isStart;
+                    }
+                    if (!a.isStart)
+                    {
+                        return a.edge < b.edge;
+                    }
+                    return Orient2D(a.P, edges[a.edge].B, edges[b.edge].B) > 0.0;
+                });
+
+                // The edges ending at a point leave a gap that the ones starting there fill, the
+                // set is only searched for a point where none end
+                Point point = Point(0.0, 0.0);
+                Position hint = status.end();
+                bool hasHint = false;
+                for (const Event& event : events)
+                {
+                    if (!hasHint || event.P != point)
+                    {
+                        point = event.P;
+                        hasHint = false;
+                    }
+
+                    if (!event.isStart)
+                    {
+                        hint = status.erase(positions[event.edge]);
+                        hasHint = true;
+                        if (isChecked && hint != status.begin() && hint != status.end() && IsMeeting(edges[*std::prev(hint)], edges[*hint]))
+                        {
+                            return false;
+                        }
+                        continue;
+                    }
+
+                    inserting = event.edge;
+                    Position position = hasHint ? status.insert(hint, event.edge) : status.insert(event.edge).first;
+                    inserting = -1;
+                    positions[event.edge] = position;
+                    hint = std::next(position);
+                    hasHint = true;
+                    if (position != status.begin())
+                    {
+                        int under = *std::prev(position);
+                        below[event.edge] = below[under] ^ edges[under].parity;
+                        if (isChecked && IsMeeting(edges[under], edges[event.edge]))
+                        {
+                            return false;
+                        }
+                    }
+                    if (isChecked && hint != status.end() && IsMeeting(edges[event.edge], edges[*hint]))
+                    {
+                        return false;
+                    }
+                }
+                result.swap(below);
+                return true;
+            }
+
+        private:
+            struct EdgeCompare
+            {
+                const Coverage* coverage;
+
+                bool operator()(int a, int b) const
+                {
+                    return coverage->IsBelow(a, b);
+                }
+            };
+
+            // Only the edge being inserted is ever compared
+            bool IsBelow(int a, int b) const
+            {
+                if (a == inserting)
+                {
+                    return GetSide(a, b) < 0;
+                }
+                if (b == inserting)
+                {
+                    return GetSide(b, a) > 0;
+                }
+                return a < b;
+            }
+
+            // Edge s starts at the sweep point, where is it against t
+            int GetSide(int s, int t) const
+            {
+                double side = GetOrientation(edges[t], edges[s].A);
+                if (side == 0.0)
+                {
+                    side = GetOrientation(edges[t], edges[s].B);
+                }
+                if (side == 0.0)
+                {
+                    return s < t ? -1 : 1;
+                }
+                return side < 0.0 ? -1 : 1;
+            }
+
+            typedef std::pmr::set<int, EdgeCompare>::iterator Position;
+
+            const std::vector<Edge>& edges;
+            std::vector<int> below;
+            std::vector<Position> positions;
+            // Every edge is inserted once, the nodes come from a few large blocks
+            std::pmr::monotonic_buffer_resource nodes;
+            std::pmr::set<int, EdgeCompare> status;
+            int inserting = -1;
+        };
+
+        bool IsInResult(int inside, BooleanOperation operation)
+        {
+            bool a = (inside & 1) != 0;
+            bool b = (inside & 2) != 0;
+            switch (operation)
+            {
+            case BooleanOperation::Union:
+                return a || b;
+            case BooleanOperation::Intersection:
+                return a && b;
+            case BooleanOperation::Difference:
+                return a && !b;
+            default:
+                return a != b;
+            }
+        }
+
+        // An edge at V towards other, in or out of V
+        struct HalfEdge
+        {
+            Point V;
+            Point other;
+            int edge;
+            bool isOut;
+        };
+
+        // Around V counter-clockwise, starting from the direction of +x
+        bool IsBeforeAround(const HalfEdge& a, const HalfEdge& b)
+        {
+            if (a.V != b.V)
+            {
+                return IsLess(a.V, b.V);
+            }
+            bool isLowerA = a.other.y < a.V.y || (a.other.y == a.V.y && a.other.x < a.V.x);
+            bool isLowerB = b.other.y < b.V.y || (b.other.y == b.V.y && b.other.x < b.V.x);
+            if (isLowerA != isLowerB)
+            {
+                return isLowerB;
+            }
+            return Orient2D(a.V, a.other, b.other) > 0.0;
+        }
+
+        // The pieces of a split edge leave vertices on a line
+        void AddRing(const std::vector<Point>& ring, std::vector<std::vector<Point>>& rings)
+        {
+            std::vector<Point> corners;
+            corners.reserve(ring.size());
+            int n = int(ring.size());
+            for (int i = 0; i < n; i++)
+            {
+                if (Orient2D(ring[i ? i - 1 : n - 1], ring[i], ring[(i + 1) % n]) != 0.0)
+                {
+                    corners.push_back(ring[i]);
+                }
+            }
+            if (corners.size() >= 3)
+            {
+                rings.push_back(std::move(corners));
+            }
+        }
+
+        // The boundary edges have the region on their left, so around every vertex they
+        // alternate out and in and the region is between an in edge and the out edge
+        // clockwise from it. Following those turns traces the boundary of each face; where a
+        // face touches itself, like a hole at a vertex of the outer boundary, the walk passes
+        // a vertex twice and is cut there into rings of their own.
+        std::vector<std::vector<Point>> GetRings(const std::vector<Segment>& boundary)
+        {
+            int m = int(boundary.size());
+            std::vector<HalfEdge> halfEdges;
+            halfEdges.reserve(2 * m);
+            for (int e = 0; e < m; e++)
+            {
+                halfEdges.push_back({ boundary[e].A, boundary[e].B, e, true });
+                halfEdges.push_back({ boundary[e].B, boundary[e].A, e, false });
+            }
+            std::sort(halfEdges.begin(), halfEdges.end(), IsBeforeAround);
+
+            std::vector<int> next(m, -1);
+            std::vector<int> vertex(m);
+            int vertexCount = 0;
+            for (int begin = 0; begin < halfEdges.size(); vertexCount++)
+            {
+                int end = begin + 1;
+                while (end < halfEdges.size() && halfEdges[end].V == halfEdges[begin].V)
+                {
+                    end++;
+                }
+                for (int j = begin; j < end; j++)
+                {
+                    if (halfEdges[j].isOut)
+                    {
+                        vertex[halfEdges[j].edge] = vertexCount;
+                        continue;
+                    }
+                    int k = j;
+                    do
+                    {
+                        k = (k == begin ? end : k) - 1;
+                    } while (!halfEdges[k].isOut && k != j);
+                    next[halfEdges[j].edge] = halfEdges[k].edge;
+                }
+                begin = end;
+            }
+
+            std::vector<std::vector<Point>> rings;
+            std::vector<char> isUsed(m, false);
+            // Where each vertex is on the walk so far, -1 when it is not
+            std::vector<int> position(vertexCount, -1);
+            std::vector<int> walk;
+            std::vector<Point> ring;
+            auto cutLoop = [&](int from)
+            {
+                ring.clear();
+                for (int i = from; i < walk.size(); i++)
+                {
+                    ring.push_back(boundary[walk[i]].A);
+                    position[vertex[walk[i]]] = -1;
+                }
+                walk.resize(from);
+                AddRing(ring, rings);
+            };
+            for (int start = 0; start < m; start++)
+            {
+                for (int e = start; e >= 0 && !isUsed[e]; e = next[e])
+                {
+                    isUsed[e] = true;
+                    if (position[vertex[e]] >= 0)
+                    {
+                        cutLoop(position[vertex[e]]);
+                    }
+                    position[vertex[e]] = int(walk.size());
+                    walk.push_back(e);
+                }
+                cutLoop(0);
+            }
+            return rings;
+        }
+    }
+
+    std::vector<std::vector<Point>> Overlay(const std::vector<std::vector<Point>>& subject, const std::vector<std::vector<Point>>& clipping, BooleanOperation operation)
+    {
+        GEOMETRY_STAGE(stage, "Overlay/split");
+        std::vector<Edge> edges;
+        AddRings(subject, 0, edges);
+        AddRings(clipping, 1, edges);
+        Merge(edges);
+        double snap = GetSnap(edges);
+        int pass = 0;
+        bool isRounded = Split(edges, snap, pass);
+
+        // Rounded crossings are checked on the way instead of in another pass of Split(), they
+        // hardly ever cross anything
+        GEOMETRY_NEXT_STAGE(stage, "Overlay/coverage");
+        std::vector<int> below;
+        while (!Coverage(edges).Run(isRounded, below))
+        {
+            isRounded = Split(edges, snap, pass);
+        }
+
+        GEOMETRY_NEXT_STAGE(stage, "Overlay/rings");
+        std::vector<Segment> boundary;
+        for (int i = 0; i < edges.size(); i++)
+        {
+            bool isBelow = IsInResult(below[i], operation);
+            bool isAbove = IsInResult(below[i] ^ edges[i].parity, operation);
+            if (isBelow != isAbove)
+            {
+                // The region on the left
+                boundary.push_back(isAbove ? Segment{ edges[i].A, edges[i].B } : Segment{ edges[i].B, edges[i].A });
+            }
+        }
+        return GetRings(boundary);
+    }
+}
@@ -0,0 +1,32 @@
+#ifndef OVERLAY_H
+#define OVERLAY_H
+
+#include <vector>
+
+#include "Geometry.h"
+
+namespace geometry
+{
+    enum class BooleanOperation
+    {
+        Union,
+        Intersection,
+        Difference,
+        Xor,
+    };
+
+    // Boolean operations on regions given as rings filled by the even-odd rule: a ring inside
+    // another is a hole, orientation does not matter and rings may cross themselves and each
+    // other. The result rings have the region on their left, outer ones counter-clockwise and
+    // holes clockwise, without collinear vertices. They do not cross but may touch at vertices,
+    // except in slivers of rounding width where many edges are nearly collinear.
+    //
+    // The edges are split where they meet until no two cross (GetIntersections(), exact
+    // predicates; the pieces of a rounded crossing are checked in the sweep after it), equal
+    // pieces are merged and one sweep finds which side of each piece is inside subject and
+    // clipping.
+    // O((n + k) log n) time and O(n + k) memory for n edges with k intersections.
+    std::vector<std::vector<Point>> Overlay(const std::vector<std::vector<Point>>& subject, const std::vector<std::vector<Point>>& clipping, BooleanOperation operation);
+}
+
+#endif
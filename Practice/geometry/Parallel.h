@@ -0,0 +1,38 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <algorithm>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+namespace geometry
+{
+    // 0 means std::thread::hardware_concurrency()
+    inline int GetThreadCount(int threadCount)
+    {
+        return threadCount > 0 ? threadCount : std::max(1, int(std::thread::hardware_concurrency()));
+    }
+
+    // Runs work(chunk, begin, end) over [0, count) split into one chunk per thread,
+    // chunks cover increasing ranges
+    template <typename Work>
+    void ParallelFor(int count, int threadCount, Work work)
+    {
+        int chunkCount = std::max(1, std::min(threadCount, count / 1024));
+        auto getBound = [&](int chunk) { return int(int64_t(count) * chunk / chunkCount); };
+
+        std::vector<std::thread> threads;
+        for (int chunk = 1; chunk < chunkCount; chunk++)
+        {
+            threads.emplace_back(work, chunk, getBound(chunk), getBound(chunk + 1));
+        }
+        work(0, 0, getBound(1));
+        for (std::thread& thread : threads)
+        {
+            thread.join();
+        }
+    }
+}
+
+#endif
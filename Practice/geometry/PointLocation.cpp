@@ -0,0 +1,367 @@
+#include <algorithm>
+#include <cmath>
+
+#include "PointLocation.h"
+
+namespace geometry
+{
+    const char* ToString(PointLocation location)
+    {
+        switch (location)
+        {
+        case PointLocation::Inside: return "Inside";
+        case PointLocation::Outside: return "Outside";
+        case PointLocation::Edge: return "Edge";
+        default: return "";
+        }
+    }
+
+    const char* ToString(FillRule fillRule)
+    {
+        switch (fillRule)
+        {
+        case FillRule::NonZero: return "NonZero";
+        case FillRule::EvenOdd: return "EvenOdd";
+        default: return "";
+        }
+    }
+
+    Orientation GetPolygonOrientation(const std::vector<Point>& polygon)
+    {
+        double area = 0.0;
+        for (int i = 0; i < polygon.size(); i++)
+        {
+            Point L = polygon[i ? i - 1 : polygon.size() - 1];
+            Point B = polygon[i];
+            Point R = polygon[(i + 1) % polygon.size()];
+            area += GetAreaFromPoints(L, B, R);
+        }
+        if (area == 0.0)
+        {
+            return Orientation::Colinear;
+        }
+        return area < 0.0 ? Orientation::Clockwise : Orientation::CounterClockWise;
+    }
+
+    PointLocation GetPointLocation(const std::vector<Point>& polygon, Point P)
+    {
+        // Crossings of the ray from P to the right. An edge crosses the line of P when one end
+        // is above P and the other is not, so a vertex on the line counts once.
+        bool inside = false;
+        for (int i = 0; i < polygon.size(); i++)
+        {
+            Point A = polygon[i];
+            Point B = polygon[(i + 1) % polygon.size()];
+
+            // Neither on the edge nor crossing the line of P
+            if (!IsBetween(P.y, std::min(A.y, B.y), std::max(A.y, B.y)))
+            {
+                continue;
+            }
+
+            double area = Orient2D(A, B, P);
+            if (area == 0.0 && IsBetween(P.x, std::min(A.x, B.x), std::max(A.x, B.x)))
+            {
+                return PointLocation::Edge;
+            }
+
+            if ((A.y > P.y) != (B.y > P.y))
+            {
+                // Right of P when P is left of an upward edge or right of a downward one
+                bool isUpward = B.y > A.y;
+                if ((area > 0.0) == isUpward)
+                {
+                    inside = !inside;
+                }
+            }
+        }
+
+        return inside ? PointLocation::Inside : PointLocation::Outside;
+    }
+
+    namespace
+    {
+        // Sunday's winding number: an upward edge with P on its left adds one, a downward edge
+        // with P on its right takes one away. The edges are from, from + 1, .. end - 1 and
+        // end - 1 back to from. Edges on the line of P whose side plain doubles cannot tell
+        // are counted in uncertain instead.
+        int GetWinding(const Point* from, const Point* end, Point P, int& uncertain)
+        {
+            const double errorBound = 3.3306690738754716e-16; // The one of Orient2D
+            int winding = 0;
+            int unsure = 0;
+            auto add = [&](Point A, Point B)
+            {
+                double detLeft = (A.x - P.x) * (B.y - P.y);
+                double detRight = (A.y - P.y) * (B.x - P.x);
+                double det = detLeft - detRight;
+                bool isAboveA = A.y > P.y;
+                bool isAboveB = B.y > P.y;
+                bool isOnLine = !(isAboveA & isAboveB) & !((A.y < P.y) & (B.y < P.y));
+                winding += int(!isAboveA & isAboveB & (det > 0.0)) - int(isAboveA & !isAboveB & (det < 0.0));
+                unsure += int(isOnLine & (std::abs(det) <= errorBound * (std::abs(detLeft) + std::abs(detRight))));
+            };
+            int count = int(end - from);
+            for (int i = 0; i + 1 < count; i++)
+            {
+                add(from[i], from[i + 1]);
+            }
+            if (count > 1)
+            {
+                add(from[count - 1], from[0]);
+            }
+            uncertain += unsure;
+            return winding;
+        }
+
+        // The same with exact orientations, false when P is on an edge
+        bool GetWindingExact(const Point* from, const Point* end, Point P, int& winding)
+        {
+            for (const Point* A = from; A < end; A++)
+            {
+                Point B = A + 1 < end ? A[1] : from[0];
+                if (!IsBetween(P.y, std::min(A->y, B.y), std::max(A->y, B.y)))
+                {
+                    continue;
+                }
+                double area = Orient2D(*A, B, P);
+                if (area == 0.0 && IsBetween(P.x, std::min(A->x, B.x), std::max(A->x, B.x)))
+                {
+                    return false;
+                }
+                bool isAboveA = A->y > P.y;
+                bool isAboveB = B.y > P.y;
+                winding += int(!isAboveA && isAboveB && area > 0.0) - int(isAboveA && !isAboveB && area < 0.0);
+            }
+            return true;
+        }
+
+        PointLocation GetPointLocation(const Point* points, const int* offsets, int ringCount, Point P, FillRule fillRule)
+        {
+            int winding = 0;
+            int uncertain = 0;
+            for (int i = 0; i < ringCount; i++)
+            {
+                winding += GetWinding(points + offsets[i], points + offsets[i + 1], P, uncertain);
+            }
+            if (uncertain > 0)
+            {
+                winding = 0;
+                for (int i = 0; i < ringCount; i++)
+                {
+                    if (!GetWindingExact(points + offsets[i], points + offsets[i + 1], P, winding))
+                    {
+                        return PointLocation::Edge;
+                    }
+                }
+            }
+            bool isInside = fillRule == FillRule::NonZero ? winding != 0 : (winding & 1) != 0;
+            return isInside ? PointLocation::Inside : PointLocation::Outside;
+        }
+    }
+
+    PointLocation GetPointLocation(const std::vector<Point>& polygon, Point P, FillRule fillRule)
+    {
+        int offsets[] = { 0, int(polygon.size()) };
+        return GetPointLocation(polygon.data(), offsets, 1, P, fillRule);
+    }
+
+    PointLocation GetPointLocation(const std::vector<Point>& rings, const std::vector<int>& offsets, Point P, FillRule fillRule)
+    {
+        return GetPointLocation(rings.data(), offsets.data(), int(offsets.size()) - 1, P, fillRule);
+    }
+
+    int GetWindingNumber(const std::vector<Point>& rings, const std::vector<int>& offsets, Point P)
+    {
+        int winding = 0;
+        int uncertain = 0;
+        for (int i = 0; i + 1 < offsets.size(); i++)
+        {
+            winding += GetWinding(rings.data() + offsets[i], rings.data() + offsets[i + 1], P, uncertain);
+        }
+        if (uncertain > 0)
+        {
+            winding = 0;
+            for (int i = 0; i + 1 < offsets.size(); i++)
+            {
+                GetWindingExact(rings.data() + offsets[i], rings.data() + offsets[i + 1], P, winding);
+            }
+        }
+        return winding;
+    }
+
+    PointLocation GetPointLocationFromAngle(Point A, Point B, Point C, Point P)
+    {
+        Orientation BCP = GetOrientation(B, C, P);
+        Orientation ABP = GetOrientation(A, B, P);
+
+        if (BCP == Orientation::Colinear || ABP == Orientation::Colinear)
+        {
+            Point AP = P - A;
+            Point BP = P - B;
+            Point CP = P - C;
+            double BPDotCP = BP * CP;
+            double APDotBP = AP * BP;
+            if ((BCP == Orientation::Colinear && BPDotCP < 0) || (ABP == Orientation::Colinear && APDotBP < 0) || (APDotBP == 0.0 && BPDotCP == 0.0))
+            {
+                return PointLocation::Edge;
+            }
+        }
+        else if (BCP == ABP)
+        {
+            return PointLocation::Inside;
+        }
+
+        return PointLocation::Outside;
+    }
+
+    PointLocation GetPointLocationLinear(const std::vector<Point>& polygon, Point P)
+    {
+        Orientation polygonOrientation = GetPolygonOrientation(polygon);
+
+        for (int i = 0; i < polygon.size(); i++)
+        {
+            Point L = polygon[i ? i - 1 : polygon.size() - 1];
+            Point B = polygon[i];
+
+            Orientation orientation = GetOrientation(L, B, P);
+            if (orientation == Orientation::Colinear)
+            {
+                // On the line of an edge of a convex polygon, but maybe not on the edge
+                bool isOnEdge = IsBetween(P.x, std::min(L.x, B.x), std::max(L.x, B.x)) && IsBetween(P.y, std::min(L.y, B.y), std::max(L.y, B.y));
+                return isOnEdge ? PointLocation::Edge : PointLocation::Outside;
+            }
+
+            if (polygonOrientation != orientation)
+            {
+                return PointLocation::Outside;
+            }
+        }
+
+        return PointLocation::Inside;
+    }
+
+    int GetFanIndex(const std::vector<Point>& polygon, double sign, Point P)
+    {
+        Point B = polygon[0];
+        int leftIndex = 1;
+        int rightIndex = int(polygon.size()) - 1;
+        while (rightIndex - leftIndex > 1)
+        {
+            int mid = leftIndex + (rightIndex - leftIndex) / 2;
+            if (sign * Orient2D(B, polygon[mid], P) >= 0.0)
+            {
+                leftIndex = mid;
+            }
+            else
+            {
+                rightIndex = mid;
+            }
+        }
+        return leftIndex;
+    }
+
+    PointLocation GetPointLocationBinary(const std::vector<Point>& polygon, Point P)
+    {
+        int n = int(polygon.size());
+        if (n < 3)
+        {
+            return GetPointLocation(polygon, P);
+        }
+
+        // Strictly convex, so any three vertices give the orientation. The fan from B is
+        // searched as if it were counter-clockwise.
+        Point B = polygon[0];
+        double sign = Orient2D(B, polygon[1], polygon[2]) < 0.0 ? -1.0 : 1.0;
+        auto getSide = [&](Point from, Point to)
+        {
+            return sign * Orient2D(from, to, P);
+        };
+        auto isOnSegment = [&](Point from, Point to)
+        {
+            return IsBetween(P.x, std::min(from.x, to.x), std::max(from.x, to.x)) && IsBetween(P.y, std::min(from.y, to.y), std::max(from.y, to.y));
+        };
+
+        // Outside the angle of the fan, or on one of its first and last edges
+        double first = getSide(B, polygon[1]);
+        double last = getSide(B, polygon[n - 1]);
+        if (first < 0.0 || last > 0.0)
+        {
+            return PointLocation::Outside;
+        }
+        if (first == 0.0 || last == 0.0)
+        {
+            Point end = first == 0.0 ? polygon[1] : polygon[n - 1];
+            return isOnSegment(B, end) ? PointLocation::Edge : PointLocation::Outside;
+        }
+
+        int leftIndex = GetFanIndex(polygon, sign, P);
+        double side = getSide(polygon[leftIndex], polygon[leftIndex + 1]);
+        if (side == 0.0)
+        {
+            return PointLocation::Edge;
+        }
+        return side > 0.0 ? PointLocation::Inside : PointLocation::Outside;
+    }
+
+    namespace
+    {
+        // Orientation of P against the edge of the chain from A to B that spans P.x
+        double GetChainSide(const std::vector<Point>& chain, Point A, Point B, Point P)
+        {
+            auto isLeftOf = [](double x, const Point& C) { return x < C.x; };
+            std::vector<Point>::const_iterator next = std::upper_bound(chain.begin(), chain.end(), P.x, isLeftOf);
+            Point L = next == chain.begin() ? A : *(next - 1);
+            Point R = next == chain.end() ? B : *next;
+            if (L == R)
+            {
+                // P.x is the x of the last vertex
+                L = next - 1 == chain.begin() ? A : *(next - 2);
+            }
+            return Orient2D(L, R, P);
+        }
+    }
+
+    PointLocation GetPointLocationMonotone(const std::vector<Point>& upperChain, const std::vector<Point>& lowerChain, Point P)
+    {
+        Point A = upperChain[0];
+        Point B = upperChain[0];
+        for (const Point& C : upperChain)
+        {
+            if (A.x > C.x)
+            {
+                A = C;
+            }
+            if (C.x > B.x)
+            {
+                B = C;
+            }
+        }
+
+        for (const Point& C : lowerChain)
+        {
+            if (A.x > C.x)
+            {
+                A = C;
+            }
+            if (C.x > B.x)
+            {
+                B = C;
+            }
+        }
+
+        if (P.x < A.x || P.x > B.x)
+        {
+            return PointLocation::Outside;
+        }
+
+        // The interior is right of the upper chain and left of the lower one, both walked to the right
+        double upperSide = GetChainSide(upperChain, A, B, P);
+        double lowerSide = GetChainSide(lowerChain, A, B, P);
+        if (upperSide == 0.0 || lowerSide == 0.0)
+        {
+            return PointLocation::Edge;
+        }
+        return upperSide < 0.0 && lowerSide > 0.0 ? PointLocation::Inside : PointLocation::Outside;
+    }
+}
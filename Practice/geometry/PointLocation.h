@@ -0,0 +1,72 @@
+#ifndef POINT_LOCATION_H
+#define POINT_LOCATION_H
+
+#include <vector>
+
+#include "Geometry.h"
+
+namespace geometry
+{
+    enum class PointLocation
+    {
+        Inside,
+        Outside,
+        Edge,
+    };
+
+    const char* ToString(PointLocation location);
+
+    // Which points a ring that crosses or overlaps itself covers: winding number not zero, or odd
+    enum class FillRule
+    {
+        NonZero,
+        EvenOdd,
+    };
+
+    const char* ToString(FillRule fillRule);
+
+    Orientation GetPolygonOrientation(const std::vector<Point>& polygon);
+
+    template <typename T>
+    bool IsBetween(T x, T a, T b)
+    {
+        return a <= x && x <= b;
+    }
+
+    // Ray casting, works for any simple polygon in either orientation
+    PointLocation GetPointLocation(const std::vector<Point>& polygon, Point P);
+
+    // Winding number of any ring, also self-intersecting ones. One pass of plain doubles over
+    // the edges without branches; only when P is within rounding of an edge are they counted
+    // again with the exact Orient2D.
+    PointLocation GetPointLocation(const std::vector<Point>& polygon, Point P, FillRule fillRule);
+
+    // The same over all rings of a multipolygon at once, ring i is
+    // rings[offsets[i]] .. rings[offsets[i + 1] - 1]. Holes go the other way round from their
+    // outer ring for NonZero.
+    PointLocation GetPointLocation(const std::vector<Point>& rings, const std::vector<int>& offsets, Point P, FillRule fillRule);
+
+    // Sum of the windings of the rings around P, P must not be on them
+    int GetWindingNumber(const std::vector<Point>& rings, const std::vector<int>& offsets, Point P);
+
+    // Location of P against the angle ABC, the rays BA and BC are its edges
+    PointLocation GetPointLocationFromAngle(Point A, Point B, Point C, Point P);
+
+    // Convex polygons only, checks every edge
+    PointLocation GetPointLocationLinear(const std::vector<Point>& polygon, Point P);
+
+    // Binary search over the fan of triangles from the first vertex of a strictly convex
+    // polygon, sign is 1 when it is counter-clockwise and -1 when clockwise. P has to be in the
+    // angle of the fan, the result is the i with P in the triangle polygon[0], polygon[i],
+    // polygon[i + 1] or beyond its far edge.
+    int GetFanIndex(const std::vector<Point>& polygon, double sign, Point P);
+
+    // Strictly convex polygons only, binary search over the fan of triangles from the first vertex
+    PointLocation GetPointLocationBinary(const std::vector<Point>& polygon, Point P);
+
+    // x-monotone polygon given by its chains, both ordered by increasing x with strictly
+    // increasing x. The left and right most vertices may be in either chain.
+    PointLocation GetPointLocationMonotone(const std::vector<Point>& upperChain, const std::vector<Point>& lowerChain, Point P);
+}
+
+#endif
@@ -0,0 +1,66 @@
+#include "PolygonIndex.h"
+
+namespace geometry
+{
+    namespace
+    {
+        std::vector<Box> GetBoundingBoxes(const std::vector<std::vector<Point>>& polygons)
+        {
+            std::vector<Box> boxes(polygons.size());
+            for (int i = 0; i < polygons.size(); i++)
+            {
+                // Empty polygons get an inverted box that contains nothing
+                boxes[i] = polygons[i].empty() ? Box{ Point(1.0, 1.0), Point(0.0, 0.0) } : GetBoundingBox(polygons[i]);
+            }
+            return boxes;
+        }
+    }
+
+    PolygonIndex::PolygonIndex(const std::vector<std::vector<Point>>& polygons, int nodeSize)
+        : polygons(polygons), tree(GetBoundingBoxes(polygons), nodeSize)
+    {
+    }
+
+    std::vector<int> PolygonIndex::GetContainingPolygons(Point P) const
+    {
+        std::vector<int> result;
+        tree.Search(P, [&](int polygon)
+        {
+            if (Contains(polygon, P))
+            {
+                result.push_back(polygon);
+            }
+        });
+        return result;
+    }
+
+    void PolygonIndex::GetContainingPolygons(const std::vector<Point>& queries, std::vector<int>& offsets, std::vector<int>& items) const
+    {
+        // The tree reports hits out of query order, they are bucketed by query afterwards
+        std::vector<std::pair<int, int>> hits;
+        tree.Search(queries, [&](int query, int polygon)
+        {
+            if (Contains(polygon, queries[query]))
+            {
+                hits.push_back({ query, polygon });
+            }
+        });
+
+        offsets.assign(queries.size() + 1, 0);
+        for (const std::pair<int, int>& hit : hits)
+        {
+            offsets[hit.first + 1]++;
+        }
+        for (int i = 0; i < queries.size(); i++)
+        {
+            offsets[i + 1] += offsets[i];
+        }
+
+        items.resize(hits.size());
+        std::vector<int> position(offsets.begin(), offsets.end() - 1);
+        for (const std::pair<int, int>& hit : hits)
+        {
+            items[position[hit.first]++] = hit.second;
+        }
+    }
+}
@@ -0,0 +1,35 @@
+#ifndef POLYGON_INDEX_H
+#define POLYGON_INDEX_H
+
+#include <vector>
+
+#include "HilbertRTree.h"
+#include "PointLocation.h"
+
+namespace geometry
+{
+    // Answers "which polygons contain P": the R-tree over the bounding boxes picks the
+    // candidates and GetPointLocation() decides. Points on an edge count as contained.
+    // The polygons are not copied and must outlive the index.
+    class PolygonIndex
+    {
+    public:
+        explicit PolygonIndex(const std::vector<std::vector<Point>>& polygons, int nodeSize = 16);
+
+        std::vector<int> GetContainingPolygons(Point P) const;
+
+        // The polygons containing queries[i] are items[offsets[i]] .. items[offsets[i + 1] - 1]
+        void GetContainingPolygons(const std::vector<Point>& queries, std::vector<int>& offsets, std::vector<int>& items) const;
+
+    private:
+        bool Contains(int polygon, Point P) const
+        {
+            return GetPointLocation(polygons[polygon], P) != PointLocation::Outside;
+        }
+
+        const std::vector<std::vector<Point>>& polygons;
+        HilbertRTree tree;
+    };
+}
+
+#endif
@@ -0,0 +1,246 @@
+#include <cmath>
+
+#include "Geometry.h"
+
+namespace geometry
+{
+    namespace
+    {
+        // Error-free transformations: a + b = x + y and a * b = x + y exactly
+        inline void TwoSum(double a, double b, double& x, double& y)
+        {
+            x = a + b;
+            double bVirtual = x - a;
+            double aVirtual = x - bVirtual;
+            y = (a - aVirtual) + (b - bVirtual);
+        }
+
+        inline void FastTwoSum(double a, double b, double& x, double& y)
+        {
+            x = a + b;
+            y = b - (x - a);
+        }
+
+        inline void TwoProduct(double a, double b, double& x, double& y)
+        {
+            x = a * b;
+            y = std::fma(a, b, -x);
+        }
+
+        // A sum of non-overlapping doubles ordered by increasing magnitude. The sign of
+        // the whole sum is the sign of the last (largest) term.
+        template <int N>
+        struct Expansion
+        {
+            int size = 0;
+            double terms[N];
+
+            void Push(double term)
+            {
+                if (term != 0.0)
+                {
+                    terms[size++] = term;
+                }
+            }
+
+            double Sign() const
+            {
+                return size ? terms[size - 1] : 0.0;
+            }
+        };
+
+        int SumInto(const double* e, int eSize, const double* f, int fSize, double* h)
+        {
+            int eIndex = 0;
+            int fIndex = 0;
+            int hIndex = 0;
+            double Q = 0.0;
+            double hh = 0.0;
+            bool first = true;
+            while (eIndex < eSize || fIndex < fSize)
+            {
+                double next;
+                if (fIndex == fSize || (eIndex < eSize && std::abs(e[eIndex]) < std::abs(f[fIndex])))
+                {
+                    next = e[eIndex++];
+                }
+                else
+                {
+                    next = f[fIndex++];
+                }
+
+                if (first)
+                {
+                    Q = next;
+                    first = false;
+                    continue;
+                }
+
+                TwoSum(Q, next, Q, hh);
+                if (hh != 0.0)
+                {
+                    h[hIndex++] = hh;
+                }
+            }
+            if (Q != 0.0)
+            {
+                h[hIndex++] = Q;
+            }
+            return hIndex;
+        }
+
+        int ScaleInto(const double* e, int eSize, double b, double* h)
+        {
+            int hIndex = 0;
+            if (eSize == 0)
+            {
+                return 0;
+            }
+
+            double Q;
+            double hh;
+            TwoProduct(e[0], b, Q, hh);
+            if (hh != 0.0)
+            {
+                h[hIndex++] = hh;
+            }
+            for (int i = 1; i < eSize; i++)
+            {
+                double product1;
+                double product0;
+                double sum;
+                TwoProduct(e[i], b, product1, product0);
+                TwoSum(Q, product0, sum, hh);
+                if (hh != 0.0)
+                {
+                    h[hIndex++] = hh;
+                }
+                FastTwoSum(product1, sum, Q, hh);
+                if (hh != 0.0)
+                {
+                    h[hIndex++] = hh;
+                }
+            }
+            if (Q != 0.0)
+            {
+                h[hIndex++] = Q;
+            }
+            return hIndex;
+        }
+
+        template <int N, int M>
+        Expansion<N + M> Sum(const Expansion<N>& e, const Expansion<M>& f)
+        {
+            Expansion<N + M> h;
+            h.size = SumInto(e.terms, e.size, f.terms, f.size, h.terms);
+            return h;
+        }
+
+        template <int N>
+        Expansion<N> Negate(Expansion<N> e)
+        {
+            for (int i = 0; i < e.size; i++)
+            {
+                e.terms[i] = -e.terms[i];
+            }
+            return e;
+        }
+
+        template <int N, int M>
+        Expansion<2 * N * M> Product(const Expansion<N>& e, const Expansion<M>& f)
+        {
+            Expansion<2 * N * M> partial[2];
+            int current = 0;
+            double scaled[2 * N] = {};
+            for (int i = 0; i < f.size; i++)
+            {
+                int scaledSize = ScaleInto(e.terms, e.size, f.terms[i], scaled);
+                partial[1 - current].size = SumInto(partial[current].terms, partial[current].size, scaled, scaledSize, partial[1 - current].terms);
+                current = 1 - current;
+            }
+            return partial[current];
+        }
+
+        Expansion<2> Difference(double a, double b)
+        {
+            double x = a - b;
+            double bVirtual = a - x;
+            double aVirtual = x + bVirtual;
+            double y = (a - aVirtual) + (bVirtual - b);
+
+            Expansion<2> e;
+            e.Push(y);
+            e.Push(x);
+            return e;
+        }
+
+        Expansion<2> Product(double a, double b)
+        {
+            double x;
+            double y;
+            TwoProduct(a, b, x, y);
+
+            Expansion<2> e;
+            e.Push(y);
+            e.Push(x);
+            return e;
+        }
+    }
+
+    double Orient2DExact(Point a, Point b, Point p)
+    {
+        Expansion<4> first = Sum(Product(b.x, p.y), Product(-b.x, a.y));
+        Expansion<4> second = Sum(Product(-a.x, p.y), Product(-b.y, p.x));
+        Expansion<4> third = Sum(Product(b.y, a.x), Product(a.y, p.x));
+        return Sum(Sum(first, second), third).Sign();
+    }
+
+    double InCircleExact(Point a, Point b, Point c, Point d)
+    {
+        Expansion<2> adx = Difference(a.x, d.x);
+        Expansion<2> ady = Difference(a.y, d.y);
+        Expansion<2> bdx = Difference(b.x, d.x);
+        Expansion<2> bdy = Difference(b.y, d.y);
+        Expansion<2> cdx = Difference(c.x, d.x);
+        Expansion<2> cdy = Difference(c.y, d.y);
+
+        Expansion<16> aLift = Sum(Product(adx, adx), Product(ady, ady));
+        Expansion<16> bLift = Sum(Product(bdx, bdx), Product(bdy, bdy));
+        Expansion<16> cLift = Sum(Product(cdx, cdx), Product(cdy, cdy));
+
+        Expansion<16> bc = Sum(Product(bdx, cdy), Negate(Product(cdx, bdy)));
+        Expansion<16> ca = Sum(Product(cdx, ady), Negate(Product(adx, cdy)));
+        Expansion<16> ab = Sum(Product(adx, bdy), Negate(Product(bdx, ady)));
+
+        return Sum(Sum(Product(aLift, bc), Product(bLift, ca)), Product(cLift, ab)).Sign();
+    }
+
+    double InDiametralCircleExact(Point a, Point b, Point p)
+    {
+        Expansion<2> apx = Difference(a.x, p.x);
+        Expansion<2> apy = Difference(a.y, p.y);
+        Expansion<2> bpx = Difference(b.x, p.x);
+        Expansion<2> bpy = Difference(b.y, p.y);
+        return -Sum(Product(apx, bpx), Product(apy, bpy)).Sign();
+    }
+
+    double Orient3DExact(const Point3D& a, const Point3D& b, const Point3D& c, const Point3D& d)
+    {
+        Expansion<2> adx = Difference(a.x, d.x);
+        Expansion<2> ady = Difference(a.y, d.y);
+        Expansion<2> adz = Difference(a.z, d.z);
+        Expansion<2> bdx = Difference(b.x, d.x);
+        Expansion<2> bdy = Difference(b.y, d.y);
+        Expansion<2> bdz = Difference(b.z, d.z);
+        Expansion<2> cdx = Difference(c.x, d.x);
+        Expansion<2> cdy = Difference(c.y, d.y);
+        Expansion<2> cdz = Difference(c.z, d.z);
+
+        Expansion<16> bc = Sum(Product(bdx, cdy), Negate(Product(cdx, bdy)));
+        Expansion<16> ca = Sum(Product(cdx, ady), Negate(Product(adx, cdy)));
+        Expansion<16> ab = Sum(Product(adx, bdy), Negate(Product(bdx, ady)));
+
+        // Negated: the determinant of a - d, b - d, c - d is positive below the plane
+        return -Sum(Sum(Product(bc, adz), Product(ca, bdz)), Product(ab, cdz)).Sign();
+    }
+}
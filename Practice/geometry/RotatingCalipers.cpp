@@ -0,0 +1,317 @@
+#include <algorithm>
+
+#include "Parallel.h"
+#include "RotatingCalipers.h"
+
+namespace geometry
+{
+    namespace
+    {
+        // The calipers on one edge, from hull[edge] to the next vertex. Lengths along the edge
+        // and heights above it are scaled by the edge length.
+        struct Caliper
+        {
+            int edge;
+            // Farthest from the line of the edge. Two when the edge across is parallel to it.
+            int farFirst;
+            int farLast;
+            // First and last along the edge
+            int left;
+            int right;
+            double length2;
+            double height;
+            double leftAlong;
+            double rightAlong;
+        };
+
+        int GetNext(int k, int n)
+        {
+            return k + 1 == n ? 0 : k + 1;
+        }
+
+        // Calls visit(caliper) for every edge in order, n >= 3. The pointers only go forward,
+        // each makes one round. They count on past n so that they can be kept in order
+        // i < right, i + 1 < far <= left <= i + n when rounding says otherwise.
+        template <typename Visit>
+        void Rotate(const Point* hull, int n, Visit visit)
+        {
+            auto at = [=](int k) { return hull[k < n ? k : k - n]; };
+            int far = 2;
+            int left = 2;
+            int right = 1;
+            for (int i = 0; i < n; i++)
+            {
+                Point A = hull[i];
+                Point edge = at(i + 1) - A;
+                auto getHeight = [&](int k) { return edge ^ (at(k) - A); };
+                auto getAlong = [&](int k) { return edge * (at(k) - A); };
+
+                // Each walk keeps the value at the pointer, the next one is read once per step
+                far = std::max(far, i + 2);
+                double height = getHeight(far);
+                double nextHeight = far + 1 < i + n ? getHeight(far + 1) : -HUGE_VAL;
+                while (nextHeight > height)
+                {
+                    far++;
+                    height = nextHeight;
+                    nextHeight = far + 1 < i + n ? getHeight(far + 1) : -HUGE_VAL;
+                }
+                right = std::max(right, i + 1);
+                double rightAlong = getAlong(right);
+                for (double next; right + 1 < i + n && (next = getAlong(right + 1)) > rightAlong; right++)
+                {
+                    rightAlong = next;
+                }
+                left = std::max(left, far);
+                double leftAlong = getAlong(left);
+                for (double next; left < i + n && (next = getAlong(left + 1)) < leftAlong; left++)
+                {
+                    leftAlong = next;
+                }
+
+                int farLast = nextHeight == height ? far + 1 : far;
+                visit(Caliper{ i, far % n, farLast % n, left % n, right % n, edge * edge, height, leftAlong, rightAlong });
+            }
+        }
+
+        // Vertex i is antipodal to everything from the far side of edge i - 1 to the far side
+        // of edge i. Calls visit(first, second) once per pair with first < second.
+        template <typename Visit>
+        class AntipodalWalk
+        {
+        public:
+            AntipodalWalk(int n, Visit& visit)
+                : n(n), visit(visit)
+            {
+            }
+
+            void Add(const Caliper& caliper)
+            {
+                if (caliper.edge == 0)
+                {
+                    firstLast = caliper.farLast;
+                }
+                else
+                {
+                    Emit(caliper.edge, previousFirst, caliper.farLast);
+                }
+                previousFirst = caliper.farFirst;
+            }
+
+            void Finish()
+            {
+                Emit(0, previousFirst, firstLast);
+            }
+
+        private:
+            void Emit(int vertex, int begin, int end)
+            {
+                for (int k = begin;; k = GetNext(k, n))
+                {
+                    if (vertex < k)
+                    {
+                        visit(vertex, k);
+                    }
+                    if (k == end)
+                    {
+                        break;
+                    }
+                }
+            }
+
+            int n;
+            Visit& visit;
+            int firstLast = 0;
+            int previousFirst = 0;
+        };
+
+        // The box on the edge of the caliper
+        OrientedBox GetBox(const Point* hull, int n, const Caliper& caliper)
+        {
+            Point A = hull[caliper.edge];
+            Point edge = hull[GetNext(caliper.edge, n)] - A;
+            double extent = caliper.rightAlong - caliper.leftAlong;
+
+            OrientedBox box;
+            box.corners[0] = A + edge * (caliper.leftAlong / caliper.length2);
+            box.corners[1] = A + edge * (caliper.rightAlong / caliper.length2);
+            box.corners[2] = box.corners[1] + ~edge * (caliper.height / caliper.length2);
+            box.corners[3] = box.corners[0] + ~edge * (caliper.height / caliper.length2);
+            box.area = extent / caliper.length2 * caliper.height;
+            box.perimeter = 2.0 * (extent + caliper.height) / std::sqrt(caliper.length2);
+            return box;
+        }
+
+        // Fewer than three vertices: a point or a segment, the boxes are flat
+        HullMeasures GetFlatMeasures(const Point* hull, int n)
+        {
+            HullMeasures measures = {};
+            measures.diameterFirst = n > 0 ? 0 : -1;
+            measures.diameterSecond = n - 1;
+            measures.widthEdge = n > 0 ? 0 : -1;
+            measures.widthVertex = n > 0 ? 0 : -1;
+            if (n == 0)
+            {
+                return measures;
+            }
+
+            Point A = hull[0];
+            Point B = hull[n - 1];
+            measures.diameter = vecta::len(B - A);
+            OrientedBox box = { { A, B, B, A }, 0.0, 2.0 * measures.diameter };
+            measures.minAreaBox = box;
+            measures.minPerimeterBox = box;
+            return measures;
+        }
+
+        HullMeasures GetHullMeasures(const Point* hull, int n)
+        {
+            if (n < 3)
+            {
+                return GetFlatMeasures(hull, n);
+            }
+
+            HullMeasures measures;
+            double diameter2 = -1.0;
+            auto visitPair = [&](int first, int second)
+            {
+                Point d = hull[second] - hull[first];
+                double distance2 = d * d;
+                if (distance2 > diameter2)
+                {
+                    diameter2 = distance2;
+                    measures.diameterFirst = first;
+                    measures.diameterSecond = second;
+                }
+            };
+            AntipodalWalk<decltype(visitPair)> walk(n, visitPair);
+
+            // Squares compared, divided first since the product of two would overflow long
+            // before the coordinates do
+            double width2 = -1.0;
+            double area = -1.0;
+            double perimeter2 = -1.0;
+            Caliper minWidth = {};
+            Caliper minArea = {};
+            Caliper minPerimeter = {};
+            Rotate(hull, n, [&](const Caliper& caliper)
+            {
+                walk.Add(caliper);
+
+                double extent = caliper.rightAlong - caliper.leftAlong;
+                double inverse = 1.0 / caliper.length2;
+                double edgeWidth2 = caliper.height * inverse * caliper.height;
+                double edgeArea = extent * inverse * caliper.height;
+                double edgePerimeter2 = (extent + caliper.height) * inverse * (extent + caliper.height);
+                if (width2 < 0.0 || edgeWidth2 < width2)
+                {
+                    width2 = edgeWidth2;
+                    minWidth = caliper;
+                }
+                if (area < 0.0 || edgeArea < area)
+                {
+                    area = edgeArea;
+                    minArea = caliper;
+                }
+                if (perimeter2 < 0.0 || edgePerimeter2 < perimeter2)
+                {
+                    perimeter2 = edgePerimeter2;
+                    minPerimeter = caliper;
+                }
+            });
+            walk.Finish();
+
+            measures.diameter = std::sqrt(diameter2);
+            measures.width = minWidth.height / std::sqrt(minWidth.length2);
+            measures.widthEdge = minWidth.edge;
+            measures.widthVertex = minWidth.farFirst;
+            measures.minAreaBox = GetBox(hull, n, minArea);
+            measures.minPerimeterBox = GetBox(hull, n, minPerimeter);
+            return measures;
+        }
+    }
+
+    HullMeasures GetHullMeasures(const std::vector<Point>& hull)
+    {
+        return GetHullMeasures(hull.data(), int(hull.size()));
+    }
+
+    void GetHullMeasures(const std::vector<Point>& hulls, const std::vector<int>& offsets, std::vector<HullMeasures>& measures, int threadCount)
+    {
+        GEOMETRY_STAGE(stage, "Calipers/batch");
+        int count = offsets.empty() ? 0 : int(offsets.size()) - 1;
+        measures.resize(count);
+        ParallelFor(count, GetThreadCount(threadCount), [&](int, int begin, int end)
+        {
+            for (int i = begin; i < end; i++)
+            {
+                measures[i] = GetHullMeasures(hulls.data() + offsets[i], offsets[i + 1] - offsets[i]);
+            }
+        });
+    }
+
+    double GetDiameter(const std::vector<Point>& hull, int& first, int& second)
+    {
+        int n = int(hull.size());
+        if (n < 3)
+        {
+            HullMeasures measures = GetFlatMeasures(hull.data(), n);
+            first = measures.diameterFirst;
+            second = measures.diameterSecond;
+            return measures.diameter;
+        }
+
+        double diameter2 = -1.0;
+        auto visitPair = [&](int a, int b)
+        {
+            Point d = hull[b] - hull[a];
+            if (d * d > diameter2)
+            {
+                diameter2 = d * d;
+                first = a;
+                second = b;
+            }
+        };
+        AntipodalWalk<decltype(visitPair)> walk(n, visitPair);
+        Rotate(hull.data(), n, [&](const Caliper& caliper) { walk.Add(caliper); });
+        walk.Finish();
+        return std::sqrt(diameter2);
+    }
+
+    double GetWidth(const std::vector<Point>& hull, int& edge, int& vertex)
+    {
+        HullMeasures measures = GetHullMeasures(hull);
+        edge = measures.widthEdge;
+        vertex = measures.widthVertex;
+        return measures.width;
+    }
+
+    OrientedBox GetMinAreaBox(const std::vector<Point>& hull)
+    {
+        return GetHullMeasures(hull).minAreaBox;
+    }
+
+    OrientedBox GetMinPerimeterBox(const std::vector<Point>& hull)
+    {
+        return GetHullMeasures(hull).minPerimeterBox;
+    }
+
+    void GetAntipodalPairs(const std::vector<Point>& hull, std::vector<std::pair<int, int>>& pairs)
+    {
+        pairs.clear();
+        int n = int(hull.size());
+        if (n < 3)
+        {
+            if (n == 2)
+            {
+                pairs.push_back({ 0, 1 });
+            }
+            return;
+        }
+
+        auto visitPair = [&](int first, int second) { pairs.push_back({ first, second }); };
+        AntipodalWalk<decltype(visitPair)> walk(n, visitPair);
+        Rotate(hull.data(), n, [&](const Caliper& caliper) { walk.Add(caliper); });
+        walk.Finish();
+    }
+}
@@ -0,0 +1,58 @@
+#ifndef ROTATING_CALIPERS_H
+#define ROTATING_CALIPERS_H
+
+#include <utility>
+#include <vector>
+
+#include "Geometry.h"
+
+namespace geometry
+{
+    // Measures of a hull ring, strictly convex and counter-clockwise like the ones
+    // MonotoneChain_Andrews() returns. Any vertex may come first. Everything is O(h) with
+    // pointers that only go forward while the edges are walked once, nothing is allocated.
+
+    // A rectangle with one side on a hull edge, corners counter-clockwise from that side
+    struct OrientedBox
+    {
+        Point corners[4];
+        double area;
+        double perimeter;
+    };
+
+    struct HullMeasures
+    {
+        // The farthest pair of vertices
+        double diameter;
+        int diameterFirst;
+        int diameterSecond;
+
+        // The narrowest strip, between the line of an edge and the vertex farthest from it
+        double width;
+        int widthEdge;
+        int widthVertex;
+
+        OrientedBox minAreaBox;
+        OrientedBox minPerimeterBox;
+    };
+
+    HullMeasures GetHullMeasures(const std::vector<Point>& hull);
+
+    // One hull per cluster: the ring of cluster i is hulls[offsets[i]] .. hulls[offsets[i + 1] - 1].
+    // Clusters are split over threadCount threads, 0 means std::thread::hardware_concurrency().
+    void GetHullMeasures(const std::vector<Point>& hulls, const std::vector<int>& offsets, std::vector<HullMeasures>& measures, int threadCount = 0);
+
+    double GetDiameter(const std::vector<Point>& hull, int& first, int& second);
+
+    double GetWidth(const std::vector<Point>& hull, int& edge, int& vertex);
+
+    OrientedBox GetMinAreaBox(const std::vector<Point>& hull);
+
+    OrientedBox GetMinPerimeterBox(const std::vector<Point>& hull);
+
+    // Every pair of vertices on two parallel lines that hold the hull between them, once each
+    // with first < second. At most 3h / 2 of them. The vector is reused, it only grows.
+    void GetAntipodalPairs(const std::vector<Point>& hull, std::vector<std::pair<int, int>>& pairs);
+}
+
+#endif
@@ -0,0 +1,16 @@
+#include "Instrumentation.h"
+#include "Parallel.h"
+#include "Rotation.h"
+
+namespace geometry
+{
+    void RotatePoints(vecta::vec3d_array<>& points, const vecta::quatrn& q, int threadCount)
+    {
+        GEOMETRY_STAGE(stage, "Rotation/batch");
+        vecta::rotation3d rotation(q);
+        ParallelFor(int(points.size()), GetThreadCount(threadCount), [&](int, int begin, int end)
+        {
+            rotation(points.x.data() + begin, points.y.data() + begin, points.z.data() + begin, end - begin);
+        });
+    }
+}
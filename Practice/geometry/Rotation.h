@@ -0,0 +1,14 @@
+#ifndef ROTATION_H
+#define ROTATION_H
+
+#include "vecta.h"
+
+namespace geometry
+{
+    // Turns every point by the unit quaternion q in place, like points[i] & q with the matrix
+    // worked out once (vecta::rotation3d). The points are split over threadCount threads,
+    // 0 means std::thread::hardware_concurrency().
+    void RotatePoints(vecta::vec3d_array<>& points, const vecta::quatrn& q, int threadCount = 0);
+}
+
+#endif
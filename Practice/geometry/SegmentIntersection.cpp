@@ -0,0 +1,589 @@
+#include <algorithm>
+#include <cmath>
+#include <memory_resource>
+#include <queue>
+#include <set>
+
+#include "SegmentIntersection.h"
+
+namespace geometry
+{
+    namespace
+    {
+        bool IsLess(Point a, Point b)
+        {
+            return a.x < b.x || (a.x == b.x && a.y < b.y);
+        }
+
+        // P is on the line through AB, is it also between A and B
+        bool IsOnSegment(Point A, Point B, Point P)
+        {
+            return std::min(A.x, B.x) <= P.x && P.x <= std::max(A.x, B.x) && std::min(A.y, B.y) <= P.y && P.y <= std::max(A.y, B.y);
+        }
+
+        int GetSign(double value)
+        {
+            return (value > 0.0) - (value < 0.0);
+        }
+
+        // Side of P against the line through AB. Segments meet at their ends all the time and
+        // there the orientation is zero but too close to call for the filter.
+        int GetLineSide(Point A, Point B, Point P)
+        {
+            return P == A || P == B ? 0 : GetSign(Orient2D(A, B, P));
+        }
+
+        // Range of x the segments AB and CD (left to right) can cross in: the crossing rounded
+        // from A + t AB give or take its error bound, within the later start and the earlier
+        // end of the two
+        void GetCrossingRange(Point A, Point B, Point C, Point D, double& earliest, double& latest)
+        {
+            const double errorBound = 3.5527136788005009e-15; // 32e, e = 2^-53
+            Point AB = B - A;
+            Point CD = D - C;
+            double numerator = (C - A) ^ CD;
+            double denominator = AB ^ CD;
+            double numeratorError = errorBound * (std::abs((C.x - A.x) * CD.y) + std::abs((C.y - A.y) * CD.x));
+            double denominatorError = errorBound * (std::abs(AB.x * CD.y) + std::abs(AB.y * CD.x));
+            earliest = std::max(A.x, C.x);
+            latest = std::min(B.x, D.x);
+            if (std::abs(denominator) <= 2.0 * denominatorError)
+            {
+                return;
+            }
+            double t = numerator / denominator;
+            double tError = 2.0 * (numeratorError + std::abs(t) * denominatorError) / std::abs(denominator);
+            double x = A.x + t * AB.x;
+            double xError = std::abs(AB.x) * tError + errorBound * (std::abs(A.x) + std::abs(t * AB.x));
+            earliest = std::max(earliest, x - xError);
+            latest = std::min(latest, x + xError);
+        }
+
+        // Stands for the sweep point in status lookups
+        const int Probe = -1;
+
+        // Segments leaving a point are sorted for hinted inserts up to this many, more are
+        // inserted as they come
+        const int SortedLeavingSize = 16;
+
+        enum class EventType
+        {
+            // Swaps at a point go before the segments starting and ending there, so those are
+            // compared against the order after the point
+            Swap,
+            Start,
+            End,
+        };
+
+        struct Event
+        {
+            Point P;
+            EventType type;
+            int first;
+            int second;
+
+            bool operator>(const Event& other) const
+            {
+                if (P.x != other.P.x)
+                {
+                    return P.x > other.P.x;
+                }
+                if (P.y != other.P.y)
+                {
+                    return P.y > other.P.y;
+                }
+                return type > other.type;
+            }
+        };
+
+        // A swap is taken from the heap by the lowest x its crossing can have, so every one
+        // that can be before the next point is looked at there
+        struct PendingSwap
+        {
+            double earliest;
+            double latest;
+            Event event;
+
+            bool operator>(const PendingSwap& other) const
+            {
+                return earliest != other.earliest ? earliest > other.earliest : event > other.event;
+            }
+        };
+
+        // Segments are kept left to right (x then y). The status holds slots in the order the
+        // segments cross the sweep line; a swap exchanges the segments of two slots, so the
+        // set itself is only compared against when a segment is inserted.
+        class Sweep
+        {
+        public:
+            Sweep(const std::vector<Segment>& segments, const std::vector<int>& ids, bool isRing, bool stopAtFirst)
+                : segments(segments), ids(ids), isRing(isRing), stopAtFirst(stopAtFirst),
+                  ordered(segments), slotSegment(segments.size()), position(segments.size()), isActive(segments.size(), false), status(SlotCompare{ this }, &nodes)
+            {
+                for (Segment& segment : ordered)
+                {
+                    if (IsLess(segment.B, segment.A))
+                    {
+                        std::swap(segment.A, segment.B);
+                    }
+                }
+            }
+
+            std::vector<SegmentIntersection> Run()
+            {
+                // Endpoints are sorted once, only the swaps found on the way go through a heap
+                std::vector<Event> endpoints;
+                endpoints.reserve(2 * segments.size());
+                for (int i = 0; i < segments.size(); i++)
+                {
+                    endpoints.push_back({ GetLeft(i), EventType::Start, i, -1 });
+                    endpoints.push_back({ GetRight(i), EventType::End, i, -1 });
+                }
+                std::sort(endpoints.begin(), endpoints.end(), [](const Event& a, const Event& b) { return b > a; });
+
+                int next = 0;
+                while (next < endpoints.size() || !swaps.empty())
+                {
+                    if (stopAtFirst && !result.empty())
+                    {
+                        break;
+                    }
+
+                    while (!swaps.empty() && IsStale(swaps.top().event))
+                    {
+                        swaps.pop();
+                    }
+
+                    // A rounded crossing can be on the wrong side of the next point. A swap goes
+                    // first when the point decides exactly that they have crossed already, or
+                    // when the order does not matter there and the crossing is surely before
+                    // it. The others wait for the point, one further down can still go first.
+                    bool isSwap = !swaps.empty();
+                    if (isSwap && next < endpoints.size())
+                    {
+                        const PendingSwap& top = swaps.top();
+                        isSwap = top.earliest <= endpoints[next].P.x;
+                        if (isSwap)
+                        {
+                            int order = GetOrderAt(top.event, endpoints[next].P);
+                            if (order > 0 || (order == 0 && top.latest >= endpoints[next].P.x))
+                            {
+                                waiting.push_back(top);
+                                swaps.pop();
+                                continue;
+                            }
+                        }
+                    }
+                    if (isSwap)
+                    {
+                        Event event = swaps.top().event;
+                        swaps.pop();
+                        Point at = event.P;
+                        if (next < endpoints.size() && IsLess(endpoints[next].P, at))
+                        {
+                            at = endpoints[next].P;
+                        }
+                        sweepPoint = IsLess(sweepPoint, at) ? at : sweepPoint;
+                        Swap(event.first, event.second);
+                        continue;
+                    }
+
+                    // Every segment starting or ending at this point is handled at once
+                    sweepPoint = endpoints[next].P;
+                    starting.clear();
+                    for (; next < endpoints.size() && endpoints[next].P == sweepPoint; next++)
+                    {
+                        if (endpoints[next].type == EventType::Start)
+                        {
+                            starting.push_back(endpoints[next].first);
+                        }
+                    }
+                    HandlePoint();
+                    for (const PendingSwap& swap : waiting)
+                    {
+                        swaps.push(swap);
+                    }
+                    waiting.clear();
+                }
+
+                // A pair can meet again after something between them is gone, the first report stays
+                auto byPair = [](const SegmentIntersection& a, const SegmentIntersection& b) { return a.first < b.first || (a.first == b.first && a.second < b.second); };
+                std::stable_sort(result.begin(), result.end(), byPair);
+                result.erase(std::unique(result.begin(), result.end(), [](const SegmentIntersection& a, const SegmentIntersection& b) { return a.first == b.first && a.second == b.second; }), result.end());
+                return result;
+            }
+
+        private:
+            struct SlotCompare
+            {
+                const Sweep* sweep;
+
+                bool operator()(int a, int b) const
+                {
+                    return sweep->IsBelow(a, b);
+                }
+            };
+
+            typedef std::pmr::set<int, SlotCompare>::iterator Position;
+
+            Point GetLeft(int i) const
+            {
+                return ordered[i].A;
+            }
+
+            Point GetRight(int i) const
+            {
+                return ordered[i].B;
+            }
+
+            // Position of the segment being inserted (starting at the sweep point) against t,
+            // just after the sweep point. Ties between overlapping segments go by index.
+            int GetSide(int s, int t) const
+            {
+                Point left = GetLeft(t);
+                Point right = GetRight(t);
+                int side = GetLineSide(left, right, sweepPoint);
+                if (side == 0)
+                {
+                    side = GetLineSide(left, right, GetRight(s));
+                }
+                return side != 0 ? side : (s < t ? -1 : 1);
+            }
+
+            bool IsBelow(int slotA, int slotB) const
+            {
+                // The probe stands for the sweep point itself, equal to every segment through it
+                if (slotA == Probe || slotB == Probe)
+                {
+                    int t = slotSegment[slotA == Probe ? slotB : slotA];
+                    int side = GetLineSide(GetLeft(t), GetRight(t), sweepPoint);
+                    return slotA == Probe ? side < 0 : side > 0;
+                }
+
+                int a = slotSegment[slotA];
+                int b = slotSegment[slotB];
+                if (a == inserting)
+                {
+                    return GetSide(a, b) < 0;
+                }
+                if (b == inserting)
+                {
+                    return GetSide(b, a) > 0;
+                }
+                return slotA < slotB;
+            }
+
+            // Where it goes in the status is known to be just below hint, which is checked
+            // against its neighbours before the set looks any further
+            void Insert(int s, int slot, Position hint)
+            {
+                inserting = s;
+                isActive[s] = true;
+                slotSegment[slot] = s;
+                position[s] = status.insert(hint, slot);
+                inserting = -1;
+            }
+
+            // The segments through the sweep point all meet there. They are taken out and the
+            // ones that go on are put back in their order after the point, together with the
+            // ones starting there, so crossings at input points need no swap events.
+            void HandlePoint()
+            {
+                std::pair<Position, Position> range = status.equal_range(Probe);
+                through.clear();
+                throughSlots.clear();
+                for (Position it = range.first; it != range.second; it++)
+                {
+                    through.push_back(slotSegment[*it]);
+                    throughSlots.push_back(*it);
+                }
+
+                for (int i = 0; i < through.size(); i++)
+                {
+                    for (int j = i + 1; j < through.size(); j++)
+                    {
+                        Report(through[i], through[j], sweepPoint);
+                    }
+                    for (int s : starting)
+                    {
+                        Report(through[i], s, sweepPoint);
+                    }
+                }
+                for (int i = 0; i < starting.size(); i++)
+                {
+                    for (int j = i + 1; j < starting.size(); j++)
+                    {
+                        Report(starting[i], starting[j], sweepPoint);
+                    }
+                }
+
+                bool hasBelow = range.first != status.begin();
+                Position below = hasBelow ? std::prev(range.first) : status.end();
+                Position above = range.second;
+                status.erase(range.first, range.second);
+                for (int s : through)
+                {
+                    isActive[s] = false;
+                }
+
+                // The ones going on all leave the sweep point and go between below and above,
+                // in the order they have after it
+                leaving.clear();
+                for (int i = 0; i < through.size(); i++)
+                {
+                    if (GetRight(through[i]) != sweepPoint)
+                    {
+                        leaving.push_back({ through[i], throughSlots[i] });
+                    }
+                }
+                for (int s : starting)
+                {
+                    if (GetRight(s) != sweepPoint)
+                    {
+                        leaving.push_back({ s, s });
+                    }
+                }
+                // Crossings rounded onto the point can leave the sides inconsistent, so the sort
+                // stays within bounds whatever they say, a wrong hint only costs the full search
+                for (int i = 1; i < leaving.size() && leaving.size() <= SortedLeavingSize; i++)
+                {
+                    for (int j = i; j > 0 && GetSide(leaving[j].first, leaving[j - 1].first) < 0; j--)
+                    {
+                        std::swap(leaving[j], leaving[j - 1]);
+                    }
+                }
+                for (const std::pair<int, int>& s : leaving)
+                {
+                    Insert(s.first, s.second, above);
+                }
+
+                Position first = hasBelow ? std::next(below) : status.begin();
+                if (first == above)
+                {
+                    if (hasBelow && above != status.end())
+                    {
+                        Check(slotSegment[*below], slotSegment[*above]);
+                    }
+                    return;
+                }
+
+                if (hasBelow)
+                {
+                    Check(slotSegment[*below], slotSegment[*first]);
+                }
+                if (above != status.end())
+                {
+                    Check(slotSegment[*std::prev(above)], slotSegment[*above]);
+                }
+            }
+
+            // One of them is gone or something got between them since the swap was queued
+            bool IsStale(const Event& swap) const
+            {
+                return !isActive[swap.first] || !isActive[swap.second] || std::next(position[swap.first]) != position[swap.second];
+            }
+
+            void Swap(int lower, int upper)
+            {
+                std::swap(slotSegment[*position[lower]], slotSegment[*position[upper]]);
+                std::swap(position[lower], position[upper]);
+
+                Position newLower = position[upper];
+                Position newUpper = position[lower];
+                if (newLower != status.begin())
+                {
+                    Check(slotSegment[*std::prev(newLower)], upper);
+                }
+                if (std::next(newUpper) != status.end())
+                {
+                    Check(lower, slotSegment[*std::next(newUpper)]);
+                }
+            }
+
+            // Where P is between the two segments of a swap it tells how they are ordered there:
+            // -1 when they have crossed already, 1 when not yet, 0 when the order does not
+            // matter at P. The status has to agree with the probe at every point.
+            int GetOrderAt(const Event& swap, Point P) const
+            {
+                int lower = swap.first;
+                int upper = swap.second;
+                int lowerSide = GetLineSide(GetLeft(lower), GetRight(lower), P);
+                int upperSide = GetLineSide(GetLeft(upper), GetRight(upper), P);
+                if (lowerSide == upperSide)
+                {
+                    return 0;
+                }
+                return lowerSide <= 0 && upperSide >= 0 ? -1 : 1;
+            }
+
+            // Neighbouring edges of a ring share a vertex, that is not an intersection
+            bool IsIgnored(int a, int b) const
+            {
+                if (!isRing)
+                {
+                    return false;
+                }
+
+                int m = int(segments.size());
+                for (int i = 0; i < 2; i++)
+                {
+                    int first = i ? b : a;
+                    int second = i ? a : b;
+                    if ((first + 1) % m == second)
+                    {
+                        Point A = segments[first].A;
+                        Point B = segments[first].B;
+                        Point C = segments[second].B;
+                        bool foldsBack = Orient2D(A, B, C) == 0.0 && (C - B) * (B - A) < 0.0;
+                        if (!foldsBack)
+                        {
+                            return true;
+                        }
+                    }
+                }
+                return false;
+            }
+
+            // lower is directly below upper in the status
+            void Check(int lower, int upper)
+            {
+                Point A = GetLeft(lower);
+                Point B = GetRight(lower);
+                Point C = GetLeft(upper);
+                Point D = GetRight(upper);
+                int abc = GetLineSide(A, B, C);
+                int abd = GetLineSide(A, B, D);
+                int cda = GetLineSide(C, D, A);
+                int cdb = GetLineSide(C, D, B);
+
+                bool isProper = abc * abd < 0 && cda * cdb < 0;
+                if (!isProper)
+                {
+                    // Touching or overlapping: the first endpoint on the other segment
+                    bool found = false;
+                    Point first;
+                    auto consider = [&](Point P, int side, Point from, Point to)
+                    {
+                        if (side == 0 && IsOnSegment(from, to, P) && (!found || IsLess(P, first)))
+                        {
+                            first = P;
+                            found = true;
+                        }
+                    };
+                    consider(C, abc, A, B);
+                    consider(D, abd, A, B);
+                    consider(A, cda, C, D);
+                    consider(B, cdb, C, D);
+                    if (found)
+                    {
+                        Report(lower, upper, first);
+                    }
+                    return;
+                }
+
+                Point AB = B - A;
+                Point CD = D - C;
+                Point P = A + ((C - A) ^ CD) / (AB ^ CD) * AB;
+                double earliest;
+                double latest;
+                GetCrossingRange(A, B, C, D, earliest, latest);
+                // Nearly parallel ones round anywhere, or to nothing when the cross product
+                // rounds to zero; the crossing is between the later start and the earlier end
+                Point from = IsLess(A, C) ? C : A;
+                Point to = IsLess(B, D) ? B : D;
+                if (!IsLess(from, P))
+                {
+                    P = from;
+                }
+                else if (IsLess(to, P))
+                {
+                    P = to;
+                }
+                Report(lower, upper, P);
+
+                // They still have to cross when lower ends above upper. The rounded crossing
+                // is never allowed behind the sweep, nor past the end of either: a segment
+                // left in the wrong slot when it ends would not be found there.
+                if (cdb > 0)
+                {
+                    Point at = IsLess(P, sweepPoint) ? sweepPoint : P;
+                    for (Point end : { B, D })
+                    {
+                        if (IsLess(end, at))
+                        {
+                            at = end;
+                        }
+                    }
+                    swaps.push({ std::min(earliest, at.x), latest, { at, EventType::Swap, lower, upper } });
+                }
+            }
+
+            void Report(int a, int b, Point P)
+            {
+                if (IsIgnored(a, b))
+                {
+                    return;
+                }
+
+                result.push_back({ ids[std::min(a, b)], ids[std::max(a, b)], P });
+            }
+
+            const std::vector<Segment>& segments;
+            const std::vector<int>& ids;
+            bool isRing;
+            bool stopAtFirst;
+
+            // The segments from left to right
+            std::vector<Segment> ordered;
+
+            Point sweepPoint;
+            int inserting = -1;
+            std::vector<int> starting;
+            // Segments and their slots
+            std::vector<std::pair<int, int>> leaving;
+            std::vector<int> through;
+            std::vector<int> throughSlots;
+            std::vector<int> slotSegment;
+            std::vector<Position> position;
+            std::vector<char> isActive;
+            // The status nodes, one allocation for many, given back all at once at the end
+            std::pmr::monotonic_buffer_resource nodes;
+            std::pmr::set<int, SlotCompare> status;
+            std::priority_queue<PendingSwap, std::vector<PendingSwap>, std::greater<PendingSwap>> swaps;
+            std::vector<PendingSwap> waiting;
+            std::vector<SegmentIntersection> result;
+        };
+    }
+
+    std::vector<SegmentIntersection> GetIntersections(const std::vector<Segment>& segments, bool stopAtFirst)
+    {
+        std::vector<int> ids(segments.size());
+        for (int i = 0; i < segments.size(); i++)
+        {
+            ids[i] = i;
+        }
+        return Sweep(segments, ids, false, stopAtFirst).Run();
+    }
+
+    std::vector<SegmentIntersection> GetSelfIntersections(const std::vector<Point>& polygon, bool stopAtFirst)
+    {
+        std::vector<Segment> edges;
+        std::vector<int> ids;
+        for (int i = 0; i < polygon.size(); i++)
+        {
+            Point A = polygon[i];
+            Point B = polygon[(i + 1) % polygon.size()];
+            if (A != B)
+            {
+                edges.push_back({ A, B });
+                ids.push_back(i);
+            }
+        }
+        return Sweep(edges, ids, true, stopAtFirst).Run();
+    }
+
+    bool IsSimplePolygon(const std::vector<Point>& polygon)
+    {
+        return GetSelfIntersections(polygon, true).empty();
+    }
+}
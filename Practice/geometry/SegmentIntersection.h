@@ -0,0 +1,40 @@
+#ifndef SEGMENT_INTERSECTION_H
+#define SEGMENT_INTERSECTION_H
+
+#include <vector>
+
+#include "Geometry.h"
+
+namespace geometry
+{
+    struct Segment
+    {
+        Point A;
+        Point B;
+    };
+
+    // Segments first and second meet at P. Where they touch or overlap P is the first
+    // common point in x then y order.
+    struct SegmentIntersection
+    {
+        int first;
+        int second;
+        Point P;
+    };
+
+    // Bentley-Ottmann sweep, O((n + k) log n) for k intersecting pairs. Touching and
+    // overlapping segments count as intersecting and every pair is reported once. Decisions
+    // use exact predicates, crossing points are rounded.
+    // With stopAtFirst the sweep returns as soon as it finds one.
+    std::vector<SegmentIntersection> GetIntersections(const std::vector<Segment>& segments, bool stopAtFirst = false);
+
+    // Same over the edges of a polygon, edge i goes from polygon[i] to polygon[i + 1].
+    // Neighbouring edges only count when they fold back over each other, repeated
+    // vertices are skipped.
+    std::vector<SegmentIntersection> GetSelfIntersections(const std::vector<Point>& polygon, bool stopAtFirst = false);
+
+    // Validation ahead of Earcut() and GetPointLocation(), stops at the first intersection
+    bool IsSimplePolygon(const std::vector<Point>& polygon);
+}
+
+#endif
@@ -0,0 +1,334 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <queue>
+
+#include "Simplify.h"
+
+namespace geometry
+{
+    namespace
+    {
+        // The vertices still in the polygon, bucketed in a grid with cells about the length of
+        // an edge, to find the ones in a triangle. Only the cells with a vertex are stored,
+        // in a hash table, since the vertices lie along a curve and leave most cells empty.
+        class VertexGrid
+        {
+        public:
+            VertexGrid(const std::vector<Point>& points)
+                : points(points), isAlive(points.size(), true)
+            {
+                int n = int(points.size());
+                Point min = points[0];
+                double perimeter = 0.0;
+                for (int i = 0; i < n; i++)
+                {
+                    Point P = points[i];
+                    min.x = std::min(min.x, P.x);
+                    min.y = std::min(min.y, P.y);
+                    Point edge = points[(i + 1) % n] - P;
+                    perimeter += std::sqrt(edge * edge);
+                }
+                origin = min;
+                cellSize = perimeter > 0.0 ? 2.0 * perimeter / n : 1.0;
+
+                // Sorted by cell, every cell is a range of the order
+                std::vector<uint64_t> keys(n);
+                for (int i = 0; i < n; i++)
+                {
+                    keys[i] = GetKey(GetIndex(points[i].x, origin.x), GetIndex(points[i].y, origin.y));
+                }
+                order.resize(n);
+                for (int i = 0; i < n; i++)
+                {
+                    order[i] = i;
+                }
+                std::sort(order.begin(), order.end(), [&](int i, int j) { return keys[i] < keys[j]; });
+
+                size_t capacity = 1;
+                while (capacity < 2 * size_t(n))
+                {
+                    capacity *= 2;
+                }
+                mask = capacity - 1;
+                cells.assign(capacity, { Empty, 0, 0 });
+                for (int begin = 0; begin < n;)
+                {
+                    uint64_t key = keys[order[begin]];
+                    int end = begin;
+                    while (end < n && keys[order[end]] == key)
+                    {
+                        end++;
+                    }
+                    size_t slot = Hash(key) & mask;
+                    while (cells[slot].key != Empty)
+                    {
+                        slot = (slot + 1) & mask;
+                    }
+                    cells[slot] = { key, begin, end };
+                    begin = end;
+                }
+            }
+
+            void Remove(int i)
+            {
+                isAlive[i] = false;
+            }
+
+            // Is any vertex other than a, b and c in the closed triangle, or on its points
+            bool HasVertexInside(int a, int b, int c) const
+            {
+                Point A = points[a];
+                Point B = points[b];
+                Point C = points[c];
+                Point min(std::min({ A.x, B.x, C.x }), std::min({ A.y, B.y, C.y }));
+                Point max(std::max({ A.x, B.x, C.x }), std::max({ A.y, B.y, C.y }));
+                double orientation = Orient2D(A, B, C);
+
+                // Only the cells the triangle crosses, row by row: a thin triangle along a long
+                // diagonal edge has a large box but few cells
+                int64_t y0 = GetIndex(min.y, origin.y);
+                int64_t y1 = GetIndex(max.y, origin.y);
+                for (int64_t y = y0; y <= y1; y++)
+                {
+                    double bottom = std::max(min.y, origin.y + y * cellSize);
+                    double top = std::min(max.y, origin.y + (y + 1) * cellSize);
+                    double left = HUGE_VAL;
+                    double right = -HUGE_VAL;
+                    for (int e = 0; e < 3; e++)
+                    {
+                        Point P = e == 0 ? A : e == 1 ? B : C;
+                        Point Q = e == 0 ? B : e == 1 ? C : A;
+                        GetSlabExtent(P, Q, bottom, top, left, right);
+                    }
+                    if (left > right)
+                    {
+                        // Rounding at a row boundary, fall back to the box
+                        left = min.x;
+                        right = max.x;
+                    }
+
+                    int64_t x0 = GetIndex(std::max(left, min.x), origin.x);
+                    int64_t x1 = GetIndex(std::min(right, max.x), origin.x);
+                    for (int64_t x = x0; x <= x1; x++)
+                    {
+                        const Cell* cell = Find(GetKey(x, y));
+                        if (cell == nullptr)
+                        {
+                            continue;
+                        }
+                        for (int k = cell->begin; k < cell->end; k++)
+                        {
+                            int i = order[k];
+                            if (!isAlive[i] || i == a || i == b || i == c)
+                            {
+                                continue;
+                            }
+                            Point P = points[i];
+                            if (P.x < min.x || P.x > max.x || P.y < min.y || P.y > max.y || P == A || P == B || P == C)
+                            {
+                                continue;
+                            }
+                            if (IsInside(A, B, C, orientation, P))
+                            {
+                                return true;
+                            }
+                        }
+                    }
+                }
+                return false;
+            }
+
+        private:
+            // Widens left and right to the part of PQ between bottom and top, with a cell of slack
+            void GetSlabExtent(Point P, Point Q, double bottom, double top, double& left, double& right) const
+            {
+                if (P.y > Q.y)
+                {
+                    std::swap(P, Q);
+                }
+                if (Q.y < bottom || P.y > top)
+                {
+                    return;
+                }
+                double x0 = P.x;
+                double x1 = Q.x;
+                if (Q.y > P.y)
+                {
+                    double slope = (Q.x - P.x) / (Q.y - P.y);
+                    x0 = P.x + (std::max(bottom, P.y) - P.y) * slope;
+                    x1 = P.x + (std::min(top, Q.y) - P.y) * slope;
+                }
+                left = std::min(left, std::min(x0, x1) - cellSize);
+                right = std::max(right, std::max(x0, x1) + cellSize);
+            }
+
+            static bool IsInside(Point A, Point B, Point C, double orientation, Point P)
+            {
+                double abp = Orient2D(A, B, P);
+                double bcp = Orient2D(B, C, P);
+                double cap = Orient2D(C, A, P);
+                if (orientation < 0.0)
+                {
+                    abp = -abp;
+                    bcp = -bcp;
+                    cap = -cap;
+                }
+                // A flat triangle is the segment through its points, P is already in their box
+                return abp >= 0.0 && bcp >= 0.0 && cap >= 0.0;
+            }
+
+            struct Cell
+            {
+                uint64_t key;
+                int begin;
+                int end;
+            };
+
+            static const uint64_t Empty = ~uint64_t(0);
+
+            static uint64_t Hash(uint64_t x)
+            {
+                x ^= x >> 33;
+                x *= 0xff51afd7ed558ccdull;
+                x ^= x >> 33;
+                return x;
+            }
+
+            // Cells from the corner of the box, at most n / 4 of them along a side
+            int64_t GetIndex(double value, double start) const
+            {
+                return int64_t((value - start) / cellSize);
+            }
+
+            static uint64_t GetKey(int64_t x, int64_t y)
+            {
+                return uint64_t(x) << 32 | uint32_t(y);
+            }
+
+            const Cell* Find(uint64_t key) const
+            {
+                for (size_t slot = Hash(key) & mask; cells[slot].key != Empty; slot = (slot + 1) & mask)
+                {
+                    if (cells[slot].key == key)
+                    {
+                        return &cells[slot];
+                    }
+                }
+                return nullptr;
+            }
+
+            const std::vector<Point>& points;
+            std::vector<char> isAlive;
+            Point origin;
+            double cellSize;
+            std::vector<int> order;
+            std::vector<Cell> cells;
+            size_t mask;
+        };
+
+        // Distance of B from the line through A and C, or from A when they are the same
+        double GetHeight(Point A, Point B, Point C)
+        {
+            Point AC = C - A;
+            double length = std::sqrt(AC * AC);
+            if (length == 0.0)
+            {
+                Point AB = B - A;
+                return std::sqrt(AB * AB);
+            }
+            return std::abs(Orient2D(A, C, B)) / length;
+        }
+
+        struct Candidate
+        {
+            double height;
+            int vertex;
+            // Stale when the vertex has been updated since
+            int version;
+
+            bool operator>(const Candidate& other) const
+            {
+                return height > other.height || (height == other.height && vertex > other.vertex);
+            }
+        };
+    }
+
+    std::vector<Point> Simplify_Visvalingam(const std::vector<Point>& polygon, double tolerance)
+    {
+        int n = int(polygon.size());
+        if (n <= 3)
+        {
+            return polygon;
+        }
+
+        GEOMETRY_STAGE(stage, "Simplify/grid");
+        VertexGrid grid(polygon);
+        std::vector<int> previous(n);
+        std::vector<int> next(n);
+        std::vector<int> version(n, 0);
+        for (int i = 0; i < n; i++)
+        {
+            previous[i] = i ? i - 1 : n - 1;
+            next[i] = (i + 1) % n;
+        }
+
+        GEOMETRY_NEXT_STAGE(stage, "Simplify/heap");
+        std::vector<Candidate> candidates;
+        candidates.reserve(n);
+        for (int i = 0; i < n; i++)
+        {
+            candidates.push_back({ GetHeight(polygon[previous[i]], polygon[i], polygon[next[i]]), i, 0 });
+        }
+        std::priority_queue<Candidate, std::vector<Candidate>, std::greater<Candidate>> heap(std::greater<Candidate>(), std::move(candidates));
+
+        GEOMETRY_NEXT_STAGE(stage, "Simplify/remove");
+        int remaining = n;
+        std::vector<char> isRemoved(n, false);
+        while (remaining > 3 && !heap.empty() && heap.top().height <= tolerance)
+        {
+            Candidate candidate = heap.top();
+            heap.pop();
+            int b = candidate.vertex;
+            if (isRemoved[b] || candidate.version != version[b])
+            {
+                continue;
+            }
+
+            // Waits for one of its neighbours to change, that pushes it again
+            int a = previous[b];
+            int c = next[b];
+            if (grid.HasVertexInside(a, b, c))
+            {
+                continue;
+            }
+            // The last triangle must keep its area
+            if (remaining == 4 && Orient2D(polygon[a], polygon[c], polygon[next[c]]) == 0.0)
+            {
+                continue;
+            }
+
+            isRemoved[b] = true;
+            grid.Remove(b);
+            remaining--;
+            next[a] = c;
+            previous[c] = a;
+            for (int i : { a, c })
+            {
+                version[i]++;
+                heap.push({ GetHeight(polygon[previous[i]], polygon[i], polygon[next[i]]), i, version[i] });
+            }
+        }
+
+        std::vector<Point> result;
+        result.reserve(remaining);
+        for (int i = 0; i < n; i++)
+        {
+            if (!isRemoved[i])
+            {
+                result.push_back(polygon[i]);
+            }
+        }
+        return result;
+    }
+}
@@ -0,0 +1,18 @@
+#ifndef SIMPLIFY_H
+#define SIMPLIFY_H
+
+#include <vector>
+
+#include "Geometry.h"
+
+namespace geometry
+{
+    // Visvalingam-Whyatt with the height of a vertex over the edge between its neighbours as
+    // the key: the lowest vertex goes first, as long as it is within tolerance of the edge
+    // that replaces it. O(n log n) with a heap.
+    // Topology is kept: a vertex is only removed when no other vertex is in the triangle it
+    // cuts off, so a simple polygon stays simple. At least 3 vertices are left, in order.
+    std::vector<Point> Simplify_Visvalingam(const std::vector<Point>& polygon, double tolerance);
+}
+
+#endif
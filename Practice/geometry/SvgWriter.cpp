@@ -0,0 +1,331 @@
+#include <algorithm>
+#include <cmath>
+
+#include "SvgWriter.h"
+
+namespace geometry
+{
+    namespace
+    {
+        const double MillimetresPerPoint = 25.4 / 72.0;
+
+        // Coordinates are written in steps of a micrometre without a resolution
+        const double DefaultStep = 0.001;
+
+        // Paths are split so that no single element grows without bound
+        const int MaxElementSize = 1 << 16;
+
+        // Entries of each dedupe cache
+        const size_t SeenSize = 1 << 20;
+
+        uint64_t Mix(uint64_t x)
+        {
+            x ^= x >> 30;
+            x *= 0xbf58476d1ce4e5b9ull;
+            x ^= x >> 27;
+            x *= 0x94d049bb133111ebull;
+            x ^= x >> 31;
+            return x;
+        }
+
+        double GetStrokeWidth(const SvgStyle& style)
+        {
+            return style.width * MillimetresPerPoint;
+        }
+    }
+
+    SvgWriter::SvgWriter(FILE* file, Point min, Point max, double resolution)
+        : output(file), resolution(resolution)
+    {
+        double step = resolution > 0.0 ? resolution : DefaultStep;
+        decimals = std::max(0, int(std::ceil(-std::log10(step) - 1e-9)));
+
+        const double margin = 2.0;
+        if (min.x > max.x || min.y > max.y)
+        {
+            min = max = Point(0.0, 0.0);
+        }
+        double left = std::floor(min.x - margin);
+        double top = std::floor(-max.y - margin);
+        double width = std::ceil(max.x + margin) - left;
+        double height = std::ceil(-min.y + margin) - top;
+
+        output.Write("<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"no\"?>\n");
+        output.Write("<svg version=\"1.1\" xmlns=\"http://www.w3.org/2000/svg\" width=\"");
+        output.Write(width, 0);
+        output.Write("mm\" height=\"");
+        output.Write(height, 0);
+        output.Write("mm\" viewBox=\"");
+        output.Write(left, 0);
+        output.Write(' ');
+        output.Write(top, 0);
+        output.Write(' ');
+        output.Write(width, 0);
+        output.Write(' ');
+        output.Write(height, 0);
+        output.Write("\">\n");
+    }
+
+    SvgWriter::~SvgWriter()
+    {
+        Finish();
+    }
+
+    void SvgWriter::SetStyle(const SvgStyle& newStyle)
+    {
+        CloseGroup();
+        style = newStyle;
+        styleId++;
+    }
+
+    void SvgWriter::AddSegment(Point A, Point B)
+    {
+        Cell a = GetCell(A);
+        Cell b = GetCell(B);
+        if (resolution > 0.0)
+        {
+            if (a == b)
+            {
+                droppedCount++;
+                return;
+            }
+
+            // Either direction is the same segment on the page
+            bool isSwapped = b.x < a.x || (b.x == a.x && b.y < a.y);
+            Cell first = isSwapped ? b : a;
+            Cell second = isSwapped ? a : b;
+            uint64_t key = Mix(Mix(Mix(Mix(Mix(styleId) ^ uint64_t(first.x)) ^ uint64_t(first.y)) ^ uint64_t(second.x)) ^ uint64_t(second.y));
+            if (!Remember(seenSegments, key))
+            {
+                droppedCount++;
+                return;
+            }
+        }
+
+        Open(Element::Segments);
+        if (!hasPathEnd || !(pathEnd == a))
+        {
+            output.Write('M');
+            WriteCell(a);
+        }
+        output.Write('L');
+        WriteCell(b);
+        pathEnd = b;
+        hasPathEnd = true;
+    }
+
+    void SvgWriter::AddArrow(Point A, Point B, bool isDoubleHeaded)
+    {
+        AddSegment(A, B);
+
+        double length = 1.5 + 3.0 * GetStrokeWidth(style);
+        double angle = 20.0 * std::acos(-1.0) / 180.0;
+        for (int i = 0; i < (isDoubleHeaded ? 2 : 1); i++)
+        {
+            Point tip = i ? A : B;
+            Point back = (i ? B : A) - tip;
+            double backLength = std::sqrt(back * back);
+            if (backLength == 0.0)
+            {
+                continue;
+            }
+            back = back * (length / backLength);
+            AddSegment(tip, tip + (back & angle));
+            AddSegment(tip, tip + (back & -angle));
+        }
+    }
+
+    void SvgWriter::AddPoint(Point P)
+    {
+        Cell cell = GetCell(P);
+        if (resolution > 0.0 && !Remember(seenPoints, Mix(Mix(Mix(styleId) ^ uint64_t(cell.x)) ^ uint64_t(cell.y))))
+        {
+            droppedCount++;
+            return;
+        }
+
+        Open(Element::Points);
+        output.Write('M');
+        WriteCell(cell);
+        output.Write("h0");
+    }
+
+    void SvgWriter::AddPolygon(const std::vector<Point>& polygon, bool isFilled)
+    {
+        Close();
+        OpenGroup();
+        output.Write("<polygon");
+        if (isFilled)
+        {
+            output.Write(" fill=\"");
+            output.Write(style.colour.c_str());
+            output.Write('"');
+        }
+        output.Write(" points=\"");
+        bool hasPrevious = false;
+        Cell previous = { 0, 0 };
+        for (Point P : polygon)
+        {
+            Cell cell = GetCell(P);
+            if (resolution > 0.0 && hasPrevious && cell == previous)
+            {
+                droppedCount++;
+                continue;
+            }
+            if (hasPrevious)
+            {
+                output.Write(' ');
+            }
+            WriteCell(cell);
+            previous = cell;
+            hasPrevious = true;
+        }
+        output.Write("\"/>\n");
+    }
+
+    void SvgWriter::AddCircle(Point center, double radius, bool isFilled)
+    {
+        Close();
+        OpenGroup();
+        Cell cell = GetCell(center);
+        output.Write("<circle");
+        if (isFilled)
+        {
+            output.Write(" fill=\"");
+            output.Write(style.colour.c_str());
+            output.Write('"');
+        }
+        output.Write(" cx=\"");
+        output.Write(cell.x * (resolution > 0.0 ? resolution : DefaultStep), decimals);
+        output.Write("\" cy=\"");
+        output.Write(-cell.y * (resolution > 0.0 ? resolution : DefaultStep), decimals);
+        output.Write("\" r=\"");
+        WriteNumber(radius);
+        output.Write("\"/>\n");
+    }
+
+    void SvgWriter::Finish()
+    {
+        if (isFinished)
+        {
+            return;
+        }
+        CloseGroup();
+        output.Write("</svg>\n");
+        output.Flush();
+        isFinished = true;
+    }
+
+    SvgWriter::Cell SvgWriter::GetCell(Point P) const
+    {
+        double step = resolution > 0.0 ? resolution : DefaultStep;
+        return { std::llround(P.x / step), std::llround(P.y / step) };
+    }
+
+    // Page y goes down
+    void SvgWriter::WriteCell(Cell cell)
+    {
+        double step = resolution > 0.0 ? resolution : DefaultStep;
+        output.Write(cell.x * step, decimals);
+        output.Write(' ');
+        output.Write(-cell.y * step, decimals);
+    }
+
+    void SvgWriter::WriteNumber(double value)
+    {
+        output.Write(value, decimals);
+    }
+
+    // Groups are written with their first element, a style without any is left out
+    void SvgWriter::OpenGroup()
+    {
+        if (isGroupOpen)
+        {
+            return;
+        }
+
+        output.Write("<g fill=\"none\" stroke=\"");
+        output.Write(style.colour.c_str());
+        output.Write("\" stroke-width=\"");
+        output.Write(GetStrokeWidth(style), 3);
+        output.Write("\" stroke-linecap=\"");
+        output.Write(style.cap.c_str());
+        output.Write("\" stroke-linejoin=\"");
+        output.Write(style.join.c_str());
+        if (!style.dashes.empty())
+        {
+            output.Write("\" stroke-dasharray=\"");
+            for (int i = 0; i < style.dashes.size(); i++)
+            {
+                if (i > 0)
+                {
+                    output.Write(' ');
+                }
+                output.Write(style.dashes[i], 3);
+            }
+        }
+        output.Write("\">\n");
+        isGroupOpen = true;
+    }
+
+    void SvgWriter::Open(Element newElement)
+    {
+        if (element == newElement && elementSize < MaxElementSize)
+        {
+            elementSize++;
+            return;
+        }
+
+        Close();
+        OpenGroup();
+        if (newElement == Element::Points)
+        {
+            // A dot is an empty subpath with round caps, as wide as the point
+            output.Write("<path stroke-linecap=\"round\" stroke-width=\"");
+            output.Write(std::max(0.8, 2.5 * GetStrokeWidth(style)), 3);
+            output.Write("\" d=\"");
+        }
+        else
+        {
+            output.Write("<path d=\"");
+        }
+        element = newElement;
+        elementSize = 1;
+    }
+
+    void SvgWriter::Close()
+    {
+        if (element != Element::None)
+        {
+            output.Write("\"/>\n");
+        }
+        element = Element::None;
+        elementSize = 0;
+        hasPathEnd = false;
+    }
+
+    void SvgWriter::CloseGroup()
+    {
+        Close();
+        if (isGroupOpen)
+        {
+            output.Write("</g>\n");
+        }
+        isGroupOpen = false;
+    }
+
+    bool SvgWriter::Remember(std::vector<uint64_t>& seen, uint64_t key)
+    {
+        if (seen.empty())
+        {
+            seen.resize(SeenSize);
+        }
+        uint64_t& slot = seen[key & (SeenSize - 1)];
+        if (slot == key)
+        {
+            return false;
+        }
+        slot = key;
+        return true;
+    }
+}
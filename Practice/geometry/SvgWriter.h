@@ -0,0 +1,108 @@
+#ifndef SVG_WRITER_H
+#define SVG_WRITER_H
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "Geometry.h"
+#include "OutputBuffer.h"
+
+namespace geometry
+{
+    // What the SP commands colour, width, linetype, cap and join set
+    struct SvgStyle
+    {
+        std::string colour = "black";   // any SVG colour
+        double width = 1.0;             // in points, 1/72 inch
+        std::vector<double> dashes;     // in mm, empty for a solid line
+        std::string cap = "butt";
+        std::string join = "miter";
+    };
+
+    // Streams an SVG page in millimetres with y up. The bounds of everything that is going to
+    // be drawn set the page, so they are needed before the first element.
+    // With a resolution (in mm) the level of detail follows the page: coordinates are rounded
+    // to it, a segment that becomes a point is dropped, a segment or point that is already
+    // on the page in the same style is not written again and segments that continue each
+    // other share a path.
+    class SvgWriter
+    {
+    public:
+        SvgWriter(FILE* file, Point min, Point max, double resolution = 0.0);
+        ~SvgWriter();
+
+        SvgWriter(const SvgWriter&) = delete;
+        SvgWriter& operator=(const SvgWriter&) = delete;
+
+        void SetStyle(const SvgStyle& style);
+
+        void AddSegment(Point A, Point B);
+        // Head at B, and at A as well when isDoubleHeaded
+        void AddArrow(Point A, Point B, bool isDoubleHeaded);
+        void AddPoint(Point P);
+        void AddPolygon(const std::vector<Point>& polygon, bool isFilled);
+        void AddCircle(Point center, double radius, bool isFilled);
+
+        // Closes the document, the destructor does it otherwise
+        void Finish();
+
+        // Segments and points left out by the level of detail
+        int64_t GetDroppedCount() const
+        {
+            return droppedCount;
+        }
+
+    private:
+        enum class Element
+        {
+            None,
+            Segments,
+            Points,
+        };
+
+        struct Cell
+        {
+            int64_t x;
+            int64_t y;
+
+            bool operator==(const Cell& other) const
+            {
+                return x == other.x && y == other.y;
+            }
+        };
+
+        Cell GetCell(Point P) const;
+        void WriteCell(Cell cell);
+        void WriteNumber(double value);
+        void OpenGroup();
+        void Open(Element element);
+        void Close();
+        void CloseGroup();
+        // False when the key was seen before. A direct mapped cache, so a repeat is missed
+        // when another key took its slot in between, but it costs one probe.
+        bool Remember(std::vector<uint64_t>& seen, uint64_t key);
+
+        OutputBuffer output;
+        double resolution;
+        int decimals;
+
+        SvgStyle style;
+        // Counts the SetStyle() calls, it is part of the dedupe keys so that a repeat in
+        // another style is drawn
+        uint64_t styleId = 0;
+        bool isGroupOpen = false;
+        Element element = Element::None;
+        int elementSize = 0;
+        Cell pathEnd = { 0, 0 };
+        bool hasPathEnd = false;
+
+        std::vector<uint64_t> seenSegments;
+        std::vector<uint64_t> seenPoints;
+        int64_t droppedCount = 0;
+        bool isFinished = false;
+    };
+}
+
+#endif
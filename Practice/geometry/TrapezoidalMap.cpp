@@ -0,0 +1,388 @@
+#include <algorithm>
+#include <random>
+
+#include "Hilbert.h"
+#include "Parallel.h"
+#include "TrapezoidalMap.h"
+
+namespace geometry
+{
+    namespace
+    {
+        bool IsLess(Point a, Point b)
+        {
+            return a.x < b.x || (a.x == b.x && a.y < b.y);
+        }
+    }
+
+    TrapezoidalMap::TrapezoidalMap(const std::vector<std::vector<Point>>& polygons, uint64_t seed)
+    {
+        GEOMETRY_STAGE(stage, "TrapezoidalMap/edges");
+        for (int i = 0; i < polygons.size(); i++)
+        {
+            const std::vector<Point>& polygon = polygons[i];
+            double orientation = 0.0;
+            for (int j = 0; j < polygon.size(); j++)
+            {
+                Point a = polygon[j];
+                Point b = polygon[(j + 1) % polygon.size()];
+                orientation += (a.x * b.y) - (a.y * b.x);
+            }
+            // The inside is left of every edge of a counter-clockwise polygon
+            bool isCounterClockwise = orientation > 0.0;
+            for (int j = 0; j < polygon.size(); j++)
+            {
+                Point a = polygon[j];
+                Point b = polygon[(j + 1) % polygon.size()];
+                if (a == b)
+                {
+                    continue;
+                }
+                bool isInsideAbove = IsLess(a, b) == isCounterClockwise;
+                edges.push_back({ IsLess(a, b) ? a : b, IsLess(a, b) ? b : a, isInsideAbove ? i : -1, isInsideAbove ? -1 : i });
+            }
+        }
+
+        // A shared edge is one edge with a polygon on either side
+        std::sort(edges.begin(), edges.end(), [](const Edge& a, const Edge& b)
+        {
+            return a.A != b.A ? IsLess(a.A, b.A) : IsLess(a.B, b.B);
+        });
+        int count = 0;
+        for (const Edge& edge : edges)
+        {
+            if (count > 0 && edges[count - 1].A == edge.A && edges[count - 1].B == edge.B)
+            {
+                Edge& shared = edges[count - 1];
+                shared.above = std::max(shared.above, edge.above);
+                shared.below = std::max(shared.below, edge.below);
+                continue;
+            }
+            edges[count++] = edge;
+        }
+        edges.resize(count);
+
+        GEOMETRY_NEXT_STAGE(stage, "TrapezoidalMap/insert");
+        std::mt19937_64 random(seed);
+        std::shuffle(edges.begin(), edges.end(), random);
+        trapezoids.reserve(3 * edges.size() + 1);
+        nodes.reserve(8 * edges.size() + 1);
+        AddTrapezoid(-1, -1, -1, -1);
+        Crossing crossing;
+        for (int i = 0; i < edges.size(); i++)
+        {
+            Insert(i, crossing);
+        }
+
+        GEOMETRY_NEXT_STAGE(stage, "TrapezoidalMap/layout");
+        Layout();
+    }
+
+    // Nodes are added in random order, depth first a search mostly reads ahead
+    void TrapezoidalMap::Layout()
+    {
+        std::vector<int> order(nodes.size(), -1);
+        std::vector<Node> laidOut;
+        laidOut.reserve(nodes.capacity());
+        std::vector<int> stack = { 0 };
+        while (!stack.empty())
+        {
+            int node = stack.back();
+            stack.pop_back();
+            if (order[node] != -1)
+            {
+                continue;
+            }
+            order[node] = int(laidOut.size());
+            laidOut.push_back(nodes[node]);
+            if (nodes[node].type != NodeType::Trapezoid)
+            {
+                stack.push_back(nodes[node].second);
+                stack.push_back(nodes[node].first);
+            }
+        }
+        for (Node& node : laidOut)
+        {
+            if (node.type == NodeType::Trapezoid)
+            {
+                trapezoids[node.index].node = order[trapezoids[node.index].node];
+                continue;
+            }
+            node.first = order[node.first];
+            node.second = order[node.second];
+        }
+        nodes.swap(laidOut);
+    }
+
+    FaceLocation TrapezoidalMap::GetLocation(Point P) const
+    {
+        int node = 0;
+        while (true)
+        {
+            const Node& current = nodes[node];
+            if (current.type == NodeType::Vertex)
+            {
+                Point V = GetPoint(current.index);
+                if (P == V)
+                {
+                    const Edge& edge = edges[current.index >> 1];
+                    return { edge.above != -1 ? edge.above : edge.below, PointLocation::Edge };
+                }
+                node = IsLess(P, V) ? current.first : current.second;
+            }
+            else if (current.type == NodeType::Edge)
+            {
+                const Edge& edge = edges[current.index];
+                double side = Orient2D(edge.A, edge.B, P);
+                if (side == 0.0)
+                {
+                    return { edge.above != -1 ? edge.above : edge.below, PointLocation::Edge };
+                }
+                node = side > 0.0 ? current.first : current.second;
+            }
+            else
+            {
+                int bottom = trapezoids[current.index].bottom;
+                int face = bottom == -1 ? -1 : edges[bottom].above;
+                return { face, face == -1 ? PointLocation::Outside : PointLocation::Inside };
+            }
+        }
+    }
+
+    void TrapezoidalMap::GetLocations(const std::vector<Point>& queries, std::vector<FaceLocation>& locations, int threadCount) const
+    {
+        GEOMETRY_STAGE(stage, "TrapezoidalMap/order");
+        std::vector<int> order = GetSpatialOrder(queries);
+
+        GEOMETRY_NEXT_STAGE(stage, "TrapezoidalMap/queries");
+        locations.resize(queries.size());
+        ParallelFor(int(queries.size()), GetThreadCount(threadCount), [&](int, int begin, int end)
+        {
+            for (int i = begin; i < end; i++)
+            {
+                locations[order[i]] = GetLocation(queries[order[i]]);
+            }
+        });
+    }
+
+    // The trapezoid the edge starts in: at its own A it goes right, on an edge sharing its
+    // A the side of its B decides
+    int TrapezoidalMap::Find(int edge) const
+    {
+        Point P = edges[edge].A;
+        Point Q = edges[edge].B;
+        int node = 0;
+        while (nodes[node].type != NodeType::Trapezoid)
+        {
+            const Node& current = nodes[node];
+            if (current.type == NodeType::Vertex)
+            {
+                node = IsLess(P, GetPoint(current.index)) ? current.first : current.second;
+            }
+            else
+            {
+                const Edge& other = edges[current.index];
+                double side = other.A == P ? Orient2D(other.A, other.B, Q) : Orient2D(other.A, other.B, P);
+                node = side > 0.0 ? current.first : current.second;
+            }
+        }
+        return nodes[node].index;
+    }
+
+    int TrapezoidalMap::AddTrapezoid(int top, int bottom, int left, int right)
+    {
+        nodes.push_back({ NodeType::Trapezoid, 0, -1, -1 });
+        Trapezoid trapezoid = { top, bottom, left, right, -1, -1, -1, -1, int(nodes.size()) - 1 };
+        int index;
+        if (freeTrapezoids.empty())
+        {
+            index = int(trapezoids.size());
+            trapezoids.push_back(trapezoid);
+        }
+        else
+        {
+            index = freeTrapezoids.back();
+            freeTrapezoids.pop_back();
+            trapezoids[index] = trapezoid;
+        }
+        nodes.back().index = index;
+        return index;
+    }
+
+    void TrapezoidalMap::ReplaceLeft(int trapezoid, int from, int to)
+    {
+        if (trapezoid == -1)
+        {
+            return;
+        }
+        Trapezoid& t = trapezoids[trapezoid];
+        t.upperLeft = t.upperLeft == from ? to : t.upperLeft;
+        t.lowerLeft = t.lowerLeft == from ? to : t.lowerLeft;
+    }
+
+    void TrapezoidalMap::ReplaceRight(int trapezoid, int from, int to)
+    {
+        if (trapezoid == -1)
+        {
+            return;
+        }
+        Trapezoid& t = trapezoids[trapezoid];
+        t.upperRight = t.upperRight == from ? to : t.upperRight;
+        t.lowerRight = t.lowerRight == from ? to : t.lowerRight;
+    }
+
+    // The trapezoids the edge crosses are cut into the ones above and below it. Where the
+    // right side of a crossed trapezoid comes from a point below the edge the ones above
+    // merge, and the other way round. A new end point also cuts off the part before or
+    // after it.
+    void TrapezoidalMap::Insert(int edge, Crossing& crossing)
+    {
+        Point P = edges[edge].A;
+        Point Q = edges[edge].B;
+        int p = 2 * edge;
+        int q = 2 * edge + 1;
+        auto isAbove = [&](int point) { return Orient2D(P, Q, GetPoint(point)) > 0.0; };
+
+        std::vector<int>& crossed = crossing.crossed;
+        std::vector<Trapezoid>& old = crossing.old;
+        crossed.clear();
+        old.clear();
+        crossed.push_back(Find(edge));
+        old.push_back(trapezoids[crossed.back()]);
+        while (old.back().right != -1 && IsLess(GetPoint(old.back().right), Q))
+        {
+            int next = isAbove(old.back().right) ? old.back().lowerRight : old.back().upperRight;
+            if (next == -1)
+            {
+                // Only where edges cross, the polygons are not a subdivision
+                break;
+            }
+            crossed.push_back(next);
+            old.push_back(trapezoids[next]);
+        }
+        int k = int(crossed.size()) - 1;
+        bool hasP = old[0].left != -1 && GetPoint(old[0].left) == P;
+        bool hasQ = old[k].right != -1 && GetPoint(old[k].right) == Q;
+
+        int before = -1;
+        if (!hasP)
+        {
+            before = AddTrapezoid(old[0].top, old[0].bottom, old[0].left, p);
+            trapezoids[before].upperLeft = old[0].upperLeft;
+            trapezoids[before].lowerLeft = old[0].lowerLeft;
+            ReplaceRight(old[0].upperLeft, crossed[0], before);
+            ReplaceRight(old[0].lowerLeft, crossed[0], before);
+        }
+        int after = -1;
+        if (!hasQ)
+        {
+            after = AddTrapezoid(old[k].top, old[k].bottom, q, old[k].right);
+            trapezoids[after].upperRight = old[k].upperRight;
+            trapezoids[after].lowerRight = old[k].lowerRight;
+            ReplaceLeft(old[k].upperRight, crossed[k], after);
+            ReplaceLeft(old[k].lowerRight, crossed[k], after);
+        }
+
+        std::vector<int>& uppers = crossing.uppers;
+        std::vector<int>& lowers = crossing.lowers;
+        uppers.assign(k + 1, -1);
+        lowers.assign(k + 1, -1);
+        for (int j = 0; j <= k; j++)
+        {
+            const Trapezoid& crossedTrapezoid = old[j];
+            bool isFirstAbove = j > 0 && isAbove(old[j - 1].right);
+            bool isLastAbove = j < k && isAbove(crossedTrapezoid.right);
+
+            // Above the edge
+            if (j == 0 || isFirstAbove)
+            {
+                int upper = AddTrapezoid(crossedTrapezoid.top, edge, j == 0 ? p : old[j - 1].right, -1);
+                trapezoids[upper].upperLeft = j == 0 && !hasP ? before : crossedTrapezoid.upperLeft;
+                if (j > 0)
+                {
+                    trapezoids[upper].lowerLeft = uppers[j - 1];
+                    trapezoids[uppers[j - 1]].lowerRight = upper;
+                }
+                if (j > 0 || hasP)
+                {
+                    ReplaceRight(crossedTrapezoid.upperLeft, crossed[j], upper);
+                }
+                uppers[j] = upper;
+            }
+            else
+            {
+                uppers[j] = uppers[j - 1];
+            }
+            if (j == k || isLastAbove)
+            {
+                Trapezoid& upper = trapezoids[uppers[j]];
+                upper.right = j == k ? q : crossedTrapezoid.right;
+                upper.upperRight = j == k && !hasQ ? after : crossedTrapezoid.upperRight;
+                if (j < k || hasQ)
+                {
+                    ReplaceLeft(crossedTrapezoid.upperRight, crossed[j], uppers[j]);
+                }
+            }
+
+            // Below the edge
+            if (j == 0 || !isFirstAbove)
+            {
+                int lower = AddTrapezoid(edge, crossedTrapezoid.bottom, j == 0 ? p : old[j - 1].right, -1);
+                trapezoids[lower].lowerLeft = j == 0 && !hasP ? before : crossedTrapezoid.lowerLeft;
+                if (j > 0)
+                {
+                    trapezoids[lower].upperLeft = lowers[j - 1];
+                    trapezoids[lowers[j - 1]].upperRight = lower;
+                }
+                if (j > 0 || hasP)
+                {
+                    ReplaceRight(crossedTrapezoid.lowerLeft, crossed[j], lower);
+                }
+                lowers[j] = lower;
+            }
+            else
+            {
+                lowers[j] = lowers[j - 1];
+            }
+            if (j == k || !isLastAbove)
+            {
+                Trapezoid& lower = trapezoids[lowers[j]];
+                lower.right = j == k ? q : crossedTrapezoid.right;
+                lower.lowerRight = j == k && !hasQ ? after : crossedTrapezoid.lowerRight;
+                if (j < k || hasQ)
+                {
+                    ReplaceLeft(crossedTrapezoid.lowerRight, crossed[j], lowers[j]);
+                }
+            }
+        }
+        if (!hasP)
+        {
+            trapezoids[before].upperRight = uppers[0];
+            trapezoids[before].lowerRight = lowers[0];
+        }
+        if (!hasQ)
+        {
+            trapezoids[after].upperLeft = uppers[k];
+            trapezoids[after].lowerLeft = lowers[k];
+        }
+
+        // The leaf of every crossed trapezoid becomes the test against the edge, behind the
+        // tests against new end points
+        for (int j = 0; j <= k; j++)
+        {
+            Node node = { NodeType::Edge, edge, trapezoids[uppers[j]].node, trapezoids[lowers[j]].node };
+            if (j == k && !hasQ)
+            {
+                nodes.push_back(node);
+                node = { NodeType::Vertex, q, int(nodes.size()) - 1, trapezoids[after].node };
+            }
+            if (j == 0 && !hasP)
+            {
+                nodes.push_back(node);
+                node = { NodeType::Vertex, p, trapezoids[before].node, int(nodes.size()) - 1 };
+            }
+            nodes[old[j].node] = node;
+            freeTrapezoids.push_back(crossed[j]);
+        }
+    }
+}
@@ -0,0 +1,110 @@
+#ifndef TRAPEZOIDAL_MAP_H
+#define TRAPEZOIDAL_MAP_H
+
+#include <cstdint>
+#include <vector>
+
+#include "PointLocation.h"
+
+namespace geometry
+{
+    // Where a point is in a subdivision: face is the index of the polygon it is in, -1 with
+    // Outside. On an Edge it is one of the polygons that edge bounds.
+    struct FaceLocation
+    {
+        int face;
+        PointLocation location;
+    };
+
+    // Point location over a planar subdivision: polygons in either orientation whose insides
+    // do not overlap. Polygons may share edges, a shared edge must have the same two vertices
+    // in both. Randomized incremental trapezoidal map (Seidel, Mulmuley) with the search DAG
+    // in one flat array: O(n log n) expected to build, O(log n) expected per query.
+    // Vertical edges and equal x are handled by ordering points in x then y.
+    class TrapezoidalMap
+    {
+    public:
+        explicit TrapezoidalMap(const std::vector<std::vector<Point>>& polygons, uint64_t seed = 1);
+
+        FaceLocation GetLocation(Point P) const;
+
+        // locations[i] is GetLocation(queries[i]). The queries are walked along a Hilbert curve,
+        // so neighbours share the nodes near the leaves, and split over threadCount threads,
+        // 0 means std::thread::hardware_concurrency().
+        void GetLocations(const std::vector<Point>& queries, std::vector<FaceLocation>& locations, int threadCount = 0) const;
+
+        int GetNodeCount() const
+        {
+            return int(nodes.size());
+        }
+
+    private:
+        // From A to B in x then y order, above and below are the polygons on either side
+        struct Edge
+        {
+            Point A;
+            Point B;
+            int above;
+            int below;
+        };
+
+        // A point is 2 * edge for its A and 2 * edge + 1 for its B, -1 is at infinity
+        struct Trapezoid
+        {
+            int top;
+            int bottom;
+            int left;
+            int right;
+            int upperLeft;
+            int lowerLeft;
+            int upperRight;
+            int lowerRight;
+            int node;
+        };
+
+        enum class NodeType
+        {
+            Vertex,
+            Edge,
+            Trapezoid,
+        };
+
+        // A vertex node goes to first when the point is before it, an edge node when it is
+        // above it. Index is the point, the edge or the trapezoid.
+        struct Node
+        {
+            NodeType type;
+            int index;
+            int first;
+            int second;
+        };
+
+        Point GetPoint(int point) const
+        {
+            return point & 1 ? edges[point >> 1].B : edges[point >> 1].A;
+        }
+
+        // Buffers Insert() keeps from one edge to the next
+        struct Crossing
+        {
+            std::vector<int> crossed;
+            std::vector<Trapezoid> old;
+            std::vector<int> uppers;
+            std::vector<int> lowers;
+        };
+
+        void Insert(int edge, Crossing& crossing);
+        int Find(int edge) const;
+        int AddTrapezoid(int top, int bottom, int left, int right);
+        void ReplaceLeft(int trapezoid, int from, int to);
+        void ReplaceRight(int trapezoid, int from, int to);
+        void Layout();
+
+        std::vector<Edge> edges;
+        std::vector<Trapezoid> trapezoids;
+        std::vector<int> freeTrapezoids;
+        std::vector<Node> nodes;
+    };
+}
+
+#endif
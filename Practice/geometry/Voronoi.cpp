@@ -0,0 +1,869 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+#include "Hilbert.h"
+#include "Voronoi.h"
+
+namespace geometry
+{
+    namespace
+    {
+        // The half-edge of sites[0] goes from vertices[0] to vertices[1], along the bisector
+        // turned left from sites[0] to sites[1]. -1 is a vertex at infinity. third is a site
+        // on the circle of the first vertex the edge got that is not one of its sites.
+        struct Edge
+        {
+            int sites[2];
+            int vertices[2];
+            int third;
+        };
+
+        // A node of the treap and of the list of arcs in x order. edge is the one the
+        // breakpoint with next traces, event the serial of the arc's valid circle event.
+        struct Arc
+        {
+            int site;
+            int edge;
+            int prev;
+            int next;
+            int parent;
+            int left;
+            int right;
+            uint32_t priority;
+            int event;
+        };
+
+        // The arc goes when the sweep reaches the top of the circle of its site and its
+        // neighbours' sites, serial is the arc's event while it is still valid
+        struct CircleEvent
+        {
+            double y;
+            int arc;
+            int serial;
+        };
+
+        bool IsLater(const CircleEvent& a, const CircleEvent& b)
+        {
+            return a.y > b.y;
+        }
+
+        // From B, divided by the area of (A, B, C) from Orient2D(): of the right sign, so for
+        // sites close to collinear the center is far off but on the side the breakpoints go
+        Point GetCircumcenter(Point A, Point B, Point C, double area)
+        {
+            Point BA = A - B;
+            Point BC = C - B;
+            double ba2 = BA * BA;
+            double bc2 = BC * BC;
+            return B + Point(BC.y * ba2 - BA.y * bc2, BA.x * bc2 - BC.x * ba2) / (-2.0 * area);
+        }
+
+        // Whether x is left of where the parabolas of P on the left and Q on the right meet
+        // with the sweep at y. Between its two meeting points the parabola of the site nearer
+        // to the sweep is the higher one and its site is between them, so comparing the
+        // heights at x, without the roots, tells the side.
+        bool IsBeforeBreakpoint(double x, Point P, Point Q, double y)
+        {
+            double dp = y - P.y;
+            double dq = y - Q.y;
+            if (dp == dq)
+            {
+                return x < (P.x + Q.x) / 2.0;
+            }
+            // The height of P at x above that of Q, times 2 dp dq
+            double Px = x - P.x;
+            double Qx = x - Q.x;
+            bool isPHigher = dp * dq * (dq - dp) + dp * Qx * Qx - dq * Px * Px > 0.0;
+            return dp < dq ? x < P.x || isPHigher : x < Q.x && isPHigher;
+        }
+
+        // Sites by y then x, the first of duplicates only
+        std::vector<int> GetSweepOrder(const std::vector<Point>& sites)
+        {
+            std::vector<SpatialKey> keys(sites.size());
+            for (size_t i = 0; i < sites.size(); i++)
+            {
+                keys[i] = { GetSortKey(sites[i].y), int(i) };
+            }
+            RadixSort(keys);
+
+            std::vector<int> order;
+            order.reserve(sites.size());
+            for (size_t begin = 0; begin < keys.size();)
+            {
+                size_t end = begin + 1;
+                while (end < keys.size() && keys[end].key == keys[begin].key)
+                {
+                    end++;
+                }
+                if (end - begin > 1)
+                {
+                    std::sort(keys.begin() + begin, keys.begin() + end, [&](const SpatialKey& a, const SpatialKey& b)
+                    {
+                        double ax = sites[a.index].x;
+                        double bx = sites[b.index].x;
+                        return ax < bx || (ax == bx && a.index < b.index);
+                    });
+                }
+                for (size_t i = begin; i < end; i++)
+                {
+                    if (i == begin || sites[keys[i].index].x != sites[keys[i - 1].index].x)
+                    {
+                        order.push_back(keys[i].index);
+                    }
+                }
+                begin = end;
+            }
+            return order;
+        }
+
+        class FortuneSweep
+        {
+        public:
+            explicit FortuneSweep(const std::vector<Point>& points)
+                : points(points)
+            {
+            }
+
+            // The sites are in sweep order
+            void Run()
+            {
+                int siteCount = int(points.size());
+                edges.reserve(size_t(siteCount) * 3);
+                links.reserve(size_t(siteCount) * 6);
+                vertices.reserve(size_t(siteCount) * 2);
+                for (int site = 0; site < siteCount; site++)
+                {
+                    // Circles closing at the site's y go first
+                    while (!events.empty() && events.front().y <= points[site].y)
+                    {
+                        Pop();
+                    }
+                    AddSite(site);
+                }
+                while (!events.empty())
+                {
+                    Pop();
+                }
+            }
+
+            std::vector<Edge> edges;
+            std::vector<Point> vertices;
+            // Half-edge 2 e is the side of edges[e].sites[0], 2 e + 1 of sites[1]; links has
+            // the next one around the cell where the vertex it ends at was found
+            std::vector<int> links;
+
+        private:
+            void Pop()
+            {
+                std::pop_heap(events.begin(), events.end(), IsLater);
+                CircleEvent event = events.back();
+                events.pop_back();
+                if (arcs[event.arc].event == event.serial)
+                {
+                    RemoveArc(event);
+                }
+            }
+
+            void AddSite(int site)
+            {
+                Point P = points[site];
+                if (root == -1)
+                {
+                    root = last = NewArc(site);
+                    return;
+                }
+                if (isFlat && points[arcs[last].site].y == P.y)
+                {
+                    // The sites so far are on one horizontal line in x order, their arcs are
+                    // vertical rays with a vertical edge between each two
+                    int arc = NewArc(site);
+                    arcs[last].edge = AddEdge(arcs[last].site, site, -1, -1);
+                    InsertAfter(last, arc);
+                    last = arc;
+                    return;
+                }
+                isFlat = false;
+
+                // The arc above the site splits in two around the new one
+                int arc = Find(P.x, P.y);
+                int split = arcs[arc].site;
+                int edge = AddEdge(split, site, -1, -1);
+                int middle = NewArc(site);
+                int right = NewArc(split);
+                arcs[right].edge = arcs[arc].edge;
+                arcs[middle].edge = edge;
+                arcs[arc].edge = edge;
+                arcs[arc].event = 0;
+                InsertAfter(arc, middle);
+                InsertAfter(middle, right);
+                AddCircleEvent(arc);
+                AddCircleEvent(right);
+            }
+
+            void RemoveArc(const CircleEvent& event)
+            {
+                int arc = event.arc;
+                int left = arcs[arc].prev;
+                int right = arcs[arc].next;
+                int a = arcs[left].site;
+                int b = arcs[arc].site;
+                int c = arcs[right].site;
+                int leftEdge = arcs[left].edge;
+                int rightEdge = arcs[arc].edge;
+
+                int vertex = GetSameVertex(leftEdge, a, a, b, c);
+                if (vertex == -1)
+                {
+                    vertex = GetSameVertex(rightEdge, b, a, b, c);
+                }
+                if (vertex == -1)
+                {
+                    Point A = points[a];
+                    Point B = points[b];
+                    Point C = points[c];
+                    vertex = int(vertices.size());
+                    vertices.push_back(GetCircumcenter(A, B, C, Orient2D(A, B, C)));
+                }
+                SetEnd(leftEdge, a, vertex, c);
+                SetEnd(rightEdge, b, vertex, a);
+
+                // Around the vertex the cell of a goes from the left edge to the new one, of b
+                // from the right edge to the left one and of c from the new one to the right
+                int edge = AddEdge(a, c, vertex, b);
+                links[GetHalfEdge(leftEdge, a)] = GetHalfEdge(edge, a);
+                links[GetHalfEdge(rightEdge, b)] = GetHalfEdge(leftEdge, b);
+                links[GetHalfEdge(edge, c)] = GetHalfEdge(rightEdge, c);
+
+                Remove(arc);
+                arcs[left].edge = edge;
+                arcs[left].event = 0;
+                arcs[right].event = 0;
+                AddCircleEvent(left);
+                AddCircleEvent(right);
+            }
+
+            // The vertex at the other end of the edge, if it is on the circle of a, b and c
+            int GetSameVertex(int edge, int leftSite, int a, int b, int c) const
+            {
+                const Edge& e = edges[edge];
+                int other = e.vertices[e.sites[0] == leftSite ? 0 : 1];
+                if (other == -1 || InCircle(points[a], points[b], points[c], points[e.third]) != 0.0)
+                {
+                    return -1;
+                }
+                return other;
+            }
+
+            // The end the breakpoint with leftSite on its left traces
+            void SetEnd(int edge, int leftSite, int vertex, int third)
+            {
+                Edge& e = edges[edge];
+                e.vertices[e.sites[0] == leftSite ? 1 : 0] = vertex;
+                if (e.third == -1)
+                {
+                    e.third = third;
+                }
+            }
+
+            int AddEdge(int left, int right, int vertex, int third)
+            {
+                edges.push_back({ { left, right }, { vertex, -1 }, third });
+                links.push_back(-1);
+                links.push_back(-1);
+                return int(edges.size()) - 1;
+            }
+
+            int GetHalfEdge(int edge, int site) const
+            {
+                return 2 * edge + (edges[edge].sites[0] == site ? 0 : 1);
+            }
+
+            // The breakpoints of an arc and its neighbours meet when the sites turn
+            // counter-clockwise
+            void AddCircleEvent(int arc)
+            {
+                int left = arcs[arc].prev;
+                int right = arcs[arc].next;
+                if (left == -1 || right == -1)
+                {
+                    return;
+                }
+                Point A = points[arcs[left].site];
+                Point B = points[arcs[arc].site];
+                Point C = points[arcs[right].site];
+                double area = Orient2D(A, B, C);
+                if (area <= 0.0)
+                {
+                    return;
+                }
+                Point center = GetCircumcenter(A, B, C, area);
+                arcs[arc].event = ++serial;
+                events.push_back({ center.y + vecta::len(B - center), arc, serial });
+                std::push_heap(events.begin(), events.end(), IsLater);
+            }
+
+            int Find(double x, double y) const
+            {
+                int arc = root;
+                while (true)
+                {
+                    const Arc& node = arcs[arc];
+                    if (node.left != -1 && IsBeforeBreakpoint(x, points[arcs[node.prev].site], points[node.site], y))
+                    {
+                        arc = node.left;
+                    }
+                    else if (node.right != -1 && !IsBeforeBreakpoint(x, points[node.site], points[arcs[node.next].site], y))
+                    {
+                        arc = node.right;
+                    }
+                    else
+                    {
+                        return arc;
+                    }
+                }
+            }
+
+            int NewArc(int site)
+            {
+                int arc = int(arcs.size());
+                if (freeArcs.empty())
+                {
+                    arcs.emplace_back();
+                }
+                else
+                {
+                    arc = freeArcs.back();
+                    freeArcs.pop_back();
+                }
+                random ^= random << 13;
+                random ^= random >> 7;
+                random ^= random << 17;
+                arcs[arc] = { site, -1, -1, -1, -1, -1, -1, uint32_t(random >> 32), 0 };
+                return arc;
+            }
+
+            // Right after arc in x order: a leaf under arc or under the next arc, rotated up
+            // to its priority
+            void InsertAfter(int arc, int added)
+            {
+                int next = arcs[arc].next;
+                arcs[added].prev = arc;
+                arcs[added].next = next;
+                arcs[arc].next = added;
+                if (next != -1)
+                {
+                    arcs[next].prev = added;
+                }
+
+                if (arcs[arc].right == -1)
+                {
+                    arcs[arc].right = added;
+                    arcs[added].parent = arc;
+                }
+                else
+                {
+                    arcs[next].left = added;
+                    arcs[added].parent = next;
+                }
+                while (arcs[added].parent != -1 && arcs[arcs[added].parent].priority < arcs[added].priority)
+                {
+                    RotateUp(added);
+                }
+            }
+
+            // Rotated down to a leaf and cut off
+            void Remove(int arc)
+            {
+                while (arcs[arc].left != -1 || arcs[arc].right != -1)
+                {
+                    int left = arcs[arc].left;
+                    int right = arcs[arc].right;
+                    RotateUp(right == -1 || (left != -1 && arcs[left].priority > arcs[right].priority) ? left : right);
+                }
+                int parent = arcs[arc].parent;
+                if (parent == -1)
+                {
+                    root = -1;
+                }
+                else if (arcs[parent].left == arc)
+                {
+                    arcs[parent].left = -1;
+                }
+                else
+                {
+                    arcs[parent].right = -1;
+                }
+
+                int prev = arcs[arc].prev;
+                int next = arcs[arc].next;
+                if (prev != -1)
+                {
+                    arcs[prev].next = next;
+                }
+                if (next != -1)
+                {
+                    arcs[next].prev = prev;
+                }
+                arcs[arc].event = 0;
+                freeArcs.push_back(arc);
+            }
+
+            void RotateUp(int arc)
+            {
+                int parent = arcs[arc].parent;
+                int grandparent = arcs[parent].parent;
+                if (arcs[parent].left == arc)
+                {
+                    int moved = arcs[arc].right;
+                    arcs[parent].left = moved;
+                    if (moved != -1)
+                    {
+                        arcs[moved].parent = parent;
+                    }
+                    arcs[arc].right = parent;
+                }
+                else
+                {
+                    int moved = arcs[arc].left;
+                    arcs[parent].right = moved;
+                    if (moved != -1)
+                    {
+                        arcs[moved].parent = parent;
+                    }
+                    arcs[arc].left = parent;
+                }
+                arcs[parent].parent = arc;
+                arcs[arc].parent = grandparent;
+                if (grandparent == -1)
+                {
+                    root = arc;
+                }
+                else if (arcs[grandparent].left == parent)
+                {
+                    arcs[grandparent].left = arc;
+                }
+                else
+                {
+                    arcs[grandparent].right = arc;
+                }
+            }
+
+            const std::vector<Point>& points;
+            std::vector<Arc> arcs;
+            std::vector<int> freeArcs;
+            std::vector<CircleEvent> events;
+            int root = -1;
+            int last = -1;
+            bool isFlat = true;
+            int serial = 0;
+            uint64_t random = 88172645463325252ull;
+        };
+
+        // Cuts the edges of the sweep to the box and closes the cells along it. Sites are
+        // in sweep order until the end, order has their indices in the input.
+        class VoronoiClipper
+        {
+        public:
+            VoronoiClipper(const std::vector<Point>& points, const std::vector<int>& order, Point min, Point max)
+                : points(points), order(order), min(min), max(max), width(max.x - min.x), height(max.y - min.y)
+            {
+            }
+
+            VoronoiDiagram Build(const FortuneSweep& sweep, int inputCount)
+            {
+                const std::vector<Edge>& edges = sweep.edges;
+                const std::vector<Point>& sweepVertices = sweep.vertices;
+                const double infinity = std::numeric_limits<double>::infinity();
+                std::vector<int> vertexMap(sweepVertices.size(), -1);
+                auto mapVertex = [&](int vertex)
+                {
+                    if (vertexMap[vertex] == -1)
+                    {
+                        vertexMap[vertex] = AddVertex(sweepVertices[vertex]);
+                    }
+                    return vertexMap[vertex];
+                };
+
+                // Where each edge of the sweep went, -1 when it is not in the box, and which
+                // ends were cut at its boundary
+                std::vector<int> edgeMap(edges.size(), -1);
+                std::vector<uint8_t> cuts;
+                diagram.origins.reserve(edges.size() * 2);
+                diagram.nexts.reserve(edges.size() * 2);
+                diagram.sites.reserve(edges.size() * 2);
+                cuts.reserve(edges.size());
+                for (size_t e = 0; e < edges.size(); e++)
+                {
+                    const Edge& edge = edges[e];
+                    int v0 = edge.vertices[0];
+                    int v1 = edge.vertices[1];
+                    if (IsZeroLength(edge))
+                    {
+                        continue;
+                    }
+                    if (v0 != -1 && v1 != -1 && IsInside(sweepVertices[v0]) && IsInside(sweepVertices[v1]))
+                    {
+                        edgeMap[e] = AddEdge(mapVertex(v0), mapVertex(v1), edge.sites[0], edge.sites[1]) / 2;
+                        cuts.push_back(0);
+                        continue;
+                    }
+
+                    // Cut along the bisector rather than towards a vertex, which can be far off
+                    // and rounded for sites close to collinear
+                    Point P = points[edge.sites[0]];
+                    Point Q = points[edge.sites[1]];
+                    Point O = (P + Q) / 2.0;
+                    Point direction(P.y - Q.y, Q.x - P.x);
+                    double length2 = direction * direction;
+                    double t0 = v0 != -1 ? (sweepVertices[v0] - O) * direction / length2 : -infinity;
+                    double t1 = v1 != -1 ? (sweepVertices[v1] - O) * direction / length2 : infinity;
+                    int side0 = -1;
+                    int side1 = -1;
+                    if (!Clip(O, direction, t0, t1, side0, side1))
+                    {
+                        continue;
+                    }
+                    int from = side0 == -1 ? mapVertex(v0) : AddVertex(Snap(O + t0 * direction, side0));
+                    int to = side1 == -1 ? mapVertex(v1) : AddVertex(Snap(O + t1 * direction, side1));
+                    edgeMap[e] = AddEdge(from, to, edge.sites[0], edge.sites[1]) / 2;
+                    cuts.push_back(uint8_t((side0 != -1 ? 1 : 0) | (side1 != -1 ? 2 : 0)));
+                }
+
+                // A half-edge ending at a vertex of the sweep goes on as the sweep linked it,
+                // past the zero-length edges of cocircular sites. The others end on the
+                // boundary, each goes along it to the nearest one starting on it in its cell.
+                std::vector<uint8_t> hasPrevious(diagram.origins.size(), 0);
+                for (size_t e = 0; e < edges.size(); e++)
+                {
+                    int edge = edgeMap[e];
+                    for (int side = 0; edge != -1 && side < 2; side++)
+                    {
+                        if (cuts[edge] & (side == 0 ? 2 : 1))
+                        {
+                            continue;
+                        }
+                        int next = sweep.links[2 * e + side];
+                        while (next != -1 && edgeMap[next / 2] == -1 && IsZeroLength(edges[next / 2]))
+                        {
+                            next = sweep.links[next];
+                        }
+                        if (next == -1 || edgeMap[next / 2] == -1 || (cuts[edgeMap[next / 2]] & (next % 2 == 0 ? 1 : 2)))
+                        {
+                            continue;
+                        }
+                        int h = 2 * edgeMap[next / 2] + next % 2;
+                        diagram.nexts[2 * edge + side] = h;
+                        hasPrevious[h] = 1;
+                    }
+                }
+                std::vector<std::pair<int, int>> ends;
+                std::vector<std::pair<int, int>> starts;
+                for (int h = 0; h < int(hasPrevious.size()); h++)
+                {
+                    if (diagram.nexts[h] == -1)
+                    {
+                        ends.push_back({ diagram.sites[h], h });
+                    }
+                    if (!hasPrevious[h])
+                    {
+                        starts.push_back({ diagram.sites[h], h });
+                    }
+                }
+                std::sort(ends.begin(), ends.end());
+                std::sort(starts.begin(), starts.end());
+                for (size_t i = 0, j = 0; i < ends.size();)
+                {
+                    int cell = ends[i].first;
+                    size_t endsEnd = i;
+                    while (endsEnd < ends.size() && ends[endsEnd].first == cell)
+                    {
+                        endsEnd++;
+                    }
+                    while (j < starts.size() && starts[j].first < cell)
+                    {
+                        j++;
+                    }
+                    size_t startsEnd = j;
+                    while (startsEnd < starts.size() && starts[startsEnd].first == cell)
+                    {
+                        startsEnd++;
+                    }
+                    CloseCell(cell, ends.data() + i, ends.data() + endsEnd, starts.data() + j, starts.data() + startsEnd);
+                    i = endsEnd;
+                    j = startsEnd;
+                }
+
+                diagram.cells.assign(inputCount, -1);
+                if (diagram.origins.empty())
+                {
+                    AddBox();
+                }
+                for (int h = 0; h < int(diagram.sites.size()); h++)
+                {
+                    int& site = diagram.sites[h];
+                    if (site != -1)
+                    {
+                        site = order[site];
+                        diagram.cells[site] = h;
+                    }
+                }
+                return std::move(diagram);
+            }
+
+        private:
+            static bool IsZeroLength(const Edge& edge)
+            {
+                return edge.vertices[0] != -1 && edge.vertices[0] == edge.vertices[1];
+            }
+
+            bool IsInside(Point P) const
+            {
+                return P.x >= min.x && P.x <= max.x && P.y >= min.y && P.y <= max.y;
+            }
+
+            // Liang-Barsky: O + t D for t in [t0, t1] cut to the box, side0 and side1 are the
+            // sides of the box 0 bottom, 1 right, 2 top, 3 left an end was cut at
+            bool Clip(Point O, Point D, double& t0, double& t1, int& side0, int& side1) const
+            {
+                double p[4] = { -D.y, D.x, D.y, -D.x };
+                double q[4] = { O.y - min.y, max.x - O.x, max.y - O.y, O.x - min.x };
+                for (int i = 0; i < 4; i++)
+                {
+                    if (p[i] == 0.0)
+                    {
+                        if (q[i] < 0.0)
+                        {
+                            return false;
+                        }
+                        continue;
+                    }
+                    double t = q[i] / p[i];
+                    if (p[i] < 0.0 && t > t0)
+                    {
+                        t0 = t;
+                        side0 = i;
+                    }
+                    else if (p[i] > 0.0 && t < t1)
+                    {
+                        t1 = t;
+                        side1 = i;
+                    }
+                }
+                return t0 < t1;
+            }
+
+            // Exactly on the side, so that its position along the boundary is exact too
+            Point Snap(Point P, int side) const
+            {
+                P.x = std::min(std::max(P.x, min.x), max.x);
+                P.y = std::min(std::max(P.y, min.y), max.y);
+                switch (side)
+                {
+                case 0: P.y = min.y; break;
+                case 1: P.x = max.x; break;
+                case 2: P.y = max.y; break;
+                default: P.x = min.x; break;
+                }
+                return P;
+            }
+
+            // Counter-clockwise along the boundary from the lower left corner
+            double GetPosition(Point P) const
+            {
+                if (P.y == min.y && P.x < max.x)
+                {
+                    return P.x - min.x;
+                }
+                if (P.x == max.x && P.y < max.y)
+                {
+                    return width + (P.y - min.y);
+                }
+                if (P.y == max.y && P.x > min.x)
+                {
+                    return width + height + (max.x - P.x);
+                }
+                return 2.0 * width + height + (max.y - P.y);
+            }
+
+            int AddVertex(Point P)
+            {
+                diagram.vertices.push_back(P);
+                return int(diagram.vertices.size()) - 1;
+            }
+
+            int GetCorner(int corner)
+            {
+                if (corners[corner] == -1)
+                {
+                    Point P[4] = { min, Point(max.x, min.y), max, Point(min.x, max.y) };
+                    corners[corner] = AddVertex(P[corner]);
+                }
+                return corners[corner];
+            }
+
+            int AddEdge(int from, int to, int left, int right)
+            {
+                diagram.origins.push_back(from);
+                diagram.origins.push_back(to);
+                diagram.sites.push_back(left);
+                diagram.sites.push_back(right);
+                diagram.nexts.push_back(-1);
+                diagram.nexts.push_back(-1);
+                return int(diagram.origins.size()) - 2;
+            }
+
+            // Every half-edge of the cell ending on the boundary goes counter-clockwise along
+            // it, past the corners, to the nearest one starting on it
+            void CloseCell(int cell, const std::pair<int, int>* endsBegin, const std::pair<int, int>* endsEnd,
+                const std::pair<int, int>* startsBegin, const std::pair<int, int>* startsEnd)
+            {
+                double perimeter = 2.0 * (width + height);
+                double cornerPositions[4] = { 0.0, width, width + height, 2.0 * width + height };
+                isLinked.assign(startsEnd - startsBegin, 0);
+                for (const std::pair<int, int>* end = endsBegin; end != endsEnd; ++end)
+                {
+                    int e = end->second;
+                    double from = GetPosition(diagram.vertices[diagram.origins[e ^ 1]]);
+                    int next = -1;
+                    double span = 0.0;
+                    for (int i = 0; i < int(isLinked.size()); i++)
+                    {
+                        if (!isLinked[i])
+                        {
+                            double distance = GetPosition(diagram.vertices[diagram.origins[startsBegin[i].second]]) - from;
+                            distance += distance < 0.0 ? perimeter : 0.0;
+                            if (next == -1 || distance < span)
+                            {
+                                next = i;
+                                span = distance;
+                            }
+                        }
+                    }
+                    if (next == -1)
+                    {
+                        continue;
+                    }
+                    isLinked[next] = 1;
+
+                    std::pair<double, int> passed[4];
+                    int passedCount = 0;
+                    for (int corner = 0; corner < 4; corner++)
+                    {
+                        double distance = cornerPositions[corner] - from;
+                        distance += distance <= 0.0 ? perimeter : 0.0;
+                        if (distance < span)
+                        {
+                            passed[passedCount++] = { distance, corner };
+                        }
+                    }
+                    std::sort(passed, passed + passedCount);
+
+                    int current = e;
+                    int vertex = diagram.origins[e ^ 1];
+                    for (int i = 0; i < passedCount; i++)
+                    {
+                        int corner = GetCorner(passed[i].second);
+                        int boundary = AddEdge(vertex, corner, cell, -1);
+                        diagram.nexts[current] = boundary;
+                        current = boundary;
+                        vertex = corner;
+                    }
+                    int start = startsBegin[next].second;
+                    int boundary = AddEdge(vertex, diagram.origins[start], cell, -1);
+                    diagram.nexts[current] = boundary;
+                    diagram.nexts[boundary] = start;
+                }
+            }
+
+            // No edge crosses the box, it is all in the cell of the site nearest to its center
+            void AddBox()
+            {
+                Point center = (min + max) / 2.0;
+                int nearest = -1;
+                double distance = 0.0;
+                for (int site = 0; site < int(points.size()); site++)
+                {
+                    double d = vecta::len(points[site] - center);
+                    if (nearest == -1 || d < distance)
+                    {
+                        nearest = site;
+                        distance = d;
+                    }
+                }
+                if (nearest == -1 || !(width > 0.0 && height > 0.0))
+                {
+                    return;
+                }
+                int first = -1;
+                int previous = -1;
+                for (int corner = 0; corner < 4; corner++)
+                {
+                    int e = AddEdge(GetCorner(corner), GetCorner((corner + 1) % 4), nearest, -1);
+                    if (previous == -1)
+                    {
+                        first = e;
+                    }
+                    else
+                    {
+                        diagram.nexts[previous] = e;
+                    }
+                    previous = e;
+                }
+                diagram.nexts[previous] = first;
+            }
+
+            const std::vector<Point>& points;
+            const std::vector<int>& order;
+            Point min;
+            Point max;
+            double width;
+            double height;
+            VoronoiDiagram diagram;
+            int corners[4] = { -1, -1, -1, -1 };
+            std::vector<char> isLinked;
+        };
+    }
+
+    VoronoiDiagram FortuneVoronoi(const std::vector<Point>& sites, Point min, Point max)
+    {
+        GEOMETRY_STAGE(stage, "Voronoi/sort");
+        std::vector<int> order = GetSweepOrder(sites);
+        std::vector<Point> sorted(order.size());
+        for (size_t i = 0; i < order.size(); i++)
+        {
+            sorted[i] = sites[order[i]];
+        }
+        GEOMETRY_NEXT_STAGE(stage, "Voronoi/sweep");
+        FortuneSweep sweep(sorted);
+        sweep.Run();
+        GEOMETRY_NEXT_STAGE(stage, "Voronoi/clip");
+        VoronoiClipper clipper(sorted, order, min, max);
+        return clipper.Build(sweep, int(sites.size()));
+    }
+
+    VoronoiDiagram FortuneVoronoi(const std::vector<Point>& sites)
+    {
+        if (sites.empty())
+        {
+            return VoronoiDiagram();
+        }
+        Point min = sites[0];
+        Point max = sites[0];
+        for (Point P : sites)
+        {
+            min.x = std::min(min.x, P.x);
+            min.y = std::min(min.y, P.y);
+            max.x = std::max(max.x, P.x);
+            max.y = std::max(max.y, P.y);
+        }
+        double margin = std::max(max.x - min.x, max.y - min.y) / 10.0;
+        if (margin == 0.0)
+        {
+            margin = std::max(1.0, std::max(std::abs(min.x), std::abs(min.y)));
+        }
+        return FortuneVoronoi(sites, min - Point(margin, margin), max + Point(margin, margin));
+    }
+}
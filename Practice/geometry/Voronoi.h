@@ -0,0 +1,38 @@
+#ifndef VORONOI_H
+#define VORONOI_H
+
+#include <vector>
+
+#include "Geometry.h"
+
+namespace geometry
+{
+    // Cells of the sites clipped to a box. Half-edges e and e ^ 1 are the two sides of one
+    // edge: e goes from vertices[origins[e]] to vertices[origins[e ^ 1]] with the cell of
+    // sites[e] on its left, nexts[e] is the next half-edge counter-clockwise around that
+    // cell. Along the box the outer side has sites[e] and nexts[e] -1.
+    struct VoronoiDiagram
+    {
+        std::vector<Point> vertices;
+        std::vector<int> origins;
+        std::vector<int> nexts;
+        std::vector<int> sites;
+
+        // A half-edge of the cell of each site, -1 for a duplicate and for a cell outside the box
+        std::vector<int> cells;
+    };
+
+    // Fortune's sweep in y: the beach line is a treap of arcs and the circle events a heap,
+    // both in arrays reused as arcs and events come and go, O(n log n). A circle event is
+    // decided with the exact Orient2D(), and one whose circle is exactly the circle of the
+    // vertex at the other end of an edge (InCircle()) reuses that vertex: cocircular sites
+    // give one vertex instead of zero-length edges. Sites are sorted with RadixSort(), the
+    // first of duplicate sites gets the cell. The breakpoints are of degree four,
+    // coordinates up to about 1e75.
+    VoronoiDiagram FortuneVoronoi(const std::vector<Point>& sites, Point min, Point max);
+
+    // Clipped to the box around the sites grown by a tenth of its size on every side
+    VoronoiDiagram FortuneVoronoi(const std::vector<Point>& sites);
+}
+
+#endif
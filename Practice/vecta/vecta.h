@@ -4,6 +4,7 @@
 #include <cmath>
 #include <utility>
 #include <istream>
+#include <vector>
 
 #ifdef GSQR
 #undef GSQR
@@ -76,7 +77,7 @@ namespace vecta {
         }
     };
 
-    vec2d<> polar(const Number r, const Number a) {
+    inline vec2d<> polar(const Number r, const Number a) {
         return vec2d<>(r * cos(a), r * sin(a));
     }
 
@@ -226,7 +227,7 @@ namespace vecta {
         }
     };
 
-    quatrn operator* (const quatrn& b, const quatrn& a) {
+    inline quatrn operator* (const quatrn& b, const quatrn& a) {
         return quatrn(a.r * b.r - a.x * b.x - a.y * b.y - a.z * b.z,
             a.r * b.x + a.x * b.r + a.y * b.z - a.z * b.y,
             a.r * b.y + a.y * b.r + a.z * b.x - a.x * b.z,
@@ -370,6 +371,57 @@ namespace vecta {
             2 * (bd - ac) * a.x + 2 * (cd + ab) * a.y + (4 * GSQR(q.r) - 2 * p1 - 1) * a.z);
     }
 
+    // The rotation of a unit quaternion as a row-major 3x3 matrix, the one a & q works out
+    // again for every vector. Built once it turns any number of them.
+    class rotation3d {
+    public:
+        Number m[9];
+        explicit rotation3d(const quatrn& q) {
+            Number p1 = (q.r - q.z) * (q.r + q.z), p2 = (q.x - q.y) * (q.x + q.y),
+                ab = q.r * q.x, ac = q.r * q.y, ad = q.r * q.z,
+                bc = q.x * q.y, bd = q.x * q.z, cd = q.y * q.z;
+            m[0] = p1 + p2;          m[1] = 2 * (bc - ad);  m[2] = 2 * (bd + ac);
+            m[3] = 2 * (bc + ad);    m[4] = p1 - p2;        m[5] = 2 * (cd - ab);
+            m[6] = 2 * (bd - ac);    m[7] = 2 * (cd + ab);  m[8] = 4 * GSQR(q.r) - 2 * p1 - 1;
+        }
+        template <typename N>
+        vec3d<N> operator() (const vec3d<N>& a) const {
+            return vec3d<N>(m[0] * a.x + m[1] * a.y + m[2] * a.z,
+                m[3] * a.x + m[4] * a.y + m[5] * a.z,
+                m[6] * a.x + m[7] * a.y + m[8] * a.z);
+        }
+        // Turns (x[i], y[i], z[i]) for i < count in place. A plain loop of multiply-adds over
+        // whole registers of each coordinate; the compiler vectorizes and fuses it.
+        template <typename N>
+        void operator() (N* x, N* y, N* z, std::size_t count) const {
+            const Number m0 = m[0], m1 = m[1], m2 = m[2], m3 = m[3], m4 = m[4], m5 = m[5], m6 = m[6], m7 = m[7], m8 = m[8];
+            for (std::size_t i = 0; i < count; i++) {
+                N xx = x[i], yy = y[i], zz = z[i];
+                x[i] = m0 * xx + m1 * yy + m2 * zz;
+                y[i] = m3 * xx + m4 * yy + m5 * zz;
+                z[i] = m6 * xx + m7 * yy + m8 * zz;
+            }
+        }
+    };
+
+    // Vectors with their coordinates in three arrays, so that a loop over them reads and
+    // writes each coordinate contiguously
+    template <typename N = Number>
+    class vec3d_array {
+    public:
+        std::vector<N> x, y, z;
+        std::size_t size() const { return x.size(); }
+        void resize(std::size_t n) { x.resize(n);  y.resize(n);  z.resize(n); }
+        void push_back(const vec3d<N>& p) { x.push_back(p.x);  y.push_back(p.y);  z.push_back(p.z); }
+        vec3d<N> operator[] (std::size_t i) const { return vec3d<N>(x[i], y[i], z[i]); }
+        void set(std::size_t i, const vec3d<N>& p) { x[i] = p.x;  y[i] = p.y;  z[i] = p.z; }
+        vec3d_array<N>& operator&= (const quatrn& q) {
+            rotation3d rotation(q);
+            rotation(x.data(), y.data(), z.data(), size());
+            return *this;
+        }
+    };
+
     template <typename N1, typename N2>
     vec3d<N1> operator& (const vec3d<N1>& u, const std::pair< N2, vec3d<N2> >& p) {
         return u & quatrn(p.first, p.second);